@@ -0,0 +1,159 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+// Compares the broad phase backends on a synthetic level shaped like ours
+// (long and 20 tiles high): static blocks on the ground and on platforms,
+// plus dynamic actors walking around. Reports insert, move and query times
+// and how many candidates the collision queries return.
+//
+// Usage:
+//   broadphase-bench [--width TILES] [--movers N] [--frames N]
+//
+
+#define SDL_MAIN_HANDLED
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../Source/Game.h"
+#include "../Source/BroadPhase.h"
+#include "../Source/Actors/Actor.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct BenchResult
+{
+    double insertMs;
+    double moveMs;
+    double queryMs;
+    double cameraMs;
+    long long candidates;
+};
+
+static BenchResult Run(BroadPhaseType type, int widthInTiles, int numMovers, int numFrames)
+{
+    const int tile = Game::TILE_SIZE;
+    const int height = Game::LEVEL_HEIGHT;
+
+    Game game(960, 640);
+    game.SetBroadPhaseType(type);
+    game.ResetBroadPhase(widthInTiles * tile, height * tile);
+
+    // Same level for every backend
+    std::mt19937 rng(1234);
+    std::vector<Vector2> blockPositions;
+    for (int x = 0; x < widthInTiles; ++x)
+    {
+        blockPositions.emplace_back(x * tile, (height - 1) * tile);
+        blockPositions.emplace_back(x * tile, (height - 2) * tile);
+
+        if (rng() % 4 == 0) {
+            blockPositions.emplace_back(x * tile, (height - 4 - rng() % 10) * tile);
+        }
+    }
+
+    std::vector<Vector2> moverPositions;
+    std::vector<float> moverSpeeds;
+    for (int i = 0; i < numMovers; ++i)
+    {
+        moverPositions.emplace_back(static_cast<float>(rng() % (widthInTiles * tile)),
+                                    static_cast<float>((height - 3 - rng() % 12) * tile));
+        moverSpeeds.push_back(rng() % 2 == 0 ? -2.0f : 2.0f);
+    }
+
+    BenchResult result = {};
+
+    auto start = Clock::now();
+    std::vector<Actor*> movers;
+    for (const auto& position : blockPositions)
+    {
+        auto block = new Actor(&game);
+        block->SetPosition(position);
+    }
+    for (const auto& position : moverPositions)
+    {
+        auto mover = new Actor(&game);
+        mover->SetPosition(position);
+        movers.push_back(mover);
+    }
+    result.insertMs = ElapsedMs(start);
+
+    BroadPhase* broadPhase = game.GetBroadPhase();
+    Vector2 camera(0.0f, 0.0f);
+
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        start = Clock::now();
+        for (size_t i = 0; i < movers.size(); ++i)
+        {
+            Vector2 position = movers[i]->GetPosition();
+            position.x += moverSpeeds[i];
+            if (position.x < 0.0f || position.x >= (widthInTiles - 1) * tile) {
+                moverSpeeds[i] = -moverSpeeds[i];
+                position.x += 2.0f * moverSpeeds[i];
+            }
+            movers[i]->SetPosition(position);
+        }
+        result.moveMs += ElapsedMs(start);
+
+        // What each body sees through GetNearbyColliders
+        start = Clock::now();
+        for (auto mover : movers) {
+            result.candidates += static_cast<long long>(broadPhase->Query(mover->GetPosition(), 2).size());
+        }
+        result.queryMs += ElapsedMs(start);
+
+        start = Clock::now();
+        camera.x = static_cast<float>((frame * 8) % (widthInTiles * tile));
+        broadPhase->QueryOnCamera(camera, 960.0f, 640.0f);
+        result.cameraMs += ElapsedMs(start);
+    }
+
+    // Deletes every actor
+    game.ResetBroadPhase(tile, tile);
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    int widthInTiles = Game::LEVEL_WIDTH;
+    int numMovers = 200;
+    int numFrames = 600;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--width" && i + 1 < argc) {
+            widthInTiles = std::stoi(argv[++i]);
+        } else if (arg == "--movers" && i + 1 < argc) {
+            numMovers = std::stoi(argv[++i]);
+        } else if (arg == "--frames" && i + 1 < argc) {
+            numFrames = std::stoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Unknown argument %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    std::printf("Level %d x %d tiles, %d movers, %d frames\n", widthInTiles, Game::LEVEL_HEIGHT, numMovers, numFrames);
+    std::printf("%-6s %10s %14s %14s %14s %16s\n", "", "insert ms", "move ms/frame", "query ms/frame", "camera us/frame", "candidates/body");
+
+    for (auto type : {BroadPhaseType::Grid, BroadPhaseType::SweepAndPrune, BroadPhaseType::AABBTree})
+    {
+        BenchResult result = Run(type, widthInTiles, numMovers, numFrames);
+        std::printf("%-6s %10.3f %14.4f %14.4f %14.2f %16.1f\n", BroadPhase::GetTypeName(type),
+                    result.insertMs,
+                    result.moveMs / numFrames,
+                    result.queryMs / numFrames,
+                    result.cameraMs * 1000.0 / numFrames,
+                    static_cast<double>(result.candidates) / (static_cast<double>(numFrames) * numMovers));
+    }
+
+    return 0;
+}
@@ -0,0 +1,808 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+// Micro-benchmarks for the engine primitives the game leans on every frame:
+// math, the spatial hash, CSV level parsing, AABB tests and resolution,
+// GetComponent, Random and sprite sheet JSON parsing. No window is created.
+//
+// Each benchmark runs batches of growing size until one takes at least the
+// minimum time, and reports the time per operation of that batch. --json
+// writes the results in the same layout as Google Benchmark's JSON output,
+// so runs from different commits can be compared with its tools.
+//
+// Before benchmarking, the SIMD math kernels are checked against the scalar
+// versions on random inputs; the run fails if any of them disagree.
+//
+// Usage (from the build directory, like the game):
+//   engine-bench [--filter TEXT] [--min-time MS] [--json FILE] [--check-only]
+//
+
+#define SDL_MAIN_HANDLED
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../Source/Game.h"
+#include "../Source/CSV.h"
+#include "../Source/Json.h"
+#include "../Source/Math.h"
+#include "../Source/Random.h"
+#include "../Source/SpatialHashing.h"
+#include "../Source/Actors/Actor.h"
+#include "../Source/Components/RigidBodyComponent.h"
+#include "../Source/Components/ColliderComponents/AABBColliderComponent.h"
+#include "../Source/Components/DrawComponents/DrawPolygonComponent.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Results are written here so the compiler can't drop the benchmarked work
+static volatile float sSink;
+
+static void Consume(float value)
+{
+    sSink = value;
+}
+
+struct BenchResult
+{
+    std::string name;
+    long long iterations;
+    double nsPerOp;
+};
+
+// A benchmark runs its operation n times; setup happens outside of it
+struct Benchmark
+{
+    std::string name;
+    std::function<void(long long)> run;
+};
+
+static BenchResult Measure(const Benchmark& benchmark, double minTimeMs)
+{
+    long long iterations = 1;
+    while (true)
+    {
+        auto start = Clock::now();
+        benchmark.run(iterations);
+        double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        if (elapsedMs >= minTimeMs || iterations >= (1LL << 40)) {
+            return {benchmark.name, iterations, elapsedMs * 1000000.0 / static_cast<double>(iterations)};
+        }
+
+        // Aim a bit past the minimum time, growing at most 10x per batch
+        double scale = elapsedMs > 0.0 ? (minTimeMs * 1.4) / elapsedMs : 10.0;
+        scale = scale > 10.0 ? 10.0 : (scale < 2.0 ? 2.0 : scale);
+        iterations = static_cast<long long>(static_cast<double>(iterations) * scale);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Math
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+// SIMD kernel checks
+// ---------------------------------------------------------------------------
+
+static const char* GetMathKernelName()
+{
+#if defined(MATH_SIMD_AVX2)
+    return "AVX2";
+#elif defined(MATH_SIMD)
+    return "SSE";
+#else
+    return "scalar";
+#endif
+}
+
+struct KernelCheck
+{
+    const char* name;
+    float maxError = 0.0f;
+    int failures = 0;
+
+    // Relative to the magnitude of the expected value
+    void Compare(float expected, float actual, float tolerance)
+    {
+        float error = std::fabs(expected - actual) / std::max(1.0f, std::fabs(expected));
+        maxError = std::max(maxError, error);
+        if (!(error <= tolerance)) {
+            failures++;
+        }
+    }
+};
+
+static Matrix3 RandomMatrix3(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    Matrix3 m;
+    for (auto& row : m.mat) {
+        for (auto& value : row) {
+            value = dist(rng);
+        }
+    }
+    return m;
+}
+
+static Matrix4 RandomMatrix4(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    Matrix4 m;
+    for (auto& row : m.mat) {
+        for (auto& value : row) {
+            value = dist(rng);
+        }
+    }
+    return m;
+}
+
+// Returns false if a SIMD kernel doesn't match the scalar code
+static bool CheckMathKernels()
+{
+    const int numCases = 10000;
+    const float tolerance = 1e-5f;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+
+    KernelCheck mul3{"Matrix3 multiply"};
+    KernelCheck mul4{"Matrix4 multiply"};
+    KernelCheck invert{"Matrix4 invert"};
+    KernelCheck transform2{"Vector2 transform"};
+    KernelCheck transform3{"Vector3 transform"};
+    KernelCheck batch2{"Vector2 batch transform"};
+    KernelCheck batch3{"Vector3 batch transform"};
+
+    for (int i = 0; i < numCases; ++i)
+    {
+        Matrix3 a3 = RandomMatrix3(rng), b3 = RandomMatrix3(rng);
+        Matrix3 simd3 = a3 * b3, scalar3 = Matrix3::MultiplyScalar(a3, b3);
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                mul3.Compare(scalar3.mat[r][c], simd3.mat[r][c], tolerance);
+            }
+        }
+
+        Matrix4 a4 = RandomMatrix4(rng), b4 = RandomMatrix4(rng);
+        Matrix4 simd4 = a4 * b4, scalar4 = Matrix4::MultiplyScalar(a4, b4);
+        for (int r = 0; r < 4; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                mul4.Compare(scalar4.mat[r][c], simd4.mat[r][c], tolerance);
+            }
+        }
+
+        // Keep the matrix well conditioned so the comparison is meaningful
+        Matrix4 m = RandomMatrix4(rng);
+        for (int d = 0; d < 4; ++d) {
+            m.mat[d][d] += 50.0f;
+        }
+        Matrix4 simdInverse = m, scalarInverse = m;
+        simdInverse.Invert();
+        scalarInverse.InvertScalar();
+        for (int r = 0; r < 4; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                invert.Compare(scalarInverse.mat[r][c], simdInverse.mat[r][c], tolerance);
+            }
+        }
+
+        Vector2 v2(dist(rng), dist(rng));
+        float w = i % 2 == 0 ? 1.0f : 0.0f;
+        Vector2 simd2 = Vector2::Transform(v2, a3, w), scalar2 = Vector2::TransformScalar(v2, a3, w);
+        transform2.Compare(scalar2.x, simd2.x, tolerance);
+        transform2.Compare(scalar2.y, simd2.y, tolerance);
+
+        Vector3 v3(dist(rng), dist(rng), dist(rng));
+        Vector3 simd3v = Vector3::Transform(v3, a4, w), scalar3v = Vector3::TransformScalar(v3, a4, w);
+        transform3.Compare(scalar3v.x, simd3v.x, tolerance);
+        transform3.Compare(scalar3v.y, simd3v.y, tolerance);
+        transform3.Compare(scalar3v.z, simd3v.z, tolerance);
+    }
+
+    // Batches of every length up to a few registers wide, out of place and in place
+    for (size_t count = 0; count < 19; ++count)
+    {
+        for (bool inPlace : {false, true})
+        {
+            Matrix3 m3 = RandomMatrix3(rng);
+            Matrix4 m4 = RandomMatrix4(rng);
+
+            std::vector<Vector2> in2(count), out2(count);
+            std::vector<Vector3> in3(count), out3(count);
+            for (size_t i = 0; i < count; ++i) {
+                in2[i] = Vector2(dist(rng), dist(rng));
+                in3[i] = Vector3(dist(rng), dist(rng), dist(rng));
+            }
+
+            std::vector<Vector2> expected2(count);
+            std::vector<Vector3> expected3(count);
+            for (size_t i = 0; i < count; ++i) {
+                expected2[i] = Vector2::TransformScalar(in2[i], m3);
+                expected3[i] = Vector3::TransformScalar(in3[i], m4);
+            }
+
+            if (inPlace) {
+                Vector2::TransformBatch(in2.data(), in2.data(), count, m3);
+                Vector3::TransformBatch(in3.data(), in3.data(), count, m4);
+                out2 = in2;
+                out3 = in3;
+            } else {
+                Vector2::TransformBatch(in2.data(), out2.data(), count, m3);
+                Vector3::TransformBatch(in3.data(), out3.data(), count, m4);
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                batch2.Compare(expected2[i].x, out2[i].x, tolerance);
+                batch2.Compare(expected2[i].y, out2[i].y, tolerance);
+                batch3.Compare(expected3[i].x, out3[i].x, tolerance);
+                batch3.Compare(expected3[i].y, out3[i].y, tolerance);
+                batch3.Compare(expected3[i].z, out3[i].z, tolerance);
+            }
+        }
+    }
+
+    bool passed = true;
+    std::printf("Math kernels: %s\n", GetMathKernelName());
+    for (const auto& check : {mul3, mul4, invert, transform2, transform3, batch2, batch3})
+    {
+        std::printf("  %-24s max rel. error %.2e %s\n", check.name, check.maxError,
+                    check.failures == 0 ? "ok" : "MISMATCH");
+        passed = passed && check.failures == 0;
+    }
+    std::printf("\n");
+
+    return passed;
+}
+
+static void AddMathBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    benchmarks.push_back({"Vector2/AddScale", [](long long n) {
+        Vector2 a(1.0f, 2.0f);
+        const Vector2 b(0.5f, -0.25f);
+        for (long long i = 0; i < n; ++i) {
+            a = a + b * 0.999f;
+        }
+        Consume(a.x + a.y);
+    }});
+
+    benchmarks.push_back({"Vector2/Normalize", [](long long n) {
+        Vector2 v(3.0f, 4.0f);
+        float sum = 0.0f;
+        for (long long i = 0; i < n; ++i) {
+            v.x += 0.001f;
+            sum += Vector2::Normalize(v).x;
+        }
+        Consume(sum);
+    }});
+
+    benchmarks.push_back({"Vector2/Dot", [](long long n) {
+        Vector2 a(1.0f, 2.0f);
+        const Vector2 b(0.5f, -0.25f);
+        float sum = 0.0f;
+        for (long long i = 0; i < n; ++i) {
+            a.y += 0.001f;
+            sum += Vector2::Dot(a, b);
+        }
+        Consume(sum);
+    }});
+
+    benchmarks.push_back({"Matrix3/Multiply", [](long long n) {
+        Matrix3 m = Matrix3::Identity;
+        const Matrix3 step = Matrix3::CreateScale(1.0001f) * Matrix3::CreateRotation(0.01f) *
+                             Matrix3::CreateTranslation(Vector2(1.0f, 2.0f));
+        for (long long i = 0; i < n; ++i) {
+            m = m * step;
+        }
+        Consume(m.mat[2][0]);
+    }});
+
+    benchmarks.push_back({"Matrix4/Multiply", [](long long n) {
+        Matrix4 m = Matrix4::Identity;
+        const Matrix4 step = Matrix4::CreateScale(1.0001f) * Matrix4::CreateRotationZ(0.01f) *
+                             Matrix4::CreateTranslation(Vector3(1.0f, 2.0f, 3.0f));
+        for (long long i = 0; i < n; ++i) {
+            m = m * step;
+        }
+        Consume(m.mat[3][0]);
+    }});
+
+    benchmarks.push_back({"Matrix3/MultiplyScalar", [](long long n) {
+        Matrix3 m = Matrix3::Identity;
+        const Matrix3 step = Matrix3::CreateScale(1.0001f) * Matrix3::CreateRotation(0.01f) *
+                             Matrix3::CreateTranslation(Vector2(1.0f, 2.0f));
+        for (long long i = 0; i < n; ++i) {
+            m = Matrix3::MultiplyScalar(m, step);
+        }
+        Consume(m.mat[2][0]);
+    }});
+
+    benchmarks.push_back({"Matrix4/MultiplyScalar", [](long long n) {
+        Matrix4 m = Matrix4::Identity;
+        const Matrix4 step = Matrix4::CreateScale(1.0001f) * Matrix4::CreateRotationZ(0.01f) *
+                             Matrix4::CreateTranslation(Vector3(1.0f, 2.0f, 3.0f));
+        for (long long i = 0; i < n; ++i) {
+            m = Matrix4::MultiplyScalar(m, step);
+        }
+        Consume(m.mat[3][0]);
+    }});
+
+    benchmarks.push_back({"Matrix4/Invert", [](long long n) {
+        Matrix4 m = Matrix4::CreateRotationZ(0.5f) * Matrix4::CreateTranslation(Vector3(10.0f, 20.0f, 0.0f));
+        for (long long i = 0; i < n; ++i) {
+            m.Invert();
+        }
+        Consume(m.mat[3][0]);
+    }});
+
+    benchmarks.push_back({"Matrix4/InvertScalar", [](long long n) {
+        Matrix4 m = Matrix4::CreateRotationZ(0.5f) * Matrix4::CreateTranslation(Vector3(10.0f, 20.0f, 0.0f));
+        for (long long i = 0; i < n; ++i) {
+            m.InvertScalar();
+        }
+        Consume(m.mat[3][0]);
+    }});
+
+    benchmarks.push_back({"Vector2/TransformMatrix3", [](long long n) {
+        const Matrix3 m = Matrix3::CreateRotation(0.5f) * Matrix3::CreateTranslation(Vector2(10.0f, 20.0f));
+        Vector2 v(1.0f, 1.0f);
+        float sum = 0.0f;
+        for (long long i = 0; i < n; ++i) {
+            v.x += 0.001f;
+            sum += Vector2::Transform(v, m).y;
+        }
+        Consume(sum);
+    }});
+
+    benchmarks.push_back({"Vector3/TransformMatrix4", [](long long n) {
+        const Matrix4 m = Matrix4::CreateRotationZ(0.5f) * Matrix4::CreateTranslation(Vector3(10.0f, 20.0f, 0.0f));
+        Vector3 v(1.0f, 1.0f, 0.0f);
+        float sum = 0.0f;
+        for (long long i = 0; i < n; ++i) {
+            v.x += 0.001f;
+            sum += Vector3::Transform(v, m).y;
+        }
+        Consume(sum);
+    }});
+
+    benchmarks.push_back({"Vector3/TransformMatrix4Scalar", [](long long n) {
+        const Matrix4 m = Matrix4::CreateRotationZ(0.5f) * Matrix4::CreateTranslation(Vector3(10.0f, 20.0f, 0.0f));
+        Vector3 v(1.0f, 1.0f, 0.0f);
+        float sum = 0.0f;
+        for (long long i = 0; i < n; ++i) {
+            v.x += 0.001f;
+            sum += Vector3::TransformScalar(v, m).y;
+        }
+        Consume(sum);
+    }});
+
+    // Per vector, over batches the size of a busy scene's sprites
+    const size_t batchSize = 1024;
+
+    benchmarks.push_back({"Vector2/TransformBatch", [batchSize](long long n) {
+        const Matrix3 m = Matrix3::CreateRotation(0.5f) * Matrix3::CreateTranslation(Vector2(10.0f, 20.0f));
+        std::vector<Vector2> in(batchSize, Vector2(1.0f, 2.0f)), out(batchSize);
+        for (long long done = 0; done < n; done += batchSize) {
+            Vector2::TransformBatch(in.data(), out.data(), std::min<size_t>(batchSize, n - done), m);
+        }
+        Consume(out[0].x);
+    }});
+
+    benchmarks.push_back({"Vector2/TransformLoopScalar", [batchSize](long long n) {
+        const Matrix3 m = Matrix3::CreateRotation(0.5f) * Matrix3::CreateTranslation(Vector2(10.0f, 20.0f));
+        std::vector<Vector2> in(batchSize, Vector2(1.0f, 2.0f)), out(batchSize);
+        for (long long done = 0; done < n; done += batchSize)
+        {
+            size_t count = std::min<size_t>(batchSize, n - done);
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = Vector2::TransformScalar(in[i], m);
+            }
+        }
+        Consume(out[0].x);
+    }});
+
+    benchmarks.push_back({"Vector3/TransformBatch", [batchSize](long long n) {
+        const Matrix4 m = Matrix4::CreateRotationZ(0.5f) * Matrix4::CreateTranslation(Vector3(10.0f, 20.0f, 0.0f));
+        std::vector<Vector3> in(batchSize, Vector3(1.0f, 2.0f, 3.0f)), out(batchSize);
+        for (long long done = 0; done < n; done += batchSize) {
+            Vector3::TransformBatch(in.data(), out.data(), std::min<size_t>(batchSize, n - done), m);
+        }
+        Consume(out[0].x);
+    }});
+
+    benchmarks.push_back({"Vector3/TransformLoopScalar", [batchSize](long long n) {
+        const Matrix4 m = Matrix4::CreateRotationZ(0.5f) * Matrix4::CreateTranslation(Vector3(10.0f, 20.0f, 0.0f));
+        std::vector<Vector3> in(batchSize, Vector3(1.0f, 2.0f, 3.0f)), out(batchSize);
+        for (long long done = 0; done < n; done += batchSize)
+        {
+            size_t count = std::min<size_t>(batchSize, n - done);
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = Vector3::TransformScalar(in[i], m);
+            }
+        }
+        Consume(out[0].x);
+    }});
+}
+
+// ---------------------------------------------------------------------------
+// Spatial hashing, colliders and components
+// ---------------------------------------------------------------------------
+
+// Actors spread over a level-sized area, owned by the game's broad phase
+struct ActorField
+{
+    static const int NUM_ACTORS = 2048;
+
+    Game game;
+    std::vector<Actor*> actors;
+
+    ActorField()
+        : game(960, 640)
+    {
+        const int tile = Game::TILE_SIZE;
+        game.ResetBroadPhase(Game::LEVEL_WIDTH * tile, Game::LEVEL_HEIGHT * tile);
+
+        Random::Seed(1234);
+        for (int i = 0; i < NUM_ACTORS; ++i)
+        {
+            auto actor = new Actor(&game);
+            actor->SetPosition(Vector2(Random::GetFloatRange(0.0f, (Game::LEVEL_WIDTH - 1) * tile),
+                                       Random::GetFloatRange(0.0f, (Game::LEVEL_HEIGHT - 1) * tile)));
+            actors.push_back(actor);
+        }
+    }
+
+    ~ActorField()
+    {
+        // Deletes every actor
+        game.ResetBroadPhase(Game::TILE_SIZE, Game::TILE_SIZE);
+    }
+};
+
+// The game's broad phase owns the actors, so the benchmarked hash has to let
+// go of them before it is destroyed
+static void ClearHash(SpatialHashing& hash, const std::vector<Actor*>& actors)
+{
+    for (auto actor : actors) {
+        hash.Remove(actor);
+    }
+}
+
+static void AddSpatialHashBenchmarks(std::vector<Benchmark>& benchmarks, ActorField& field)
+{
+    const int tile = Game::TILE_SIZE;
+    const int width = Game::LEVEL_WIDTH * tile;
+    const int height = Game::LEVEL_HEIGHT * tile;
+
+    benchmarks.push_back({"SpatialHashing/InsertRemove", [&field, tile, width, height](long long n) {
+        SpatialHashing hash(tile * 4, width, height);
+        long long done = 0;
+        while (done < n)
+        {
+            for (auto actor : field.actors)
+            {
+                if (done++ == n) break;
+                hash.Insert(actor);
+            }
+            ClearHash(hash, field.actors);
+        }
+    }});
+
+    benchmarks.push_back({"SpatialHashing/Reinsert", [&field, tile, width, height](long long n) {
+        SpatialHashing hash(tile * 4, width, height);
+        for (auto actor : field.actors) {
+            hash.Insert(actor);
+        }
+
+        for (long long i = 0; i < n; ++i) {
+            hash.Reinsert(field.actors[i % field.actors.size()]);
+        }
+        ClearHash(hash, field.actors);
+    }});
+
+    benchmarks.push_back({"SpatialHashing/Query", [&field, tile, width, height](long long n) {
+        SpatialHashing hash(tile * 4, width, height);
+        for (auto actor : field.actors) {
+            hash.Insert(actor);
+        }
+
+        size_t found = 0;
+        for (long long i = 0; i < n; ++i) {
+            found += hash.Query(field.actors[i % field.actors.size()]->GetPosition(), 2).size();
+        }
+        Consume(static_cast<float>(found));
+        ClearHash(hash, field.actors);
+    }});
+
+    benchmarks.push_back({"SpatialHashing/QueryOnCamera", [&field, tile, width, height](long long n) {
+        SpatialHashing hash(tile * 4, width, height);
+        for (auto actor : field.actors) {
+            hash.Insert(actor);
+        }
+
+        size_t found = 0;
+        for (long long i = 0; i < n; ++i)
+        {
+            Vector2 camera(static_cast<float>((i * 8) % (width - 960)), 0.0f);
+            found += hash.QueryOnCamera(camera, 960.0f, 640.0f).size();
+        }
+        Consume(static_cast<float>(found));
+        ClearHash(hash, field.actors);
+    }});
+
+    benchmarks.push_back({"Actor/GetComponent", [&field](long long n) {
+        // Look up the last of a few components, the worst case for the linear search
+        Actor* actor = field.actors[0];
+        if (!actor->GetComponent<DrawPolygonComponent>())
+        {
+            std::vector<Vector2> vertices = {Vector2::Zero, Vector2::UnitX, Vector2::UnitY};
+            new RigidBodyComponent(actor);
+            new DrawPolygonComponent(actor, vertices);
+        }
+
+        size_t found = 0;
+        for (long long i = 0; i < n; ++i) {
+            found += actor->GetComponent<DrawPolygonComponent>() != nullptr;
+        }
+        Consume(static_cast<float>(found));
+    }});
+}
+
+static void AddColliderBenchmarks(std::vector<Benchmark>& benchmarks, ActorField& field)
+{
+    const int tile = Game::TILE_SIZE;
+
+    // A body resting on a row of blocks
+    auto body = new Actor(&field.game);
+    body->SetPosition(Vector2(tile * 10.0f, tile * 10.0f - 2.0f));
+    auto rigidBody = new RigidBodyComponent(body, 1.0f, 0.0f, false);
+    auto bodyCollider = new AABBColliderComponent(body, 0, 0, tile - 4, tile, ColliderLayer::Enemy);
+
+    std::vector<AABBColliderComponent*> blocks;
+    for (int i = 8; i < 13; ++i)
+    {
+        auto block = new Actor(&field.game);
+        block->SetPosition(Vector2(tile * static_cast<float>(i), tile * 11.0f));
+        blocks.push_back(new AABBColliderComponent(block, 0, 0, tile, tile, ColliderLayer::Blocks, true));
+    }
+
+    benchmarks.push_back({"AABBCollider/Intersect", [bodyCollider, blocks](long long n) {
+        size_t hits = 0;
+        for (long long i = 0; i < n; ++i) {
+            hits += bodyCollider->Intersect(*blocks[i % blocks.size()]);
+        }
+        Consume(static_cast<float>(hits));
+    }});
+
+    benchmarks.push_back({"AABBCollider/ResolveContacts", [body, rigidBody, bodyCollider, blocks, tile](long long n) {
+        float overlap = 0.0f;
+        std::vector<CollisionEvent> events;
+        for (long long i = 0; i < n; ++i)
+        {
+            // Sink into the blocks and get pushed back out
+            body->SetPosition(Vector2(tile * 10.0f, tile * 10.0f + 4.0f));
+            overlap += bodyCollider->ResolveContacts(blocks, rigidBody, false, events);
+            events.clear();
+        }
+        Consume(overlap);
+    }});
+}
+
+// ---------------------------------------------------------------------------
+// Parsing and random numbers
+// ---------------------------------------------------------------------------
+
+static std::string ReadFile(const std::string& path)
+{
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+static void AddParsingBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    // A full row of a level file
+    std::string row;
+    for (int i = 0; i < Game::LEVEL_WIDTH; ++i) {
+        row += (i > 0 ? "," : "") + std::to_string(i % 3 == 0 ? -1 : i % 20);
+    }
+
+    benchmarks.push_back({"CSVHelper/SplitRow", [row](long long n) {
+        size_t total = 0;
+        for (long long i = 0; i < n; ++i) {
+            total += CSVHelper::Split(row).size();
+        }
+        Consume(static_cast<float>(total));
+    }});
+
+    std::string spriteSheet = ReadFile("../Assets/Sprites/Mouse/Mouse.json");
+    if (spriteSheet.empty()) {
+        std::fprintf(stderr, "Sprite sheet data not found, run from the build directory\n");
+        return;
+    }
+
+    // Same parse as Game::GetSpriteSheetFrames, without the cache
+    benchmarks.push_back({"Json/SpriteSheetFrames", [spriteSheet](long long n) {
+        size_t total = 0;
+        for (long long i = 0; i < n; ++i)
+        {
+            std::vector<SDL_Rect> frames;
+            nlohmann::json data = nlohmann::json::parse(spriteSheet, nullptr, false);
+            for (const auto& frame : data["frames"]) {
+                frames.push_back({frame["frame"]["x"].get<int>(), frame["frame"]["y"].get<int>(),
+                                  frame["frame"]["w"].get<int>(), frame["frame"]["h"].get<int>()});
+            }
+            total += frames.size();
+        }
+        Consume(static_cast<float>(total));
+    }});
+}
+
+static void AddRandomBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    benchmarks.push_back({"Random/GetFloat", [](long long n) {
+        float sum = 0.0f;
+        for (long long i = 0; i < n; ++i) {
+            sum += Random::GetFloat();
+        }
+        Consume(sum);
+    }});
+
+    benchmarks.push_back({"Random/GetIntRange", [](long long n) {
+        int sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += Random::GetIntRange(0, 100);
+        }
+        Consume(static_cast<float>(sum));
+    }});
+
+    benchmarks.push_back({"Random/GetVector", [](long long n) {
+        const Vector2 min(0.0f, 0.0f);
+        const Vector2 max(100.0f, 100.0f);
+        float sum = 0.0f;
+        for (long long i = 0; i < n; ++i) {
+            sum += Random::GetVector(min, max).x;
+        }
+        Consume(sum);
+    }});
+
+    benchmarks.push_back({"RandomStream/GetFloat", [](long long n) {
+        RandomStream stream(1234);
+        float sum = 0.0f;
+        for (long long i = 0; i < n; ++i) {
+            sum += stream.GetFloat();
+        }
+        Consume(sum);
+    }});
+
+    benchmarks.push_back({"RandomStream/GetIntRange", [](long long n) {
+        RandomStream stream(1234);
+        int sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += stream.GetIntRange(0, 100);
+        }
+        Consume(static_cast<float>(sum));
+    }});
+
+    // Per value, in batches of 256
+    benchmarks.push_back({"RandomStream/FillFloatRange", [](long long n) {
+        RandomStream stream(1234);
+        float values[256];
+        float sum = 0.0f;
+        for (long long i = 0; i < n; i += 256) {
+            stream.FillFloatRange(values, 256, -1.0f, 1.0f);
+            sum += values[i & 255];
+        }
+        Consume(sum);
+    }});
+}
+
+static bool WriteJson(const std::string& path, const std::vector<BenchResult>& results, double minTimeMs)
+{
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::fprintf(stderr, "Failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    nlohmann::json output;
+    output["context"] = {
+        {"date", date},
+        {"executable", "engine-bench"},
+        {"min_time_ms", minTimeMs},
+#ifdef NDEBUG
+        {"library_build_type", "release"}
+#else
+        {"library_build_type", "debug"}
+#endif
+    };
+
+    output["benchmarks"] = nlohmann::json::array();
+    for (const auto& result : results)
+    {
+        output["benchmarks"].push_back({
+            {"name", result.name},
+            {"run_type", "iteration"},
+            {"iterations", result.iterations},
+            {"real_time", result.nsPerOp},
+            {"cpu_time", result.nsPerOp},
+            {"time_unit", "ns"}
+        });
+    }
+
+    file << output.dump(2) << '\n';
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string jsonPath;
+    double minTimeMs = 200.0;
+    bool checkOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            minTimeMs = std::stod(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--check-only") {
+            checkOnly = true;
+        } else {
+            std::fprintf(stderr, "Unknown argument %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    if (!CheckMathKernels()) {
+        std::fprintf(stderr, "SIMD math kernels don't match the scalar code\n");
+        return 1;
+    }
+    if (checkOnly) {
+        return 0;
+    }
+
+    ActorField field;
+
+    std::vector<Benchmark> benchmarks;
+    AddMathBenchmarks(benchmarks);
+    AddSpatialHashBenchmarks(benchmarks, field);
+    AddColliderBenchmarks(benchmarks, field);
+    AddParsingBenchmarks(benchmarks);
+    AddRandomBenchmarks(benchmarks);
+
+    std::vector<BenchResult> results;
+    std::printf("%-32s %14s %14s\n", "benchmark", "ns/op", "iterations");
+
+    for (const auto& benchmark : benchmarks)
+    {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        BenchResult result = Measure(benchmark, minTimeMs);
+        std::printf("%-32s %14.2f %14lld\n", result.name.c_str(), result.nsPerOp, result.iterations);
+        results.push_back(result);
+    }
+
+    if (!jsonPath.empty() && !WriteJson(jsonPath, results, minTimeMs)) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+// Micro-benchmark for the job system: per-job overhead of empty jobs and
+// ParallelFor scaling from 1 worker up to the number of hardware threads.
+//
+// Usage:
+//   jobsystem-bench [--jobs N] [--items N] [--max-workers N]
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Source/JobSystem.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Schedules numJobs empty jobs on one counter and waits for them
+static double MeasureOverhead(int numWorkers, int numJobs)
+{
+    JobSystem jobs(numWorkers);
+    JobCounter counter;
+
+    auto start = Clock::now();
+    for (int i = 0; i < numJobs; ++i) {
+        jobs.Run([]() {}, &counter);
+    }
+    jobs.Wait(counter);
+
+    return ElapsedMs(start) * 1000000.0 / numJobs;
+}
+
+// A ParallelFor over a float-heavy loop, best of a few runs
+static double MeasureParallelFor(int numWorkers, int numItems, std::vector<float>& data)
+{
+    JobSystem jobs(numWorkers);
+    double best = 0.0;
+
+    for (int run = 0; run < 5; ++run)
+    {
+        auto start = Clock::now();
+        jobs.ParallelFor(numItems, 1024, [&data](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                float x = data[i];
+                for (int k = 0; k < 32; ++k) {
+                    x = std::sqrt(x * x + 1.0f);
+                }
+                data[i] = x;
+            }
+        });
+
+        double elapsed = ElapsedMs(start);
+        best = run == 0 || elapsed < best ? elapsed : best;
+    }
+
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    int numJobs = 200000;
+    int numItems = 1 << 20;
+    int maxWorkers = static_cast<int>(std::thread::hardware_concurrency());
+    maxWorkers = maxWorkers < 1 ? 1 : maxWorkers;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--jobs" && i + 1 < argc) {
+            numJobs = std::stoi(argv[++i]);
+        } else if (arg == "--items" && i + 1 < argc) {
+            numItems = std::stoi(argv[++i]);
+        } else if (arg == "--max-workers" && i + 1 < argc) {
+            maxWorkers = std::stoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Unknown argument %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    std::printf("Per-job overhead (%d empty jobs)\n", numJobs);
+    std::printf("  inline    %8.1f ns/job\n", MeasureOverhead(0, numJobs));
+    for (int workers = 1; workers <= maxWorkers; workers *= 2) {
+        std::printf("  %2d worker %8.1f ns/job\n", workers, MeasureOverhead(workers, numJobs));
+    }
+
+    std::vector<float> data(numItems, 1.0f);
+
+    std::printf("ParallelFor scaling (%d items)\n", numItems);
+    double baseline = MeasureParallelFor(0, numItems, data);
+    std::printf("  inline    %8.2f ms\n", baseline);
+    for (int workers = 1; workers <= maxWorkers; workers *= 2) {
+        double elapsed = MeasureParallelFor(workers, numItems, data);
+        std::printf("  %2d worker %8.2f ms  (%.2fx)\n", workers, elapsed, baseline / elapsed);
+    }
+
+    return 0;
+}
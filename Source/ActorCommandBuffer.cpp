@@ -0,0 +1,62 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "ActorCommandBuffer.h"
+#include <algorithm>
+#include "Actors/Actor.h"
+
+void ActorCommandBuffer::Spawn(Actor* actor)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!actor->mIsSpawnPending.exchange(true, std::memory_order_relaxed)) {
+        mSpawns.emplace_back(actor);
+    }
+}
+
+void ActorCommandBuffer::Destroy(Actor* actor)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!actor->mIsDestroyPending.exchange(true, std::memory_order_relaxed)) {
+        mDestroys.emplace_back(actor);
+    }
+}
+
+bool ActorCommandBuffer::IsSpawnPending(const Actor* actor) const
+{
+    return actor->mIsSpawnPending.load(std::memory_order_relaxed);
+}
+
+void ActorCommandBuffer::Forget(Actor* actor)
+{
+    if (!actor->mIsSpawnPending.load(std::memory_order_relaxed) &&
+        !actor->mIsDestroyPending.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (actor->mIsSpawnPending.exchange(false, std::memory_order_relaxed)) {
+        mSpawns.erase(std::remove(mSpawns.begin(), mSpawns.end(), actor), mSpawns.end());
+    }
+    if (actor->mIsDestroyPending.exchange(false, std::memory_order_relaxed)) {
+        mDestroys.erase(std::remove(mDestroys.begin(), mDestroys.end(), actor), mDestroys.end());
+    }
+}
+
+bool ActorCommandBuffer::Take(std::vector<Actor*>& spawns, std::vector<Actor*>& destroys)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    spawns.clear();
+    destroys.clear();
+    spawns.swap(mSpawns);
+    destroys.swap(mDestroys);
+
+    // Taken commands are the caller's now
+    for (auto actor : spawns) {
+        actor->mIsSpawnPending.store(false, std::memory_order_relaxed);
+    }
+    for (auto actor : destroys) {
+        actor->mIsDestroyPending.store(false, std::memory_order_relaxed);
+    }
+    return !spawns.empty() || !destroys.empty();
+}
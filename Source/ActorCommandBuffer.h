@@ -0,0 +1,36 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+// Actor spawns and destroys requested while the actors update. Game applies
+// them all at once after the update, so the actors being iterated and the
+// broad phase never change under the update. Recording is thread-safe.
+class ActorCommandBuffer
+{
+public:
+    // Queue an actor to be inserted in the scene (once)
+    void Spawn(class Actor* actor);
+
+    // Queue an actor to be deleted (once)
+    void Destroy(class Actor* actor);
+
+    // Reads a flag on the actor, no lock or search
+    bool IsSpawnPending(const class Actor* actor) const;
+
+    // Drop every command about an actor that is being deleted (only searches
+    // the queues when the actor has one pending)
+    void Forget(class Actor* actor);
+
+    // Move the queued commands out. Returns false if there were none.
+    bool Take(std::vector<class Actor*>& spawns, std::vector<class Actor*>& destroys);
+
+private:
+    std::mutex mMutex;
+    std::vector<class Actor*> mSpawns;
+    std::vector<class Actor*> mDestroys;
+};
@@ -9,6 +9,7 @@
 #include "Actor.h"
 #include "../Game.h"
 #include "../Components/Component.h"
+#include "../Snapshot.h"
 #include <algorithm>
 
 Actor::Actor(Game* game)
@@ -19,12 +20,17 @@ Actor::Actor(Game* game)
         , mGame(game)
         , mIsOnGround(false)
 {
+    mId = mGame->RegisterActor(this);
     mGame->AddActor(this);
+
+    // Only the frames after its creation count as missed
+    mLastUpdateFrame = mGame->GetSimulationFrame() - 1;
 }
 
 Actor::~Actor()
 {
     mGame->RemoveActor(this);
+    mGame->UnregisterActor(this);
 
     for(auto component : mComponents)
     {
@@ -39,10 +45,32 @@ void Actor::SetPosition(const Vector2& pos)
     mGame->Reinsert(this);
 }
 
+void Actor::SetState(ActorState state)
+{
+    if (state == ActorState::Destroy) {
+        Destroy();
+        return;
+    }
+
+    mState = state;
+}
+
+void Actor::Destroy()
+{
+    if (mState == ActorState::Destroy) {
+        return;
+    }
+
+    mState = ActorState::Destroy;
+    mGame->DestroyActor(this);
+}
+
 void Actor::Update(float deltaTime)
 {
     if (mState == ActorState::Active)
     {
+        Metrics::Add(Metric::ActorsUpdated);
+
         for (auto comp : mComponents)
         {
             if(comp->IsEnabled())
@@ -60,53 +88,78 @@ void Actor::OnUpdate(float deltaTime)
 
 }
 
-void Actor::OnHorizontalCollision(const float minOverlap, AABBColliderComponent* other) {
+void Actor::Kill()
+{
 
 }
 
-void Actor::OnVerticalCollision(const float minOverlap, AABBColliderComponent* other) {
+void Actor::OnCollisionBegin(AABBColliderComponent* other, const Vector2& normal) {
 
 }
 
-void Actor::Kill()
-{
+void Actor::OnCollisionStay(AABBColliderComponent* other, const Vector2& normal) {
+
+}
+
+void Actor::OnCollisionEnd(AABBColliderComponent* other) {
 
 }
 
-void Actor::ProcessInput(const Uint8* keyState)
+void Actor::SaveSpawn(SnapshotWriter& writer) const
 {
-    if (mState == ActorState::Active)
-    {
-        for (auto comp : mComponents)
-        {
-            comp->ProcessInput(keyState);
-        }
 
-        OnProcessInput(keyState);
+}
+
+void Actor::SaveState(SnapshotWriter& writer) const
+{
+    writer.Write(mState);
+    writer.Write(mLastUpdateFrame);
+    writer.Write(mPosition);
+    writer.Write(mScale);
+    writer.Write(mRotation);
+    writer.Write(mIsOnGround);
+
+    writer.Write(static_cast<uint8_t>(mComponents.size()));
+    for (auto comp : mComponents) {
+        comp->SaveState(writer);
     }
 }
 
-void Actor::HandleKeyPress(const int key, const bool isPressed)
+void Actor::LoadState(SnapshotReader& reader)
 {
-    if (mState == ActorState::Active)
-    {
-        for (auto comp : mComponents)
-        {
-            comp->HandleKeyPress(key, isPressed);
-        }
+    reader.Read(mState);
+    reader.Read(mLastUpdateFrame);
+    Vector2 position = reader.Read<Vector2>();
+    reader.Read(mScale);
+    reader.Read(mRotation);
+    reader.Read(mIsOnGround);
+
+    // Actors of a type are always built with the same components
+    if (reader.Read<uint8_t>() != mComponents.size()) {
+        SDL_Log("Snapshot doesn't match the components of actor %u", mId);
+        return;
+    }
 
-        // Call actor-specific key press handling
-        OnHandleKeyPress(key, isPressed);
+    for (auto comp : mComponents) {
+        comp->LoadState(reader);
     }
 
+    if (position.x != mPosition.x || position.y != mPosition.y) {
+        SetPosition(position);
+    }
+}
+
+void Actor::OnActionEvent(InputAction action, bool isPressed)
+{
+
 }
 
-void Actor::OnProcessInput(const Uint8* keyState)
+void Actor::OnActionInput(const InputSystem& input, int player)
 {
 
 }
 
-void Actor::OnHandleKeyPress(const int key, const bool isPressed)
+void Actor::OnPointerMoved(int x, int y)
 {
 
 }
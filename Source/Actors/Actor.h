@@ -7,9 +7,12 @@
 // ----------------------------------------------------------------
 
 #pragma once
+#include <atomic>
 #include <vector>
 #include <SDL_stdinc.h>
 #include "../Math.h"
+#include "../Metrics.h"
+#include "../SceneArena.h"
 #include "../Components/ColliderComponents/AABBColliderComponent.h"
 
 enum class ActorState
@@ -19,18 +22,31 @@ enum class ActorState
     Destroy
 };
 
+// Kinds of actors Game knows how to recreate when restoring a snapshot
+enum class ActorType : uint8_t
+{
+    Other,
+    Mouse,
+    Block,
+    Cheese,
+    Exit,
+    Goomba
+};
+
+enum class InputAction : uint8_t;
+
 class Actor
 {
 public:
     Actor(class Game* game);
     virtual ~Actor();
 
+    // Actors are allocated from the current scene arena
+    static void* operator new(size_t size) { return SceneArena::AllocateObject(size); }
+    static void operator delete(void* ptr) { SceneArena::FreeObject(ptr); }
+
     // Reinsert function called from Game (not overridable)
     void Update(float deltaTime);
-    // ProcessInput function called from Game (not overridable)
-    void ProcessInput(const Uint8* keyState);
-    // HandleKeyPress function called from Game (not overridable)
-    void HandleKeyPress(const int key, const bool isPressed);
 
     // Position getter/setter
     const Vector2& GetPosition() const { return mPosition; }
@@ -48,15 +64,36 @@ public:
 
     // State getter/setter
     ActorState GetState() const { return mState; }
-    void SetState(ActorState state) { mState = state; }
+    void SetState(ActorState state);
+
+    // Mark the actor as destroyed. Game deletes it once the actors are done
+    // updating, so it stays valid until the end of the frame.
+    void Destroy();
 
     // Game getter
     class Game* GetGame() { return mGame; }
 
+    // Id given by Game on creation, unique within a scene
+    uint32_t GetId() const { return mId; }
+
+    // Last simulation frame the actor was updated in (see Game::UpdateActors)
+    uint32_t GetLastUpdateFrame() const { return mLastUpdateFrame; }
+    void SetLastUpdateFrame(uint32_t frame) { mLastUpdateFrame = frame; }
+
+    // World snapshots (see Game::SaveSnapshot). GetType tells Game how to
+    // recreate the actor on restore, SaveSpawn writes what its constructor
+    // needs and SaveState/LoadState the state that changes while playing.
+    virtual ActorType GetType() const { return ActorType::Other; }
+    virtual void SaveSpawn(class SnapshotWriter& writer) const;
+    virtual void SaveState(class SnapshotWriter& writer) const;
+    virtual void LoadState(class SnapshotReader& reader);
+
     // Returns component of type T, or null if doesn't exist
     template <typename T>
     T* GetComponent() const
     {
+        Metrics::Add(Metric::GetComponentCalls);
+
         for (auto c : mComponents)
         {
             T* t = dynamic_cast<T*>(c);
@@ -75,21 +112,34 @@ public:
     bool IsOnGround() const { return mIsOnGround; };
     bool IsVisibleOnCamera() const;
 
-    // Any actor-specific collision code (overridable)
-    virtual void OnHorizontalCollision(const float minOverlap, AABBColliderComponent* other);
-    virtual void OnVerticalCollision(const float minOverlap, AABBColliderComponent* other);
     virtual void Kill();
 
+    // Any actor-specific collision code (overridable). Sent after each physics
+    // step, once the bodies have moved: when the actor starts touching a
+    // collider, on every step it still does, and when it stops. The normal is
+    // the direction the actor was pushed out of the collider along, zero for
+    // triggers. Handlers must not delete actors (set ActorState::Destroy instead).
+    virtual void OnCollisionBegin(AABBColliderComponent* other, const Vector2& normal);
+    virtual void OnCollisionStay(AABBColliderComponent* other, const Vector2& normal);
+    virtual void OnCollisionEnd(AABBColliderComponent* other);
+
+    // Input actions, only delivered to actors subscribed to the InputSystem:
+    // pressed/released edges of the player's actions, then a call per frame to
+    // poll held actions, then the pointer position if it moved this frame
+    virtual void OnActionEvent(InputAction action, bool isPressed);
+    virtual void OnActionInput(const class InputSystem& input, int player);
+    virtual void OnPointerMoved(int x, int y);
+
 protected:
     class Game* mGame;
 
     // Any actor-specific update code (overridable)
     virtual void OnUpdate(float deltaTime);
-    virtual void OnProcessInput(const Uint8* keyState);
-    virtual void OnHandleKeyPress(const int key, const bool isPressed);
 
     // Actor's state
     ActorState mState;
+    uint32_t mId;
+    uint32_t mLastUpdateFrame;
 
     // Transform
     Vector2 mPosition;
@@ -104,6 +154,12 @@ protected:
 
 private:
     friend class Component;
+    friend class ActorCommandBuffer;
+
+    // Commands queued for the actor in Game's ActorCommandBuffer, so checking
+    // for them doesn't search its lists
+    std::atomic<bool> mIsSpawnPending{false};
+    std::atomic<bool> mIsDestroyPending{false};
 
     // Adds component to Actor (this is automatically called
     // in the component constructor)
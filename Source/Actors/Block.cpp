@@ -4,16 +4,19 @@
 
 #include "Block.h"
 #include "../Game.h"
+#include "../Snapshot.h"
 #include "../Actors/Goomba.h"
 #include "../Components/DrawComponents/DrawSpriteComponent.h"
 #include "../Components/DrawComponents/DrawPolygonComponent.h"
 #include "../Components/ColliderComponents/AABBColliderComponent.h"
 
-Block::Block(Game* game, const std::string &texturePath, const bool isStatic)
+Block::Block(Game* game, StringId texture, const bool isStatic)
         :Actor(game)
+        ,mTexture(texture)
+        ,mIsStatic(isStatic)
 {
-    if(texturePath != "empty") {
-        new DrawSpriteComponent(this, texturePath, Game::TILE_SIZE, Game::TILE_SIZE, 10);
+    if(texture != "empty"_id) {
+        new DrawSpriteComponent(this, texture, Game::TILE_SIZE, Game::TILE_SIZE, 10);
     }
     mColliderComponent = new AABBColliderComponent(this, 0, 0, Game::TILE_SIZE, Game::TILE_SIZE, ColliderLayer::Blocks, isStatic);
     mRigidBodyComponent = new RigidBodyComponent(this, 1.0f, 0.0f, false);
@@ -28,6 +31,7 @@ void Block::OnBump()
 
     // Disable collider
     mColliderComponent->SetStatic(false);
+    mRigidBodyComponent->WakeUp();
     mRigidBodyComponent->SetVelocity(Vector2::NegUnitY * BUMP_FORCE);
     mRigidBodyComponent->SetApplyGravity(true);
 }
@@ -44,10 +48,10 @@ void Block::OnUpdate(float deltaTime)
     }
 }
 
-void Block::OnVerticalCollision(const float minOverlap, AABBColliderComponent* other)
+void Block::OnCollisionBegin(AABBColliderComponent* other, const Vector2& normal)
 {
     // If collide against enemy, apply bump force
-    if (other->GetLayer() == ColliderLayer::Enemy)
+    if (other->GetLayer() == ColliderLayer::Enemy && normal.y != 0.0f)
     {
         Goomba* goomba = static_cast<Goomba*>(other->GetOwner());
         goomba->BumpKill();
@@ -58,3 +62,21 @@ void Block::OnVerticalCollision(const float minOverlap, AABBColliderComponent* o
     }
 }
 
+void Block::SaveSpawn(SnapshotWriter& writer) const
+{
+    // "empty"_id comes from a literal, so it has no interned string
+    writer.WriteString(mTexture == "empty"_id ? "empty" : mTexture.GetString());
+    writer.Write(mIsStatic);
+}
+
+void Block::SaveState(SnapshotWriter& writer) const
+{
+    Actor::SaveState(writer);
+    writer.Write(mOriginalPosition);
+}
+
+void Block::LoadState(SnapshotReader& reader)
+{
+    Actor::LoadState(reader);
+    reader.Read(mOriginalPosition);
+}
@@ -5,12 +5,13 @@
 #pragma once
 
 #include "Actor.h"
-#include <string>
+#include "../StringId.h"
 
 class Block : public Actor
 {
 public:
-    explicit Block(Game* game, const std::string &texturePath, const bool isStatic = true);
+    // The texture id must be interned ("empty"_id for an invisible block)
+    explicit Block(Game* game, StringId texture, const bool isStatic = true);
 
     void SetPosition(const Vector2& position)
     {
@@ -20,13 +21,22 @@ public:
 
     void OnUpdate(float deltaTime) override;
     void OnBump();
-    void OnVerticalCollision(const float minOverlap, AABBColliderComponent* other) override;
+    void OnCollisionBegin(AABBColliderComponent* other, const Vector2& normal) override;
+
+    ActorType GetType() const override { return ActorType::Block; }
+    void SaveSpawn(class SnapshotWriter& writer) const override;
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
 
 private:
     const int BUMP_FORCE = 200;
 
     Vector2 mOriginalPosition;
 
+    // Constructor arguments, kept for snapshots
+    StringId mTexture;
+    bool mIsStatic;
+
     class AABBColliderComponent* mColliderComponent;
     class RigidBodyComponent* mRigidBodyComponent;
 };
@@ -15,5 +15,5 @@ Cheese::Cheese(Game* game)
 void Cheese::Kill()
 {
     mColliderComponent->SetEnabled(false);
-    SetState(ActorState::Destroy);
+    Destroy();
 }
@@ -9,6 +9,8 @@ public:
 
     void Kill() override;
 
+    ActorType GetType() const override { return ActorType::Cheese; }
+
 private:
     class DrawSpriteComponent* mDrawComponent;
     class AABBColliderComponent* mColliderComponent;
@@ -12,6 +12,8 @@ class Exit : public Actor
 public:
     explicit Exit(Game* game);
 
+    ActorType GetType() const override { return ActorType::Exit; }
+
 private:
     class DrawSpriteComponent* mDrawComponent;
     class AABBColliderComponent* mColliderComponent;
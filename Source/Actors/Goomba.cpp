@@ -7,6 +7,7 @@
 #include "../Components/DrawComponents/DrawAnimatedComponent.h"
 #include "../Components/DrawComponents/DrawPolygonComponent.h"
 #include "../Random.h"
+#include "../Snapshot.h"
 
 Goomba::Goomba(Game* game, float forwardSpeed, float deathTime)
         : Actor(game)
@@ -23,26 +24,23 @@ Goomba::Goomba(Game* game, float forwardSpeed, float deathTime)
 
     mDrawComponent = new DrawAnimatedComponent(this,
                                                   "../Assets/Sprites/Goomba/Goomba.png",
-                                                  "../Assets/Sprites/Goomba/Goomba.json");
+                                                  "../Assets/Sprites/Goomba/Goomba.json",
+                                                  "../Assets/Animations/Goomba.json");
 
-    mDrawComponent->AddAnimation("Dead", {0});
-    mDrawComponent->AddAnimation("Idle", {1});
-    mDrawComponent->AddAnimation("walk", {1, 2});
-    mDrawComponent->SetAnimation("walk");
-    mDrawComponent->SetAnimFPS(5.0f);
+    mDrawComponent->SetAnimation("walk"_id);
 }
 
 void Goomba::Kill()
 {
     mIsDying = true;
-    mDrawComponent->SetAnimation("Dead");
+    mDrawComponent->SetAnimation("Dead"_id);
     mRigidBodyComponent->SetEnabled(false);
     mColliderComponent->SetEnabled(false);
 }
 
 void Goomba::BumpKill(const float bumpForce)
 {
-    mDrawComponent->SetAnimation("Idle");
+    mDrawComponent->SetAnimation("Idle"_id);
 
     mRigidBodyComponent->SetVelocity(Vector2(bumpForce/2.0f, -bumpForce));
     mColliderComponent->SetEnabled(false);
@@ -57,36 +55,56 @@ void Goomba::OnUpdate(float deltaTime)
     {
         mDyingTimer -= deltaTime;
         if (mDyingTimer <= 0.0f) {
-            mState = ActorState::Destroy;
+            Destroy();
         }
     }
 
-    if (GetPosition().y > GetGame()->GetWindowHeight())
+    if (GetPosition().y > GetGame()->GetLevelHeight() * Game::TILE_SIZE)
     {
-        mState = ActorState::Destroy;
+        Destroy();
     }
 }
 
-void Goomba::OnHorizontalCollision(const float minOverlap, AABBColliderComponent* other)
+void Goomba::OnCollisionBegin(AABBColliderComponent* other, const Vector2& normal)
 {
-    if ((other->GetLayer() == ColliderLayer::Blocks || other->GetLayer() == ColliderLayer::Enemy))
+    if (other->GetLayer() == ColliderLayer::Player) {
+        other->GetOwner()->Kill();
+    }
+
+    OnCollisionStay(other, normal);
+}
+
+void Goomba::OnCollisionStay(AABBColliderComponent* other, const Vector2& normal)
+{
+    // Turn around when walking into a wall or another enemy
+    if ((other->GetLayer() == ColliderLayer::Blocks || other->GetLayer() == ColliderLayer::Enemy) && normal.x != 0.0f)
     {
-        if (minOverlap > 0) {
+        if (normal.x < 0.0f) {
             mRigidBodyComponent->SetVelocity(Vector2(-mForwardSpeed, 0.0f));
         }
         else {
             mRigidBodyComponent->SetVelocity(Vector2(mForwardSpeed, 0.0f));
         }
     }
+}
 
-    if (other->GetLayer() == ColliderLayer::Player) {
-        other->GetOwner()->Kill();
-    }
+void Goomba::SaveSpawn(SnapshotWriter& writer) const
+{
+    writer.Write(mForwardSpeed);
 }
 
-void Goomba::OnVerticalCollision(const float minOverlap, AABBColliderComponent* other)
+void Goomba::SaveState(SnapshotWriter& writer) const
 {
-    if (other->GetLayer() == ColliderLayer::Player) {
-        other->GetOwner()->Kill();
-    }
+    Actor::SaveState(writer);
+    writer.Write(mIsDying);
+    writer.Write(mDyingTimer);
+    writer.Write(mForwardSpeed);
+}
+
+void Goomba::LoadState(SnapshotReader& reader)
+{
+    Actor::LoadState(reader);
+    reader.Read(mIsDying);
+    reader.Read(mDyingTimer);
+    reader.Read(mForwardSpeed);
 }
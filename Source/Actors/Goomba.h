@@ -12,12 +12,17 @@ public:
     explicit Goomba(Game* game, float forwardSpeed = 100.0f, float deathTime = 0.5f);
 
     void OnUpdate(float deltaTime) override;
-    void OnHorizontalCollision(const float minOverlap, AABBColliderComponent* other) override;
-    void OnVerticalCollision(const float minOverlap, AABBColliderComponent* other) override;
+    void OnCollisionBegin(AABBColliderComponent* other, const Vector2& normal) override;
+    void OnCollisionStay(AABBColliderComponent* other, const Vector2& normal) override;
 
     void Kill() override;
     void BumpKill(const float bumpForce = 300.0f);
 
+    ActorType GetType() const override { return ActorType::Goomba; }
+    void SaveSpawn(class SnapshotWriter& writer) const override;
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
+
 private:
     bool mIsDying;
     float mForwardSpeed;
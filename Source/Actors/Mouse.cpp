@@ -5,6 +5,10 @@
 #include "Mouse.h"
 #include "Block.h"
 #include "../Game.h"
+#include "../InputSystem.h"
+#include "../RenderFrame.h"
+#include "../Snapshot.h"
+#include "../TextureAtlas.h"
 #include "../Components/DrawComponents/DrawAnimatedComponent.h"
 #include "../Components/DrawComponents/DrawPolygonComponent.h"
 #include <algorithm>
@@ -28,77 +32,44 @@ Mouse::Mouse(Game* game, const float forwardSpeed, const float jumpSpeed, const
 
     mDrawComponent = new DrawAnimatedComponent(this,
                                               isPlayer1 ? player1Sprite : player2Sprite,
-                                              "../Assets/Sprites/Mouse/Mouse.json");
+                                              "../Assets/Sprites/Mouse/Mouse.json",
+                                              "../Assets/Animations/Mouse.json");
 
-    mDrawComponent->AddAnimation("Dead", {0});
-    mDrawComponent->AddAnimation("idle", {1});
-    mDrawComponent->AddAnimation("jump", {2});
-    mDrawComponent->AddAnimation("run", {3, 4, 5, 6, 7});
-    mDrawComponent->AddAnimation("win", {8});
-    mDrawComponent->AddAnimation("wizard", {9});
-
-    mDrawComponent->SetAnimation("idle");
-    mDrawComponent->SetAnimFPS(10.0f);
+    mDrawComponent->SetAnimation("idle"_id);
 
     mCollectedCheese = false;
-}
-
-bool Mouse::PressedLeft(const uint8_t* state) {
-    if(mIsPlayer1) {
-        return state[SDL_SCANCODE_A];
-    }
-    return state[SDL_SCANCODE_LEFT];
-}
 
-bool Mouse::PressedRight(const uint8_t* state) {
-    if(mIsPlayer1) {
-        return state[SDL_SCANCODE_D];
-    }
-    return state[SDL_SCANCODE_RIGHT];
+    mGame->GetInput()->Subscribe(this, isPlayer1 ? 0 : 1);
 }
 
-bool Mouse::PressedUp(const uint8_t* state) {
-    if(mIsPlayer1) {
-        return state[SDL_SCANCODE_W];
-    }
-    return state[SDL_SCANCODE_UP];
-}
-
-bool Mouse::PressedDown(const uint8_t* state) {
-    if(mIsPlayer1) {
-        return state[SDL_SCANCODE_S];
-    }
-    return state[SDL_SCANCODE_DOWN];
+Mouse::~Mouse()
+{
+    mGame->GetInput()->Unsubscribe(this);
 }
 
-void Mouse::OnProcessInput(const uint8_t* state)
+void Mouse::OnActionInput(const InputSystem& input, int player)
 {
     if(mGame->GetGamePlayState() != Game::GamePlayState::Playing) return;
     if(mSpellMode) return;
 
-    if (PressedRight(state))
+    bool pressedRight = input.IsHeld(player, InputAction::MoveRight);
+    bool pressedLeft = input.IsHeld(player, InputAction::MoveLeft);
+
+    if (pressedRight)
     {
         mRigidBodyComponent->ApplyForce(Vector2::UnitX * mForwardSpeed);
         mRotation = 0.0f;
         mIsRunning = true;
     }
 
-    if (PressedLeft(state))
+    if (pressedLeft)
     {
         mRigidBodyComponent->ApplyForce(Vector2::UnitX * -mForwardSpeed);
         mRotation = Math::Pi;
         mIsRunning = true;
     }
 
-    if ((state[SDL_SCANCODE_X] && mIsPlayer1) || (state[SDL_SCANCODE_M] && !mIsPlayer1)) {
-        if(mSpellCount > 0) {
-            ToggleSpellMode();
-            ChangeToWizardSprite(mSpellMode);
-            SDL_Log("Toggled spellMode %d", mSpellMode);
-        }
-    }
-
-    if (!PressedLeft(state) && !PressedRight(state))
+    if (!pressedLeft && !pressedRight)
     {
         mIsRunning = false;
     }
@@ -115,20 +86,29 @@ void Mouse::CastSpell(int x, int y) {
     SDL_Log("Cast Spell Called");
     SDL_Log("%d", mSpellCount);
     if(mSpellCount > 0) {
-        Block* block = new Block(mGame, "../Assets/Sprites/Blocks/rock.png", false);
-        block->SetPosition(mBlockPreviewPos);
+        // The cell comes from the pointer given with the cast (sent over the
+        // network in netplay), not from the preview, which only follows it
+        Block* block = new Block(mGame, StringId("../Assets/Sprites/Blocks/rock.png"), false);
+        block->SetPosition(GetBlockCell(x, y));
         mSpellCount--;
         ToggleSpellMode();
         ChangeToWizardSprite(mSpellMode);
     }
 }
 
-void Mouse::OnHandleKeyPress(const int key, const bool isPressed)
+void Mouse::OnActionEvent(InputAction action, bool isPressed)
 {
     if(mGame->GetGamePlayState() != Game::GamePlayState::Playing) return;
+    if(!isPressed) return;
+
+    if (action == InputAction::ToggleSpell && mSpellCount > 0) {
+        ToggleSpellMode();
+        ChangeToWizardSprite(mSpellMode);
+        SDL_Log("Toggled spellMode %d", mSpellMode);
+    }
 
     // Jump
-    if (((key == SDLK_w && mIsPlayer1) || (key == SDLK_UP && !mIsPlayer1)) && isPressed && (mIsOnGround || (mCanWallJump && !mIsOnWall)) && !mSpellMode)
+    if (action == InputAction::Jump && (mIsOnGround || (mCanWallJump && !mIsOnWall)) && !mSpellMode)
     {
         mRigidBodyComponent->SetVelocity(Vector2(mRigidBodyComponent->GetVelocity().x, mJumpSpeed));
         mCanWallJump = false;
@@ -137,7 +117,14 @@ void Mouse::OnHandleKeyPress(const int key, const bool isPressed)
         // SetSpeed(2000.0f);
 
         // Play jump sound
-//        mGame->GetAudio()->PlaySound("Jump.wav");
+//        mGame->GetAudio()->PlaySound("Jump.wav"_id);
+    }
+}
+
+void Mouse::OnPointerMoved(int x, int y)
+{
+    if (mSpellMode) {
+        UpdateBlockPreview(x, y);
     }
 }
 
@@ -157,24 +144,15 @@ void Mouse::OnHandleKeyPress(const int key, const bool isPressed)
 
     mPosition.x = Math::Max(mPosition.x, mGame->GetCameraPos().x);
 
-    if (mGame->GetGamePlayState() == Game::GamePlayState::Playing && mPosition.y > mGame->GetWindowHeight()) {
+    if (mGame->GetGamePlayState() == Game::GamePlayState::Playing && mPosition.y > mGame->GetLevelHeight() * Game::TILE_SIZE) {
         Kill();
     }
 
 
     if (mGame->GetGamePlayState() == Game::GamePlayState::Leaving)
     {
-        mState = ActorState::Destroy;
-        auto gameScene = mGame->GetGameSceneSequence();
-        auto currentIt = std::find(gameScene.begin(), gameScene.end(), mGame->GetGameScene());
-        if (currentIt != gameScene.end()) {
-            auto nextIt = currentIt + 1;
-            if (nextIt != gameScene.end()) {
-                mGame->SetGameScene(*nextIt);
-            } else {
-                mGame->SetGameScene(Game::GameScene::MainMenu);
-            }
-        }
+        Destroy();
+        mGame->SetGameScene(mGame->GetNextScene(mGame->GetGameScene()));
         return;
     }
 
@@ -185,22 +163,22 @@ void Mouse::ManageAnimations()
 {
     if(mIsDying)
     {
-        mDrawComponent->SetAnimation("Dead");
+        mDrawComponent->SetAnimation("Dead"_id);
     }
     else if(mSpellMode) {
-        mDrawComponent->SetAnimation("wizard");
+        mDrawComponent->SetAnimation("wizard"_id);
     }
     else if (mIsOnGround && mIsRunning)
     {
-        mDrawComponent->SetAnimation("run");
+        mDrawComponent->SetAnimation("run"_id);
     }
     else if (mIsOnGround && !mIsRunning)
     {
-        mDrawComponent->SetAnimation("idle");
+        mDrawComponent->SetAnimation("idle"_id);
     }
     else if (!mIsOnGround)
     {
-        mDrawComponent->SetAnimation("jump");
+        mDrawComponent->SetAnimation("jump"_id);
     }
 }
 
@@ -210,13 +188,13 @@ void Mouse::Kill()
     if(mGame->AlivePlayers() == 1) {
         mGame->SetGamePlayState(Game::GamePlayState::GameOver);
     }
-    mDrawComponent->SetAnimation("Dead");
+    mDrawComponent->SetAnimation("Dead"_id);
 
     mRigidBodyComponent->SetEnabled(false);
     mColliderComponent->SetEnabled(false);
 
     mGame->GetAudio()->StopAllSounds();
-    mGame->GetAudio()->PlaySound("Dead.wav");
+    mGame->GetAudio()->PlaySound("Dead.wav"_id);
 
     mGame->ResetGameScene(3.5f); // Reset the game scene after 3 seconds
 }
@@ -225,81 +203,62 @@ void Mouse::Win()
 {
 }
 
-void Mouse::OnHorizontalCollision(const float minOverlap, AABBColliderComponent* other)
+void Mouse::OnCollisionBegin(AABBColliderComponent* other, const Vector2& normal)
 {
     if (other->GetLayer() == ColliderLayer::Enemy)
     {
-        Kill();
-    }
-    if(other->GetLayer() == ColliderLayer::Blocks) {
-        mIsOnWall = true;
-        mWallJumpCooldown = 20;
+        if (normal.y != 0.0f)
+        {
+            other->GetOwner()->Kill();
+            mRigidBodyComponent->SetVelocity(Vector2(mRigidBodyComponent->GetVelocity().x, mJumpSpeed / 2.5f));
+
+            // Play jump sound
+            mGame->GetAudio()->PlaySound("Stomp.wav"_id);
+        }
+        else
+        {
+            Kill();
+        }
     }
     if (other->GetLayer() == ColliderLayer::Collectable)
     {
         CollectCheese();
     }
-    if (other->GetLayer() == ColliderLayer::Exit && mCollectedCheese) {
-        if(GetIsLeaving()) return;
-
-        SetIsLeaving(true);
-
-        SDL_Log("%d", mGame->PlayersLeaving());
-        SDL_Log("%d", mGame->AlivePlayers());
-
-        if(mGame->PlayersLeaving() == mGame->AlivePlayers()) {
-            mGame->SetGamePlayState(Game::GamePlayState::Leaving);
-            mGame->GetAudio()->PlaySound("victory.wav");
-        }
 
-        mRigidBodyComponent->SetEnabled(false);
-        mColliderComponent->SetEnabled(false);
-        mDrawComponent->SetEnabled(false);
-        mState = ActorState::Destroy;
-    }
+    OnCollisionStay(other, normal);
 }
 
-void Mouse::OnVerticalCollision(const float minOverlap, AABBColliderComponent* other)
+void Mouse::OnCollisionStay(AABBColliderComponent* other, const Vector2& normal)
 {
-    if (other->GetLayer() == ColliderLayer::Enemy)
-    {
-        other->GetOwner()->Kill();
-        mRigidBodyComponent->SetVelocity(Vector2(mRigidBodyComponent->GetVelocity().x, mJumpSpeed / 2.5f));
-
-        // Play jump sound
-        mGame->GetAudio()->PlaySound("Stomp.wav");
-    }
-    else if (other->GetLayer() == ColliderLayer::Blocks)
-    {
-        if (!mIsOnGround) {
-//            mGame->GetAudio()->PlaySound("Bump.wav");
-//
-//            Block* block = static_cast<Block*>(other->GetOwner());
-//            block->OnBump();
-        }
-    }
-    if (other->GetLayer() == ColliderLayer::Collectable)
-    {
-        CollectCheese();
+    if (other->GetLayer() == ColliderLayer::Blocks && normal.x != 0.0f) {
+        mIsOnWall = true;
+        mWallSide = normal.x > 0.0f;
+        mWallJumpCooldown = 20;
     }
+    // The cheese may be collected while already standing on the exit
     if (other->GetLayer() == ColliderLayer::Exit && mCollectedCheese) {
-        if(GetIsLeaving()) return;
+        Leave();
+    }
+}
 
-        SetIsLeaving(true);
+void Mouse::Leave()
+{
+    if(GetIsLeaving()) return;
 
-        SDL_Log("%d", mGame->PlayersLeaving());
-        SDL_Log("%d", mGame->AlivePlayers());
+    SetIsLeaving(true);
 
-        if(mGame->PlayersLeaving() == mGame->AlivePlayers()) {
-            mGame->SetGamePlayState(Game::GamePlayState::Leaving);
-            mGame->GetAudio()->PlaySound("victory.wav");
-        }
+    SDL_Log("%d", mGame->PlayersLeaving());
+    SDL_Log("%d", mGame->AlivePlayers());
 
-        mRigidBodyComponent->SetEnabled(false);
-        mColliderComponent->SetEnabled(false);
-        mDrawComponent->SetEnabled(false);
-        mState = ActorState::Destroy;
+    if(mGame->PlayersLeaving() == mGame->AlivePlayers()) {
+        mGame->SetGamePlayState(Game::GamePlayState::Leaving);
+        mGame->GetAudio()->PlaySound("victory.wav"_id);
     }
+
+    mRigidBodyComponent->SetEnabled(false);
+    mColliderComponent->SetEnabled(false);
+    mDrawComponent->SetEnabled(false);
+    Destroy();
 }
 
 void Mouse::CollectCheese() {
@@ -307,14 +266,14 @@ void Mouse::CollectCheese() {
         mCollectedCheese = true;
         mForwardSpeed = 800.0f;
         mJumpSpeed = -525.0f;
-        mGame->GetAudio()->PlaySound("cheese.wav");
+        mGame->GetAudio()->PlaySound("cheese.wav"_id);
 
         std::string cheeseSprite = mIsPlayer1 ? "../Assets/Sprites/Mouse/Mouse1_cheese.png" : "../Assets/Sprites/Mouse/Mouse2_cheese.png";
         mDrawComponent->ChangeSpriteSheet(cheeseSprite, "../Assets/Sprites/Mouse/Mouse.json");
     }
 }
 
-void Mouse::ChangeToWizardSprite(bool toWizard) {
+std::string Mouse::GetSpriteSheetPath(bool toWizard) const {
     std::string spritePath;
     if (toWizard) {
         if (mIsPlayer1) {
@@ -329,13 +288,17 @@ void Mouse::ChangeToWizardSprite(bool toWizard) {
             spritePath = mCollectedCheese ? "../Assets/Sprites/Mouse/Mouse2_cheese.png" : "../Assets/Sprites/Mouse/Mouse2.png";
         }
     }
-    mDrawComponent->ChangeSpriteSheet(spritePath, "../Assets/Sprites/Mouse/Mouse.json");
+    return spritePath;
+}
+
+void Mouse::ChangeToWizardSprite(bool toWizard) {
+    mDrawComponent->ChangeSpriteSheet(GetSpriteSheetPath(toWizard), "../Assets/Sprites/Mouse/Mouse.json");
 
     if(mSpellMode) {
-        mDrawComponent->SetAnimation("wizard");
+        mDrawComponent->SetAnimation("wizard"_id);
         SDL_Log("Wizard mode");
     } else {
-        mDrawComponent->SetAnimation("idle");
+        mDrawComponent->SetAnimation("idle"_id);
         SDL_Log("Idle mode");
     }
 }
@@ -345,23 +308,94 @@ void Mouse::UpdateBlockPreview(int mouseX, int mouseY) {
         mShowBlockPreview = false;
         return;
     }
-    int gridX = (mouseX / Game::TILE_SIZE) * Game::TILE_SIZE;
-    int gridY = (mouseY / Game::TILE_SIZE) * Game::TILE_SIZE;
-    mBlockPreviewPos = Vector2(gridX, gridY);
+    mBlockPreviewPos = GetBlockCell(mouseX, mouseY);
     mShowBlockPreview = true;
 }
 
-void Mouse::DrawBlockPreview(SDL_Renderer* renderer) {
-    if (!mShowBlockPreview) return;
-    SDL_Texture* previewTexture = mGame->LoadTexture("../Assets/Sprites/Blocks/rock.png");
-    SDL_Rect dstRect = {
+Vector2 Mouse::GetBlockCell(int x, int y) {
+    int gridX = (x / Game::TILE_SIZE) * Game::TILE_SIZE;
+    int gridY = (y / Game::TILE_SIZE) * Game::TILE_SIZE;
+    return Vector2(gridX, gridY);
+}
+
+SDL_Rect Mouse::GetBlockPreviewRect() const {
+    if (!mShowBlockPreview) return {0, 0, 0, 0};
+
+    return {
         static_cast<int>(mBlockPreviewPos.x - mGame->GetCameraPos().x),
         static_cast<int>(mBlockPreviewPos.y - mGame->GetCameraPos().y),
         Game::TILE_SIZE,
         Game::TILE_SIZE
     };
-    SDL_SetTextureAlphaMod(previewTexture, 128); // 50% transparent
-    SDL_RenderCopy(renderer, previewTexture, nullptr, &dstRect);
-    SDL_SetTextureAlphaMod(previewTexture, 255); // Reset alpha
-    SDL_DestroyTexture(previewTexture);
+}
+
+void Mouse::DrawBlockPreview(RenderFrame& frame) {
+    if (!mShowBlockPreview) return;
+
+    const std::string previewPath = "../Assets/Sprites/Blocks/rock.png";
+
+    // Use the atlas page or the cached texture instead of loading the file every frame
+    AtlasRegion region;
+    bool fromAtlas = mGame->GetAtlas()->FindSprite(previewPath, region);
+    SDL_Texture* previewTexture = fromAtlas ? region.texture : mGame->GetTexture(previewPath);
+
+    SDL_Rect dstRect = GetBlockPreviewRect();
+    frame.Copy(previewTexture, fromAtlas ? &region.rect : nullptr, dstRect, 0.0f, SDL_FLIP_NONE,
+               {255, 255, 255, 128}); // 50% transparent
+}
+
+void Mouse::SaveSpawn(SnapshotWriter& writer) const
+{
+    writer.Write(mIsPlayer1);
+    writer.Write(mForwardSpeed);
+    writer.Write(mJumpSpeed);
+}
+
+void Mouse::SaveState(SnapshotWriter& writer) const
+{
+    Actor::SaveState(writer);
+    writer.Write(mForwardSpeed);
+    writer.Write(mJumpSpeed);
+    writer.Write(mIsRunning);
+    writer.Write(mIsOnWall);
+    writer.Write(mWallSide);
+    writer.Write(mIsDying);
+    writer.Write(mCollectedCheese);
+    writer.Write(mWallJumpCooldown);
+    writer.Write(mCanWallJump);
+    writer.Write(mWasMovingAwayFromWall);
+    writer.Write(mIsLeaving);
+    writer.Write(mSpellMode);
+    writer.Write(mSpellCount);
+    writer.Write(mBlockPreviewPos);
+    writer.Write(mShowBlockPreview);
+}
+
+void Mouse::LoadState(SnapshotReader& reader)
+{
+    const bool wasSpellMode = mSpellMode;
+    const bool hadCheese = mCollectedCheese;
+
+    Actor::LoadState(reader);
+    reader.Read(mForwardSpeed);
+    reader.Read(mJumpSpeed);
+    reader.Read(mIsRunning);
+    reader.Read(mIsOnWall);
+    reader.Read(mWallSide);
+    reader.Read(mIsDying);
+    reader.Read(mCollectedCheese);
+    reader.Read(mWallJumpCooldown);
+    reader.Read(mCanWallJump);
+    reader.Read(mWasMovingAwayFromWall);
+    reader.Read(mIsLeaving);
+    reader.Read(mSpellMode);
+    reader.Read(mSpellCount);
+    reader.Read(mBlockPreviewPos);
+    reader.Read(mShowBlockPreview);
+
+    // The sprite sheet follows the spell mode and the cheese. Only the sheet
+    // changes, the animation playhead was restored with the components.
+    if (mSpellMode != wasSpellMode || mCollectedCheese != hadCheese) {
+        mDrawComponent->ChangeSpriteSheet(GetSpriteSheetPath(mSpellMode), "../Assets/Sprites/Mouse/Mouse.json");
+    }
 }
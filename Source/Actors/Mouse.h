@@ -10,13 +10,15 @@ class Mouse : public Actor
 {
 public:
     explicit Mouse(Game* game, float forwardSpeed = 1000.0f, float jumpSpeed = -600.0f, bool isPlayer1 = true);
+    ~Mouse() override;
 
-    void OnProcessInput(const Uint8* keyState) override;
     void OnUpdate(float deltaTime) override;
-    void OnHandleKeyPress(const int key, const bool isPressed) override;
+    void OnActionEvent(InputAction action, bool isPressed) override;
+    void OnActionInput(const class InputSystem& input, int player) override;
+    void OnPointerMoved(int x, int y) override;
 
-    void OnHorizontalCollision(const float minOverlap, AABBColliderComponent* other) override;
-    void OnVerticalCollision(const float minOverlap, AABBColliderComponent* other) override;
+    void OnCollisionBegin(AABBColliderComponent* other, const Vector2& normal) override;
+    void OnCollisionStay(AABBColliderComponent* other, const Vector2& normal) override;
 
     void SetIsOnWall(bool isOnWall) {
         mIsOnWall = isOnWall;
@@ -36,6 +38,9 @@ public:
     bool GetSpellMode() {
         return mSpellMode;
     }
+    bool IsPlayer1() const {
+        return mIsPlayer1;
+    }
 
     void CastSpell(int x, int y);
 
@@ -44,11 +49,6 @@ public:
         return mCollectedCheese;
     }
 
-    bool PressedLeft(const uint8_t* state);
-    bool PressedRight(const uint8_t* state);
-    bool PressedUp(const uint8_t* state);
-    bool PressedDown(const uint8_t* state);
-
     void ToggleSpellMode();
 
     void PerformWallJump();
@@ -57,11 +57,24 @@ public:
 
     void Kill() override;
     void Win();
+    // Step onto the exit with the cheese, the level ends once every player did
+    void Leave();
 
     void ChangeToWizardSprite(bool toWizard);
+    // Sprite sheet for the current cheese state, as a wizard or not
+    std::string GetSpriteSheetPath(bool toWizard) const;
 
     void UpdateBlockPreview(int mouseX, int mouseY);
-    void DrawBlockPreview(SDL_Renderer* renderer);
+    // Tile a spell cast at the pointer position x, y puts its block on
+    static Vector2 GetBlockCell(int x, int y);
+    void DrawBlockPreview(class RenderFrame& frame);
+    // Screen area of the block preview (empty when hidden)
+    SDL_Rect GetBlockPreviewRect() const;
+
+    ActorType GetType() const override { return ActorType::Mouse; }
+    void SaveSpawn(class SnapshotWriter& writer) const override;
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
 
 private:
     void ManageAnimations();
@@ -0,0 +1,206 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "Animation.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <SDL.h>
+#include "Json.h"
+
+static AnimationLoopMode ParseLoopMode(const std::string& mode)
+{
+    if (mode == "once") {
+        return AnimationLoopMode::Once;
+    }
+    if (mode == "pingpong") {
+        return AnimationLoopMode::PingPong;
+    }
+    return AnimationLoopMode::Loop;
+}
+
+// Read one clip, false if any of its fields has the wrong type
+static bool ParseClip(const nlohmann::json& clipData, float frameDuration, AnimationClip& clip)
+{
+    if (!clipData.is_object()) {
+        return false;
+    }
+
+    std::string name;
+    if (clipData.contains("name")) {
+        if (!clipData["name"].is_string()) {
+            return false;
+        }
+        name = clipData["name"].get<std::string>();
+    }
+    clip.name = StringId(name);
+
+    if (clipData.contains("loop")) {
+        if (!clipData["loop"].is_string()) {
+            return false;
+        }
+        clip.loopMode = ParseLoopMode(clipData["loop"].get<std::string>());
+    }
+
+    if (!clipData.contains("frames") || !clipData["frames"].is_array()) {
+        return false;
+    }
+    const auto& frames = clipData["frames"];
+
+    const bool hasDurations = clipData.contains("durations") && clipData["durations"].is_array() &&
+                              clipData["durations"].size() == frames.size();
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        if (!frames[i].is_number_unsigned() || frames[i].get<uint64_t>() > UINT16_MAX) {
+            return false;
+        }
+
+        float duration = frameDuration;
+        if (hasDurations)
+        {
+            const auto& durationData = clipData["durations"][i];
+            if (!durationData.is_number()) {
+                return false;
+            }
+            duration = durationData.get<float>();
+            if (duration <= 0.0f) {
+                duration = frameDuration;
+            }
+        }
+
+        clip.duration += duration;
+        clip.sprites.emplace_back(frames[i].get<uint16_t>());
+        clip.frameEnds.emplace_back(clip.duration);
+    }
+
+    return true;
+}
+
+bool AnimationSet::Load(const std::string& path)
+{
+    std::ifstream file(path);
+    nlohmann::json data = nlohmann::json::parse(file, nullptr, false);
+    if (data.is_discarded() || !data.is_object() || !data.contains("clips") || !data["clips"].is_array()) {
+        SDL_Log("Failed to parse animation set %s", path.c_str());
+        return false;
+    }
+
+    float frameDuration = 0.1f;
+    if (data.contains("frameDuration") && data["frameDuration"].is_number()) {
+        frameDuration = data["frameDuration"].get<float>();
+    }
+
+    const auto& clips = data["clips"];
+    for (size_t i = 0; i < clips.size(); ++i)
+    {
+        AnimationClip clip;
+        if (!ParseClip(clips[i], frameDuration, clip)) {
+            SDL_Log("Skipping malformed animation clip %zu in %s", i, path.c_str());
+            continue;
+        }
+
+        if (clip.sprites.empty() || clip.duration <= 0.0f) {
+            SDL_Log("Skipping empty animation clip %s in %s", clip.name.GetString().c_str(), path.c_str());
+            continue;
+        }
+
+        mClips.emplace_back(std::move(clip));
+    }
+
+    return true;
+}
+
+const AnimationClip* AnimationSet::FindClip(StringId name) const
+{
+    // A handful of clips per set, a linear search beats hashing
+    for (const auto& clip : mClips)
+    {
+        if (clip.name == name) {
+            return &clip;
+        }
+    }
+    return nullptr;
+}
+
+const AnimationSet* AnimationSystem::GetSet(const std::string& path)
+{
+    auto iter = mSets.find(path);
+    if (iter != mSets.end()) {
+        return &iter->second;
+    }
+
+    // Failed loads are kept (empty) so the file isn't read again
+    AnimationSet& set = mSets[path];
+    set.Load(path);
+    return &set;
+}
+
+uint32_t AnimationSystem::AllocatePlayhead()
+{
+    if (!mFreePlayheads.empty())
+    {
+        uint32_t playhead = mFreePlayheads.back();
+        mFreePlayheads.pop_back();
+        return playhead;
+    }
+
+    mPlayheads.emplace_back();
+    return static_cast<uint32_t>(mPlayheads.size() - 1);
+}
+
+void AnimationSystem::FreePlayhead(uint32_t playhead)
+{
+    mPlayheads[playhead] = AnimationPlayhead();
+    mFreePlayheads.emplace_back(playhead);
+}
+
+void AnimationSystem::Play(uint32_t playhead, const AnimationClip* clip)
+{
+    AnimationPlayhead& state = mPlayheads[playhead];
+    state.clip = clip;
+    state.time = 0.0f;
+    state.frame = 0;
+}
+
+void AnimationSystem::Update(float deltaTime)
+{
+    for (auto& playhead : mPlayheads)
+    {
+        const AnimationClip* clip = playhead.clip;
+        if (!clip || playhead.isPaused) {
+            continue;
+        }
+
+        // Time into the clip, then into the current pass through its frames
+        float time = playhead.time + deltaTime;
+        float passTime = time;
+        switch (clip->loopMode)
+        {
+            case AnimationLoopMode::Loop:
+                if (time >= clip->duration) {
+                    time = std::fmod(time, clip->duration);
+                }
+                passTime = time;
+                break;
+            case AnimationLoopMode::Once:
+                time = std::min(time, clip->duration);
+                passTime = time;
+                break;
+            case AnimationLoopMode::PingPong:
+                if (time >= 2.0f * clip->duration) {
+                    time = std::fmod(time, 2.0f * clip->duration);
+                }
+                passTime = time < clip->duration ? time : 2.0f * clip->duration - time;
+                break;
+        }
+        playhead.time = time;
+
+        const uint16_t lastFrame = static_cast<uint16_t>(clip->frameEnds.size() - 1);
+        uint16_t frame = 0;
+        while (frame < lastFrame && clip->frameEnds[frame] <= passTime) {
+            ++frame;
+        }
+        playhead.frame = frame;
+    }
+}
@@ -0,0 +1,87 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "StringId.h"
+
+enum class AnimationLoopMode : uint8_t
+{
+    Loop,
+    Once,       // Holds the last frame
+    PingPong    // Plays forward then backward
+};
+
+struct AnimationClip
+{
+    StringId name;
+    AnimationLoopMode loopMode = AnimationLoopMode::Loop;
+
+    // Sprite of each frame in the sheet and the time each frame ends at
+    std::vector<uint16_t> sprites;
+    std::vector<float> frameEnds;
+
+    // Time of one pass through the frames
+    float duration = 0.0f;
+};
+
+// The clips of an archetype (every Goomba shares one), read from a file in
+// Assets/Animations:
+//   {"frameDuration": 0.1,
+//    "clips": [{"name": "run", "frames": [3, 4, 5], "loop": "loop"},
+//              {"name": "Dead", "frames": [0], "durations": [0.5], "loop": "once"}]}
+// "durations" (seconds per frame) and "loop" are optional.
+class AnimationSet
+{
+public:
+    bool Load(const std::string& path);
+
+    // Null if the set has no such clip
+    const AnimationClip* FindClip(StringId name) const;
+
+private:
+    std::vector<AnimationClip> mClips;
+};
+
+// Where an instance is in its clip
+struct AnimationPlayhead
+{
+    const AnimationClip* clip = nullptr;
+    float time = 0.0f;
+    uint16_t frame = 0;
+    bool isPaused = false;
+};
+
+// Owns the animation sets and the playheads of every animated actor, which
+// all advance in one loop. Playheads are referred to by index, their slots
+// are reused once freed. Used from the simulation thread only.
+class AnimationSystem
+{
+public:
+    // Cached for the whole game, so the file is read once per archetype
+    const AnimationSet* GetSet(const std::string& path);
+
+    uint32_t AllocatePlayhead();
+    void FreePlayhead(uint32_t playhead);
+
+    AnimationPlayhead& GetPlayhead(uint32_t playhead) { return mPlayheads[playhead]; }
+    const AnimationPlayhead& GetPlayhead(uint32_t playhead) const { return mPlayheads[playhead]; }
+
+    // Start a clip from its first frame
+    void Play(uint32_t playhead, const AnimationClip* clip);
+
+    void Update(float deltaTime);
+
+    size_t GetNumPlayheads() const { return mPlayheads.size() - mFreePlayheads.size(); }
+
+private:
+    std::unordered_map<std::string, AnimationSet> mSets;
+
+    std::vector<AnimationPlayhead> mPlayheads;
+    std::vector<uint32_t> mFreePlayheads;
+};
@@ -0,0 +1,486 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "AssetManager.h"
+#include "Json.h"
+#include "RenderFrame.h"
+#include "TextureAtlas.h"
+#include "UIElements/UIFont.h"
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+AssetManager::AssetManager(SDL_Renderer* renderer, JobSystem* jobs, const TextureAtlas* atlas, size_t budget)
+    :mRenderer(renderer)
+    ,mJobs(jobs)
+    ,mAtlas(atlas)
+    ,mBudget(budget)
+    ,mResidentBytes(0)
+    ,mPinnedBytes(atlas ? atlas->GetResidentBytes() : 0)
+    ,mNumResident{0, 0, 0}
+    ,mWarnedOverBudget(false)
+    ,mUseCounter(0)
+    ,mSceneCounter(0)
+{
+    SDL_Log("Asset budget: %zu KB (%zu KB taken by the sprite atlas)", mBudget / 1024, mPinnedBytes / 1024);
+}
+
+AssetManager::~AssetManager()
+{
+    for (auto& entry : mAssets)
+    {
+        Asset& asset = *entry.second;
+
+        // Loads still running own the asset until they finish
+        if (asset.isLoading)
+        {
+            mJobs->Wait(asset.loading);
+            SDL_FreeSurface(asset.loadedSurface);
+            if (asset.loadedSound) {
+                Mix_FreeChunk(asset.loadedSound);
+            }
+        }
+
+        if (asset.isResident) {
+            Unload(asset);
+        }
+    }
+    mAssets.clear();
+}
+
+SDL_Texture* AssetManager::GetTexture(StringId path)
+{
+    Asset* asset = Use(AssetType::Texture, path);
+    return asset ? asset->texture : nullptr;
+}
+
+UIFont* AssetManager::GetFont(StringId path)
+{
+    Asset* asset = Use(AssetType::Font, path);
+    return asset ? asset->font : nullptr;
+}
+
+Mix_Chunk* AssetManager::GetSound(StringId path)
+{
+    Asset* asset = Use(AssetType::Sound, path);
+    return asset ? asset->sound : nullptr;
+}
+
+AssetManager::Asset* AssetManager::Use(AssetType type, StringId path)
+{
+    Asset& asset = FindOrAdd(type, path);
+    asset.lastUsed = ++mUseCounter;
+
+    if (!asset.isResident && !asset.hasFailed) {
+        LoadNow(asset);
+    }
+
+    if (!asset.isResident) {
+        return nullptr;
+    }
+
+    // Hold assets missing from the manifest until the scene ends, like the
+    // listed ones, since whatever uses them may keep the pointer
+    if (!mCurrentScene.empty() && asset.checkedScene != mSceneCounter)
+    {
+        asset.checkedScene = mSceneCounter;
+
+        AssetManifest& manifest = GetManifest(mCurrentScene);
+        std::vector<StringId>& paths = type == AssetType::Texture ? manifest.textures :
+                                       type == AssetType::Font ? manifest.fonts : manifest.sounds;
+        if (std::find(paths.begin(), paths.end(), path) == paths.end())
+        {
+            SDL_Log("%s is not in the %s manifest", asset.path.c_str(), mCurrentScene.c_str());
+            paths.emplace_back(path);
+            asset.refCount++;
+        }
+    }
+
+    return &asset;
+}
+
+void AssetManager::BeginScene(const std::string& sceneName)
+{
+    mSceneCounter++;
+
+    // The new scene is held before the previous one is let go, so the
+    // assets they share are kept
+    if (sceneName == mPrefetchScene) {
+        mPrefetchScene.clear();
+    } else {
+        Acquire(sceneName, false);
+    }
+
+    if (!mCurrentScene.empty()) {
+        Release(mCurrentScene);
+    }
+    mCurrentScene = sceneName;
+
+    for (Asset* asset : GetAssets(GetManifest(sceneName))) {
+        asset->checkedScene = mSceneCounter;
+    }
+
+    EvictOverBudget();
+}
+
+void AssetManager::Prefetch(const std::string& sceneName)
+{
+    if (sceneName == mPrefetchScene || sceneName == mCurrentScene) {
+        return;
+    }
+
+    Acquire(sceneName, true);
+
+    if (!mPrefetchScene.empty()) {
+        Release(mPrefetchScene);
+    }
+    mPrefetchScene = sceneName;
+
+    EvictOverBudget();
+}
+
+void AssetManager::Update()
+{
+    // Hand over the loads that finished
+    int numFinished = 0;
+    auto iter = mLoading.begin();
+    while (iter != mLoading.end() && numFinished < MAX_FINISHED_PER_UPDATE)
+    {
+        Asset* asset = *iter;
+        if (!asset->isLoading) {
+            // Already finished by a lookup
+            iter = mLoading.erase(iter);
+        } else if (asset->loading.IsDone()) {
+            FinishLoad(*asset);
+            iter = mLoading.erase(iter);
+            numFinished++;
+        } else {
+            ++iter;
+        }
+    }
+
+    // Start the queued ones. Fonts (FreeType isn't thread safe), and
+    // everything when there are no workers, load here a few at a time.
+    const bool hasWorkers = mJobs && mJobs->GetNumWorkers() > 0;
+    int numLoaded = 0;
+    iter = mQueue.begin();
+    while (iter != mQueue.end())
+    {
+        Asset* asset = *iter;
+        const bool loadsHere = !hasWorkers || asset->type == AssetType::Font;
+        if (loadsHere && numLoaded >= MAX_LOADS_PER_UPDATE) {
+            ++iter;
+            continue;
+        }
+
+        iter = mQueue.erase(iter);
+        asset->isQueued = false;
+
+        // Skip scenes no longer prefetched
+        if (asset->isResident || asset->hasFailed || asset->refCount == 0) {
+            continue;
+        }
+
+        if (loadsHere) {
+            LoadNow(*asset);
+            numLoaded++;
+        } else {
+            StartLoad(*asset);
+        }
+    }
+
+    EvictOverBudget();
+}
+
+AssetManager::Asset& AssetManager::FindOrAdd(AssetType type, StringId path)
+{
+    auto iter = mAssets.find(path);
+    if (iter != mAssets.end()) {
+        return *iter->second;
+    }
+
+    auto asset = std::make_unique<Asset>();
+    asset->type = type;
+    asset->path = path.GetString();
+    if (asset->path.empty())
+    {
+        SDL_Log("Asset id %016llx was never interned, it has no path to load",
+                static_cast<unsigned long long>(path.GetHash()));
+        asset->hasFailed = true;
+    }
+    return *mAssets.emplace(path, std::move(asset)).first->second;
+}
+
+AssetManifest& AssetManager::GetManifest(const std::string& sceneName)
+{
+    auto iter = mManifests.find(sceneName);
+    if (iter != mManifests.end()) {
+        return iter->second;
+    }
+
+    AssetManifest manifest;
+
+    // A scene without a manifest still works, its assets are added as it uses them
+    const std::string fileName = "../Assets/Manifests/" + sceneName + ".json";
+    std::ifstream manifestFile(fileName);
+    if (!manifestFile.is_open()) {
+        SDL_Log("No asset manifest found at %s", fileName.c_str());
+    }
+    else
+    {
+        nlohmann::json data = nlohmann::json::parse(manifestFile, nullptr, false);
+        if (data.is_discarded()) {
+            SDL_Log("Failed to parse asset manifest %s", fileName.c_str());
+        } else {
+            // Interns the paths, so the ids can be loaded from
+            auto toIds = [&data](const char* key) {
+                std::vector<StringId> ids;
+                for (const auto& path : data.value(key, std::vector<std::string>())) {
+                    ids.emplace_back(path);
+                }
+                return ids;
+            };
+
+            manifest.textures = toIds("textures");
+            manifest.fonts = toIds("fonts");
+            manifest.sounds = toIds("sounds");
+        }
+    }
+
+    return mManifests.emplace(sceneName, std::move(manifest)).first->second;
+}
+
+std::vector<AssetManager::Asset*> AssetManager::GetAssets(const AssetManifest& manifest)
+{
+    std::vector<Asset*> assets;
+    assets.reserve(manifest.textures.size() + manifest.fonts.size() + manifest.sounds.size());
+
+    for (const auto& path : manifest.textures) {
+        assets.emplace_back(&FindOrAdd(AssetType::Texture, path));
+    }
+
+    for (const auto& path : manifest.fonts) {
+        assets.emplace_back(&FindOrAdd(AssetType::Font, path));
+    }
+
+    for (const auto& path : manifest.sounds) {
+        assets.emplace_back(&FindOrAdd(AssetType::Sound, path));
+    }
+
+    return assets;
+}
+
+void AssetManager::Acquire(const std::string& sceneName, bool prefetch)
+{
+    for (Asset* asset : GetAssets(GetManifest(sceneName)))
+    {
+        asset->refCount++;
+        asset->lastUsed = ++mUseCounter;
+
+        if (!prefetch || asset->isResident || asset->hasFailed || asset->isQueued || asset->isLoading) {
+            continue;
+        }
+
+        // Sprites packed into the atlas are only loaded if asked for by path
+        if (asset->type == AssetType::Texture && mAtlas && mAtlas->Contains(asset->path)) {
+            continue;
+        }
+
+        asset->isQueued = true;
+        mQueue.emplace_back(asset);
+    }
+}
+
+void AssetManager::Release(const std::string& sceneName)
+{
+    // Unheld assets stay cached until the budget runs out
+    for (Asset* asset : GetAssets(GetManifest(sceneName))) {
+        asset->refCount--;
+    }
+}
+
+void AssetManager::LoadNow(Asset& asset)
+{
+    if (asset.isLoading)
+    {
+        mJobs->Wait(asset.loading);
+        FinishLoad(asset);
+        return;
+    }
+
+    if (asset.isQueued)
+    {
+        mQueue.erase(std::find(mQueue.begin(), mQueue.end(), &asset));
+        asset.isQueued = false;
+    }
+
+    if (asset.type == AssetType::Texture)
+    {
+        asset.loadedSurface = IMG_Load(asset.path.c_str());
+        if (!asset.loadedSurface) {
+            SDL_Log("Failed to load image %s: %s", asset.path.c_str(), IMG_GetError());
+        }
+    }
+    else if (asset.type == AssetType::Sound)
+    {
+        asset.loadedSound = Mix_LoadWAV(asset.path.c_str());
+        if (!asset.loadedSound) {
+            SDL_Log("Failed to load sound file %s: %s", asset.path.c_str(), Mix_GetError());
+        }
+    }
+
+    FinishLoad(asset);
+}
+
+void AssetManager::StartLoad(Asset& asset)
+{
+    // Decoding doesn't touch the renderer, the texture is created once the
+    // surface is handed over
+    asset.isLoading = true;
+    mLoading.emplace_back(&asset);
+
+    Asset* loading = &asset;
+    mJobs->Run([loading]() {
+        if (loading->type == AssetType::Texture)
+        {
+            loading->loadedSurface = IMG_Load(loading->path.c_str());
+            if (!loading->loadedSurface) {
+                SDL_Log("Failed to load image %s: %s", loading->path.c_str(), IMG_GetError());
+            }
+        }
+        else
+        {
+            loading->loadedSound = Mix_LoadWAV(loading->path.c_str());
+            if (!loading->loadedSound) {
+                SDL_Log("Failed to load sound file %s: %s", loading->path.c_str(), Mix_GetError());
+            }
+        }
+    }, &asset.loading);
+}
+
+void AssetManager::FinishLoad(Asset& asset)
+{
+    asset.isLoading = false;
+
+    if (asset.type == AssetType::Texture)
+    {
+        SDL_Surface* surface = asset.loadedSurface;
+        asset.loadedSurface = nullptr;
+
+        if (surface)
+        {
+            asset.texture = RenderResources::CreateTexture(surface);
+            if (asset.texture) {
+                asset.bytes = static_cast<size_t>(surface->w) * surface->h * 4;
+            } else {
+                SDL_Log("Failed to create texture for %s: %s", asset.path.c_str(), SDL_GetError());
+            }
+            SDL_FreeSurface(surface);
+        }
+
+        asset.isResident = asset.texture != nullptr;
+    }
+    else if (asset.type == AssetType::Sound)
+    {
+        asset.sound = asset.loadedSound;
+        asset.loadedSound = nullptr;
+
+        if (asset.sound) {
+            asset.bytes = asset.sound->alen;
+        }
+        asset.isResident = asset.sound != nullptr;
+    }
+    else
+    {
+        asset.font = new UIFont(mRenderer);
+        if (asset.font->Load(asset.path))
+        {
+            // Faces are streamed from the file, so its size is a rough estimate
+            std::error_code ec{};
+            uintmax_t fileSize = std::filesystem::file_size(asset.path, ec);
+            asset.bytes = ec ? 0 : static_cast<size_t>(fileSize);
+        }
+        else
+        {
+            asset.font->Unload();
+            delete asset.font;
+            asset.font = nullptr;
+        }
+
+        asset.isResident = asset.font != nullptr;
+    }
+
+    if (!asset.isResident)
+    {
+        asset.hasFailed = true;
+        return;
+    }
+
+    mResidentBytes += asset.bytes;
+    mNumResident[static_cast<int>(asset.type)]++;
+}
+
+void AssetManager::Unload(Asset& asset)
+{
+    if (asset.type == AssetType::Texture)
+    {
+        RenderResources::ReleaseTexture(asset.texture);
+        asset.texture = nullptr;
+    }
+    else if (asset.type == AssetType::Sound)
+    {
+        // Halts the channels still playing it
+        Mix_FreeChunk(asset.sound);
+        asset.sound = nullptr;
+    }
+    else
+    {
+        asset.font->Unload();
+        delete asset.font;
+        asset.font = nullptr;
+    }
+
+    mResidentBytes -= asset.bytes;
+    mNumResident[static_cast<int>(asset.type)]--;
+    asset.bytes = 0;
+    asset.isResident = false;
+}
+
+void AssetManager::EvictOverBudget()
+{
+    if (GetResidentBytes() <= mBudget) {
+        mWarnedOverBudget = false;
+        return;
+    }
+
+    std::vector<Asset*> unheld;
+    for (auto& entry : mAssets)
+    {
+        if (entry.second->isResident && entry.second->refCount == 0) {
+            unheld.emplace_back(entry.second.get());
+        }
+    }
+
+    // Least recently used first
+    std::sort(unheld.begin(), unheld.end(), [](const Asset* a, const Asset* b) {
+        return a->lastUsed < b->lastUsed;
+    });
+
+    for (Asset* asset : unheld)
+    {
+        if (GetResidentBytes() <= mBudget) {
+            break;
+        }
+        Unload(*asset);
+    }
+
+    if (GetResidentBytes() > mBudget && !mWarnedOverBudget)
+    {
+        SDL_Log("Assets held by the current and next scenes take %zu KB, over the %zu KB budget",
+                GetResidentBytes() / 1024, mBudget / 1024);
+        mWarnedOverBudget = true;
+    }
+}
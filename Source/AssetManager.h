@@ -0,0 +1,150 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SDL.h>
+#include "JobSystem.h"
+#include "StringId.h"
+
+enum class AssetType : uint8_t
+{
+    Texture,
+    Font,
+    Sound
+};
+
+// Assets a scene uses, read from Assets/Manifests/<scene>.json. Paths are the
+// ones the game asks for (sounds include the "../Assets/Sounds/" part).
+struct AssetManifest
+{
+    std::vector<StringId> textures;
+    std::vector<StringId> fonts;
+    std::vector<StringId> sounds;
+};
+
+// Owns the textures, fonts and sounds loaded from loose files. Each scene
+// holds a reference to the assets of its manifest while it is current, and
+// the scene that comes next can be prefetched: its assets are held as well
+// and loaded in the background while the current one plays. Assets nobody
+// holds stay cached until the resident memory goes over the budget, then the
+// least recently used ones are evicted. Held assets are never evicted, so the
+// budget is exceeded if the current and next scenes don't fit in it.
+//
+// Used from the simulation thread only. Textures are still created and
+// destroyed through RenderResources.
+class AssetManager
+{
+public:
+    static const size_t DEFAULT_BUDGET = 48 * 1024 * 1024;
+
+    // Background loads handed over per update, creating a texture waits for
+    // the render thread
+    static const int MAX_FINISHED_PER_UPDATE = 4;
+
+    // Without job system workers, files loaded per update instead
+    static const int MAX_LOADS_PER_UPDATE = 1;
+
+    // Sprites packed into the atlas aren't prefetched from their loose files,
+    // the atlas pages count as resident memory for the whole game
+    AssetManager(SDL_Renderer* renderer, class JobSystem* jobs, const class TextureAtlas* atlas,
+                 size_t budget = DEFAULT_BUDGET);
+    ~AssetManager();
+
+    // Cached lookups, loading the file on first use (or waiting for its
+    // prefetch). Failed loads are remembered and not retried. An asset the
+    // current scene uses without listing it in its manifest is added to it,
+    // so it is held until the scene ends. Assets are keyed by the id of their
+    // path, which must have been interned (made from the path string).
+    SDL_Texture* GetTexture(StringId path);
+    class UIFont* GetFont(StringId path);
+    struct Mix_Chunk* GetSound(StringId path);
+
+    // Hold the assets of the scene being loaded and let go of the previous one
+    void BeginScene(const std::string& sceneName);
+
+    // Hold the assets of the scene that comes next and start loading them,
+    // letting go of the previously prefetched scene
+    void Prefetch(const std::string& sceneName);
+
+    // Hand over finished background loads, start queued ones and evict
+    // over budget. Called every frame.
+    void Update();
+
+    size_t GetBudget() const { return mBudget; }
+    size_t GetResidentBytes() const { return mResidentBytes + mPinnedBytes; }
+    int GetNumResident(AssetType type) const { return mNumResident[static_cast<int>(type)]; }
+
+private:
+    struct Asset
+    {
+        AssetType type;
+        std::string path;           // Interned string of the id, to open the file
+
+        SDL_Texture* texture = nullptr;
+        class UIFont* font = nullptr;
+        struct Mix_Chunk* sound = nullptr;
+
+        size_t bytes = 0;
+        int refCount = 0;           // Scenes holding it (current and prefetched)
+        uint64_t lastUsed = 0;
+        uint32_t checkedScene = 0;  // Scene it was last checked against the manifest in
+        bool isResident = false;
+        bool isQueued = false;
+        bool isLoading = false;     // A job owns the fields below until loading is done
+        bool hasFailed = false;
+
+        JobCounter loading;
+        SDL_Surface* loadedSurface = nullptr;
+        struct Mix_Chunk* loadedSound = nullptr;
+    };
+
+    Asset& FindOrAdd(AssetType type, StringId path);
+    AssetManifest& GetManifest(const std::string& sceneName);
+
+    // Entries for the assets of a manifest
+    std::vector<Asset*> GetAssets(const AssetManifest& manifest);
+
+    // Look up an asset for the game: load it now if needed and hold it for
+    // the current scene
+    Asset* Use(AssetType type, StringId path);
+
+    void Acquire(const std::string& sceneName, bool prefetch);
+    void Release(const std::string& sceneName);
+
+    // Load on the calling thread, or finish the background load (waiting for it)
+    void LoadNow(Asset& asset);
+    void StartLoad(Asset& asset);
+    void FinishLoad(Asset& asset);
+
+    void Unload(Asset& asset);
+    void EvictOverBudget();
+
+    SDL_Renderer* mRenderer;
+    class JobSystem* mJobs;
+    const class TextureAtlas* mAtlas;
+
+    size_t mBudget;
+    size_t mResidentBytes;
+    size_t mPinnedBytes;
+    int mNumResident[3];
+    bool mWarnedOverBudget;
+
+    uint64_t mUseCounter;
+    uint32_t mSceneCounter;
+
+    std::string mCurrentScene;
+    std::string mPrefetchScene;
+
+    std::unordered_map<StringId, std::unique_ptr<Asset>> mAssets;
+    std::unordered_map<std::string, AssetManifest> mManifests;
+
+    std::vector<Asset*> mQueue;
+    std::vector<Asset*> mLoading;
+};
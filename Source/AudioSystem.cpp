@@ -1,4 +1,5 @@
 #include "AudioSystem.h"
+#include "AssetManager.h"
 #include "SDL.h"
 #include "SDL_mixer.h"
 #include <filesystem>
@@ -7,22 +8,31 @@ SoundHandle SoundHandle::Invalid;
 
 // Create the AudioSystem with specified number of channels
 // (Defaults to 8 channels)
-AudioSystem::AudioSystem(int numChannels)
+AudioSystem::AudioSystem(AssetManager* assets, int numChannels)
+    :mAssets(assets)
 {
     Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048);
     Mix_AllocateChannels(numChannels);
     mChannels.resize(numChannels);
+
+    // Sounds are played by id, so their names and paths are interned once here
+#ifndef __clang_analyzer__
+	std::error_code ec{};
+	for (const auto& rootDirEntry : std::filesystem::directory_iterator{"../Assets/Sounds", ec})
+	{
+		std::string extension = rootDirEntry.path().extension().string();
+		if (extension == ".ogg" || extension == ".wav")
+		{
+			std::string fileName = rootDirEntry.path().filename().string();
+			mSoundPaths.emplace(StringId(fileName), StringId("../Assets/Sounds/" + fileName));
+		}
+	}
+#endif
 }
 
 // Destroy the AudioSystem
 AudioSystem::~AudioSystem()
 {
-    for (auto& sound : mSounds)
-    {
-        Mix_FreeChunk(sound.second);
-    }
-    mSounds.clear();
-
     Mix_CloseAudio();
 }
 
@@ -45,15 +55,21 @@ void AudioSystem::Update(float deltaTime)
 // Returns the SoundHandle which is used to perform any other actions on the
 // sound when active
 // NOTE: The soundName is without the "Assets/Sounds/" part of the file
-//       For example, pass in "ChompLoop.wav" rather than
-//       "Assets/Sounds/ChompLoop.wav".
-SoundHandle AudioSystem::PlaySound(const std::string& soundName, bool looping)
+//       For example, pass in "ChompLoop.wav"_id rather than
+//       "Assets/Sounds/ChompLoop.wav"_id.
+SoundHandle AudioSystem::PlaySound(StringId soundName, bool looping)
 {
+    if (mIsMuted) {
+        return SoundHandle::Invalid;
+    }
+
     // Get the sound with the given name
     Mix_Chunk *sound = GetSound(soundName);
 
     if (sound == nullptr) {
-        SDL_Log("[AudioSystem] PlaySound couldn't find sound for %s", soundName.c_str());
+        // Ids of names never interned have no string to show
+        SDL_Log("[AudioSystem] PlaySound couldn't find sound for %s (id %016llx)", soundName.GetString().c_str(),
+                static_cast<unsigned long long>(soundName.GetHash()));
         return SoundHandle::Invalid;
     }
 
@@ -70,7 +86,7 @@ SoundHandle AudioSystem::PlaySound(const std::string& soundName, bool looping)
         for(auto &handleMap : mHandleMap) {
             if(handleMap.second.mSoundName == soundName) {
                 availableChannel = handleMap.second.mChannel;
-                SDL_Log("[AudioSystem] PlaySound ran out of channels playing %s! Stopping %s", soundName.c_str(), handleMap.second.mSoundName.c_str());
+                SDL_Log("[AudioSystem] PlaySound ran out of channels playing %s! Stopping %s", soundName.GetString().c_str(), handleMap.second.mSoundName.GetString().c_str());
                 mHandleMap.erase(handleMap.first);
                 break;
             }
@@ -83,14 +99,14 @@ SoundHandle AudioSystem::PlaySound(const std::string& soundName, bool looping)
                 StopSound(handleMap.first);
                 availableChannel = handleMap.second.mChannel;
 
-                SDL_Log("[AudioSystem] PlaySound ran out of channels playing %s! Stopping %s", soundName.c_str(), handleMap.second.mSoundName.c_str());
+                SDL_Log("[AudioSystem] PlaySound ran out of channels playing %s! Stopping %s", soundName.GetString().c_str(), handleMap.second.mSoundName.GetString().c_str());
                 break;
             }
         }
     }
 
     if(availableChannel == -1) {
-        SDL_Log("[AudioSystem] PlaySound ran out of channels playing %s! Stopping %s", soundName.c_str(), mHandleMap.begin()->second.mSoundName.c_str());
+        SDL_Log("[AudioSystem] PlaySound ran out of channels playing %s! Stopping %s", soundName.GetString().c_str(), mHandleMap.begin()->second.mSoundName.GetString().c_str());
 
         StopSound(mHandleMap.begin()->first);
         availableChannel = mHandleMap.begin()->second.mChannel;
@@ -172,6 +188,19 @@ SoundState AudioSystem::GetSoundState(SoundHandle sound)
 	return SoundState::Playing;
 }
 
+// Returns how many sounds are playing (not paused)
+int AudioSystem::GetNumPlayingSounds() const
+{
+    int numPlaying = 0;
+    for (const auto& handle : mHandleMap)
+    {
+        if (!handle.second.mIsPaused) {
+            numPlaying++;
+        }
+    }
+    return numPlaying;
+}
+
 // Stops all sounds on all channels
 void AudioSystem::StopAllSounds()
 {
@@ -188,59 +217,35 @@ void AudioSystem::StopAllSounds()
 // Cache all sounds under Assets/Sounds
 void AudioSystem::CacheAllSounds()
 {
-#ifndef __clang_analyzer__
-	std::error_code ec{};
-	for (const auto& rootDirEntry : std::filesystem::directory_iterator{"Assets/Sounds", ec})
+	for (const auto& sound : mSoundPaths)
 	{
-		std::string extension = rootDirEntry.path().extension().string();
-		if (extension == ".ogg" || extension == ".wav")
-		{
-			std::string fileName = rootDirEntry.path().stem().string();
-			fileName += extension;
-			CacheSound(fileName);
-		}
+		mAssets->GetSound(sound.second);
 	}
-#endif
 }
 
 // Used to preload the sound data of a sound
 // NOTE: The soundName is without the "Assets/Sounds/" part of the file
-//       For example, pass in "ChompLoop.wav" rather than
-//       "Assets/Sounds/ChompLoop.wav".
-void AudioSystem::CacheSound(const std::string& soundName)
+//       For example, pass in "ChompLoop.wav"_id rather than
+//       "Assets/Sounds/ChompLoop.wav"_id.
+void AudioSystem::CacheSound(StringId soundName)
 {
 	GetSound(soundName);
 }
 
-// If the sound is already loaded, returns Mix_Chunk from the map.
-// Otherwise, will attempt to load the file and save it in the map.
+// Returns the Mix_Chunk cached by the asset manager, loading it if needed.
 // Returns nullptr if sound is not found.
 // NOTE: The soundName is without the "Assets/Sounds/" part of the file
-//       For example, pass in "ChompLoop.wav" rather than
-//       "Assets/Sounds/ChompLoop.wav".
-Mix_Chunk* AudioSystem::GetSound(const std::string& soundName)
+//       For example, pass in "ChompLoop.wav"_id rather than
+//       "Assets/Sounds/ChompLoop.wav"_id.
+Mix_Chunk* AudioSystem::GetSound(StringId soundName)
 {
-	std::string fileName = "../Assets/Sounds/";
-	fileName += soundName;
-
-	Mix_Chunk* chunk = nullptr;
-	auto iter = mSounds.find(fileName);
-	if (iter != mSounds.end())
+	auto iter = mSoundPaths.find(soundName);
+	if (iter == mSoundPaths.end())
 	{
-		chunk = iter->second;
+		return nullptr;
 	}
-	else
-	{
-		chunk = Mix_LoadWAV(fileName.c_str());
-		if (!chunk)
-		{
-			SDL_Log("[AudioSystem] Failed to load sound file %s", fileName.c_str());
-			return nullptr;
-		}
 
-		mSounds.emplace(fileName, chunk);
-	}
-	return chunk;
+	return mAssets->GetSound(iter->second);
 }
 
 // Input for debugging purposes
@@ -260,7 +265,7 @@ void AudioSystem::ProcessInput(const Uint8* keyState)
 					HandleInfo& hi = iter->second;
 					SDL_Log("Channel %d: %s, %s, looping = %d, paused = %d",
 							static_cast<unsigned>(i), mChannels[i].GetDebugStr(),
-							hi.mSoundName.c_str(), hi.mIsLooping, hi.mIsPaused);
+							hi.mSoundName.GetString().c_str(), hi.mIsLooping, hi.mIsPaused);
 				}
 				else
 				{
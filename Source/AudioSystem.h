@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include "SDL_stdinc.h"
+#include "StringId.h"
 
 // SoundHandles are used to operate on active sounds
 class SoundHandle
@@ -63,8 +64,9 @@ enum class SoundState
     {
     public:
         // Create the AudioSystem with specified number of channels
-        // (Defaults to 8 channels)
-        AudioSystem(int numChannels = 8);
+        // (Defaults to 8 channels). The sound data is owned by the asset manager.
+        // The names of the files under Assets/Sounds are interned here.
+        AudioSystem(class AssetManager* assets, int numChannels = 8);
         // Destroy the AudioSystem
         ~AudioSystem();
 
@@ -77,9 +79,13 @@ enum class SoundState
         // Returns the SoundHandle which is used to perform any other actions on the
         // sound when active
         // NOTE: The soundName is without the "Assets/Sounds/" part of the file
-        //       For example, pass in "ChompLoop.wav" rather than
-        //       "Assets/Sounds/ChompLoop.wav".
-        SoundHandle PlaySound(const std::string& soundName, bool looping = false);
+        //       For example, pass in "ChompLoop.wav"_id rather than
+        //       "Assets/Sounds/ChompLoop.wav"_id.
+        SoundHandle PlaySound(StringId soundName, bool looping = false);
+
+        // While muted PlaySound does nothing (netplay re-simulating ticks
+        // that were already heard)
+        void SetMuted(bool muted) { mIsMuted = muted; }
 
         // Stops the sound if it is currently playing
         void StopSound(SoundHandle sound);
@@ -93,6 +99,9 @@ enum class SoundState
 	// Returns the current state of the sound
 	SoundState GetSoundState(SoundHandle sound);
 
+	// Returns how many sounds are playing (not paused)
+	int GetNumPlayingSounds() const;
+
 	// Stops all sounds on all channels
 	void StopAllSounds();
 
@@ -101,23 +110,22 @@ enum class SoundState
 
 	// Used to preload the sound data of a sound
 	// NOTE: The soundName is without the "Assets/Sounds/" part of the file
-	//       For example, pass in "ChompLoop.wav" rather than
-	//       "Assets/Sounds/ChompLoop.wav".
-	void CacheSound(const std::string& soundName);
+	//       For example, pass in "ChompLoop.wav"_id rather than
+	//       "Assets/Sounds/ChompLoop.wav"_id.
+	void CacheSound(StringId soundName);
 
 private:
-	// If the sound is already loaded, returns Mix_Chunk from the map.
-	// Otherwise, will attempt to load the file and save it in the map.
+	// Returns the Mix_Chunk cached by the asset manager, loading it if needed.
 	// Returns nullptr if sound is not found.
 	// NOTE: The soundName is without the "Assets/Sounds/" part of the file
-	//       For example, pass in "ChompLoop.wav" rather than
-	//       "Assets/Sounds/ChompLoop.wav".
-	struct Mix_Chunk* GetSound(const std::string& soundName);
+	//       For example, pass in "ChompLoop.wav"_id rather than
+	//       "Assets/Sounds/ChompLoop.wav"_id.
+	struct Mix_Chunk* GetSound(StringId soundName);
 
 	// Internal struct used to track the properties of active sound handles
 	struct HandleInfo
 	{
-		std::string mSoundName;
+		StringId mSoundName;
 		int mChannel = -1;
 		bool mIsLooping = false;
 		bool mIsPaused = false;
@@ -131,8 +139,11 @@ private:
 	// Maps all the active SoundHandles to their HandleInfo
 	std::map<SoundHandle, HandleInfo> mHandleMap;
 
-	// Map to store the Mix_Chunk data for all the files
-	std::unordered_map<std::string, Mix_Chunk*> mSounds;
+	// Caches the Mix_Chunk data of the files (freeing a chunk halts its channels)
+	class AssetManager* mAssets;
+
+	// Path of each file under Assets/Sounds, by name
+	std::unordered_map<StringId, StringId> mSoundPaths;
 
 	// Used to track the last audio handle value used
 	// Will increment prior to playing a new sound
@@ -140,4 +151,6 @@ private:
 
 	// Used for debug input in ProcessInput
 	bool mLastDebugKey = false;
+
+	bool mIsMuted = false;
 };
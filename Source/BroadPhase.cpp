@@ -0,0 +1,116 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "BroadPhase.h"
+#include "SpatialHashing.h"
+#include "SweepAndPrune.h"
+#include "DynamicAABBTree.h"
+#include "Actors/Actor.h"
+#include <algorithm>
+
+BroadPhase::BroadPhase(int cellSize, int width, int height)
+    : mCellSize(cellSize), mWidth(width), mHeight(height)
+{
+}
+
+BroadPhase* BroadPhase::Create(BroadPhaseType type, int cellSize, int width, int height)
+{
+    switch (type)
+    {
+        case BroadPhaseType::SweepAndPrune:
+            return new SweepAndPrune(cellSize, width, height);
+        case BroadPhaseType::AABBTree:
+            return new DynamicAABBTree(cellSize, width, height);
+        default:
+            return new SpatialHashing(cellSize, width, height);
+    }
+}
+
+bool BroadPhase::ParseType(const std::string& name, BroadPhaseType& type)
+{
+    if (name == "grid") {
+        type = BroadPhaseType::Grid;
+    } else if (name == "sap") {
+        type = BroadPhaseType::SweepAndPrune;
+    } else if (name == "tree") {
+        type = BroadPhaseType::AABBTree;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+const char* BroadPhase::GetTypeName(BroadPhaseType type)
+{
+    switch (type)
+    {
+        case BroadPhaseType::SweepAndPrune:
+            return "sap";
+        case BroadPhaseType::AABBTree:
+            return "tree";
+        default:
+            return "grid";
+    }
+}
+
+std::vector<AABBColliderComponent*> BroadPhase::QueryColliders(const Vector2& position, const int range,
+                                                               const uint32_t layerMask) const
+{
+    std::vector<AABBColliderComponent*> results;
+
+    std::vector<Actor*> actors = Query(position, range);
+    for (Actor* actor : actors)
+    {
+        auto collider = actor->GetComponent<AABBColliderComponent>();
+        if (collider && (collider->GetCategory() & layerMask))
+        {
+            results.push_back(collider);
+        }
+    }
+
+    return results;
+}
+
+bool BroadPhase::IsInBounds(const Vector2& position) const
+{
+    int cols = (mWidth + mCellSize - 1) / mCellSize;
+    int rows = (mHeight + mCellSize - 1) / mCellSize;
+
+    int col = static_cast<int>(position.x / mCellSize);
+    int row = static_cast<int>(position.y / mCellSize);
+
+    return col >= 0 && col < cols && row >= 0 && row < rows;
+}
+
+Vector2 BroadPhase::GetIndexPosition(const Vector2& position)
+{
+    return Vector2(std::max(0.0f, position.x), std::max(0.0f, position.y));
+}
+
+bool BroadPhase::GetQueryBounds(const Vector2& position, int range, Vector2& min, Vector2& max) const
+{
+    if (!IsInBounds(position)) {
+        return false;
+    }
+
+    int col = static_cast<int>(position.x / mCellSize);
+    int row = static_cast<int>(position.y / mCellSize);
+
+    min = Vector2(static_cast<float>((col - range) * mCellSize), static_cast<float>((row - range) * mCellSize));
+    max = Vector2(static_cast<float>((col + range + 1) * mCellSize), static_cast<float>((row + range + 1) * mCellSize));
+    return true;
+}
+
+void BroadPhase::GetCameraBounds(const Vector2& cameraPosition, float screenWidth, float screenHeight,
+                                 float extraRadius, Vector2& min, Vector2& max) const
+{
+    int startCol = std::max(0, static_cast<int>((cameraPosition.x - extraRadius) / mCellSize));
+    int startRow = std::max(0, static_cast<int>((cameraPosition.y - extraRadius) / mCellSize));
+    int endCol = static_cast<int>((cameraPosition.x + screenWidth + extraRadius) / mCellSize);
+    int endRow = static_cast<int>((cameraPosition.y + screenHeight + extraRadius) / mCellSize);
+
+    min = Vector2(static_cast<float>(startCol * mCellSize), static_cast<float>(startRow * mCellSize));
+    max = Vector2(static_cast<float>((endCol + 1) * mCellSize), static_cast<float>((endRow + 1) * mCellSize));
+}
@@ -0,0 +1,71 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Math.h"
+
+enum class BroadPhaseType
+{
+    Grid,
+    SweepAndPrune,
+    AABBTree
+};
+
+// Spatial index of the actors in a scene. Actors are indexed by their
+// position, and queries are expressed in cells of cellSize so every backend
+// returns the same actors as the uniform grid.
+//
+// The broad phase owns the actors it holds and deletes them when destroyed.
+class BroadPhase
+{
+public:
+    BroadPhase(int cellSize, int width, int height);
+    virtual ~BroadPhase() = default;
+
+    static BroadPhase* Create(BroadPhaseType type, int cellSize, int width, int height);
+
+    // Names used on the command line: "grid", "sap" and "tree"
+    static bool ParseType(const std::string& name, BroadPhaseType& type);
+    static const char* GetTypeName(BroadPhaseType type);
+
+    virtual void Insert(class Actor* actor) = 0;
+    virtual void Remove(class Actor* actor) = 0;
+    virtual void Reinsert(class Actor* actor) = 0;
+
+    // Actors in the cells within range of the cell containing position
+    virtual std::vector<class Actor*> Query(const Vector2& position, const int range = 1) const = 0;
+
+    // Actors in the cells covered by the camera
+    virtual std::vector<class Actor*> QueryOnCamera(const Vector2& cameraPosition,
+                                                    const float screenWidth,
+                                                    const float screenHeight,
+                                                    const float extraRadius = 0.0f) const = 0;
+
+    // Colliders near position whose layer bit is in layerMask
+    virtual std::vector<class AABBColliderComponent*> QueryColliders(const Vector2& position, const int range = 1,
+                                                                     const uint32_t layerMask = ~0u) const;
+
+protected:
+    bool IsInBounds(const Vector2& position) const;
+
+    // Position an actor is indexed at. Cell indices truncate towards zero,
+    // so actors slightly left of or above the level belong to the first cell.
+    static Vector2 GetIndexPosition(const Vector2& position);
+
+    // Area covered by Query(position, range), as [min, max). Returns false if
+    // position is out of the level.
+    bool GetQueryBounds(const Vector2& position, int range, Vector2& min, Vector2& max) const;
+
+    // Area covered by QueryOnCamera, snapped to whole cells as [min, max)
+    void GetCameraBounds(const Vector2& cameraPosition, float screenWidth, float screenHeight,
+                         float extraRadius, Vector2& min, Vector2& max) const;
+
+    int mCellSize;
+    int mWidth;
+    int mHeight;
+};
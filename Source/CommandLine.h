@@ -0,0 +1,53 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+
+// Number parsing for command line options. Unlike std::stoi, a malformed
+// value is an error instead of an exception, and so is anything after the
+// number or outside the expected range.
+namespace CommandLine
+{
+    // Parse a whole decimal integer in [min, max]
+    inline bool ParseInt(const char* text, int min, int max, int& value)
+    {
+        if (!text || *text == '\0' || std::isspace(static_cast<unsigned char>(*text))) {
+            return false;
+        }
+
+        char* end = nullptr;
+        errno = 0;
+        const long parsed = std::strtol(text, &end, 10);
+        if (errno == ERANGE || *end != '\0' || parsed < min || parsed > max) {
+            return false;
+        }
+
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    // Parse a whole decimal integer that fits in 64 bits, without a sign
+    // (strtoull would wrap negative values around)
+    inline bool ParseUInt64(const char* text, uint64_t& value)
+    {
+        if (!text || !std::isdigit(static_cast<unsigned char>(*text))) {
+            return false;
+        }
+
+        char* end = nullptr;
+        errno = 0;
+        const unsigned long long parsed = std::strtoull(text, &end, 10);
+        if (errno == ERANGE || *end != '\0') {
+            return false;
+        }
+
+        value = static_cast<uint64_t>(parsed);
+        return true;
+    }
+}
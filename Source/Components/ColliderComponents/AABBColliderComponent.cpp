@@ -6,6 +6,8 @@
 #include "../../Actors/Actor.h"
 #include "../../Actors/Mouse.h"
 #include "../../Game.h"
+#include "../../Metrics.h"
+#include "../../Snapshot.h"
 #include <algorithm>
 
 AABBColliderComponent::AABBColliderComponent(class Actor* owner, int dx, int dy, int w, int h,
@@ -16,8 +18,13 @@ AABBColliderComponent::AABBColliderComponent(class Actor* owner, int dx, int dy,
         ,mWidth(w)
         ,mHeight(h)
         ,mLayer(layer)
+        ,mCategory(LayerBit(layer))
+        ,mCollisionMask(CollisionMask(layer))
+        ,mTriggerMask(TriggerMask(layer))
 {
-//    mOwner->GetGame()->AddCollider(this);
+    // The actor was indexed before it had a collider, move it to its layer
+    mOwner->GetGame()->RemoveActor(mOwner);
+    mOwner->GetGame()->AddActor(mOwner);
 }
 
 AABBColliderComponent::~AABBColliderComponent()
@@ -25,6 +32,18 @@ AABBColliderComponent::~AABBColliderComponent()
 //    mOwner->GetGame()->RemoveCollider(this);
 }
 
+void AABBColliderComponent::SaveState(SnapshotWriter& writer) const
+{
+    Component::SaveState(writer);
+    writer.Write(mIsStatic);
+}
+
+void AABBColliderComponent::LoadState(SnapshotReader& reader)
+{
+    Component::LoadState(reader);
+    reader.Read(mIsStatic);
+}
+
 Vector2 AABBColliderComponent::GetMin() const
 {
     return mOwner->GetPosition() + mOffset;
@@ -42,6 +61,8 @@ Vector2 AABBColliderComponent::GetCenter() const
 
 bool AABBColliderComponent::Intersect(const AABBColliderComponent& b) const
 {
+    Metrics::Add(Metric::NarrowPhaseTests);
+
     return (GetMin().x < b.GetMax().x && GetMax().x > b.GetMin().x &&
             GetMin().y < b.GetMax().y && GetMax().y > b.GetMin().y);
 }
@@ -62,95 +83,120 @@ float AABBColliderComponent::GetMinHorizontalOverlap(AABBColliderComponent* b) c
     return (Math::Abs(left) < Math::Abs(right)) ? left : right;
 }
 
-float AABBColliderComponent::DetectHorizontalCollision(RigidBodyComponent *rigidBody)
+Contact AABBColliderComponent::MakeContact(AABBColliderComponent* other, bool isHorizontal) const
 {
-    if (mIsStatic || !mIsEnabled) return false;
+    float minOverlap = isHorizontal ? GetMinHorizontalOverlap(other) : GetMinVerticalOverlap(other);
 
-    // Use spatial hashing to get nearby colliders
-    auto colliders = mOwner->GetGame()->GetNearbyColliders(mOwner->GetPosition());
-    bool isPlayer = mOwner->GetComponent<AABBColliderComponent>()->GetLayer() == ColliderLayer::Player;
+    // Resolution moves the collider by -minOverlap
+    Vector2 normal = isHorizontal ? Vector2::UnitX : Vector2::UnitY;
+    normal = minOverlap > 0.0f ? normal * -1.0f : normal;
 
-    if(isPlayer) {
-        Mouse* marioOwner = dynamic_cast<Mouse*>(mOwner);
-        marioOwner->SetIsOnWall(false);
-    }
+    return {other, normal, Math::Abs(minOverlap), minOverlap};
+}
 
-    std::sort(colliders.begin(), colliders.end(), [this](AABBColliderComponent* a, AABBColliderComponent* b) {
-        return Math::Abs((a->GetCenter() - GetCenter()).LengthSq() < (b->GetCenter() - GetCenter()).LengthSq());
-    });
+std::vector<AABBColliderComponent*> AABBColliderComponent::QueryCandidates() const
+{
+    if (mIsStatic || !mIsEnabled) return {};
+
+    // Only the layers this collider interacts with are fetched
+    return mOwner->GetGame()->GetNearbyColliders(mOwner->GetPosition(), Game::COLLIDER_QUERY_RANGE,
+                                                 mCollisionMask | mTriggerMask);
+}
+
+float AABBColliderComponent::ResolveContacts(const std::vector<AABBColliderComponent*>& candidates,
+                                             RigidBodyComponent *rigidBody, bool isHorizontal,
+                                             std::vector<CollisionEvent>& events)
+{
+    if (mIsStatic || !mIsEnabled) return 0.0f;
+
+    if (mLayer == ColliderLayer::Player && isHorizontal) {
+        // Set again by Mouse's contact events while touching a wall
+        Mouse* mouseOwner = dynamic_cast<Mouse*>(mOwner);
+        if (mouseOwner) {
+            mouseOwner->SetIsOnWall(false);
+        }
+    }
 
-    for (auto& collider : colliders)
+    std::vector<Contact> contacts;
+    for (auto collider : candidates)
     {
-        if (collider == this || !collider->IsEnabled()) continue;
+        if (collider == this || !collider->IsEnabled() || !Intersect(*collider)) continue;
 
-        if (ColliderIgnoreMap.at(mLayer).find(collider->GetLayer()) != ColliderIgnoreMap.at(mLayer).end())
+        // Triggers are reported but not resolved
+        if (collider->mCategory & mTriggerMask)
         {
-            if(isPlayer && (collider->GetLayer() == ColliderLayer::Collectable || collider->GetLayer() == ColliderLayer::Exit)  && Intersect(*collider)) {
-                float minHorizontalOverlap = GetMinHorizontalOverlap(collider);
-                mOwner->OnHorizontalCollision(minHorizontalOverlap, collider);
-            }
+            events.push_back({mOwner, collider, Vector2::Zero});
             continue;
         }
 
-        if (Intersect(*collider))
-        {
-            float minHorizontalOverlap = GetMinHorizontalOverlap(collider);
-            ResolveHorizontalCollisions(rigidBody, minHorizontalOverlap);
-
-            if(isPlayer) {
-                Mouse* marioOwner = dynamic_cast<Mouse*>(mOwner);
-                if (marioOwner && collider->GetLayer() == ColliderLayer::Blocks) {
-                    marioOwner->SetIsOnWall(true);
-                    marioOwner->SetWallSide(minHorizontalOverlap < 0.0f);
-                }
-            }
-
-            mOwner->OnHorizontalCollision(minHorizontalOverlap, collider);
-            return minHorizontalOverlap;
+        contacts.emplace_back(MakeContact(collider, isHorizontal));
+    }
+
+    std::stable_sort(contacts.begin(), contacts.end(), [](const Contact& a, const Contact& b) {
+        return a.depth > b.depth;
+    });
+
+    float resolvedOverlap = 0.0f;
+    for (const auto& contact : contacts)
+    {
+        // Pushing out of a deeper contact may already have separated this one
+        if (!Intersect(*contact.other)) continue;
+
+        Contact current = MakeContact(contact.other, isHorizontal);
+        if (isHorizontal) {
+            ResolveHorizontalCollisions(rigidBody, current.minOverlap);
+        } else {
+            ResolveVerticalCollisions(rigidBody, current.minOverlap);
         }
+
+        events.push_back({mOwner, current.other, current.normal});
+        resolvedOverlap = current.minOverlap;
     }
 
-    return 0.0f;
+    return resolvedOverlap;
 }
 
-float AABBColliderComponent::DetectVertialCollision(RigidBodyComponent *rigidBody)
+float AABBColliderComponent::SweepBlocks(const std::vector<AABBColliderComponent*>& candidates,
+                                         float displacement, bool isHorizontal) const
 {
-    if (mIsStatic || !mIsEnabled) return false;
+    // How far past the contact point the collider is left
+    const float CONTACT_PENETRATION = 0.1f;
 
-    // Use spatial hashing to get nearby colliders
-    auto colliders = mOwner->GetGame()->GetNearbyColliders(mOwner->GetPosition());
-    bool isPlayer = mOwner->GetComponent<AABBColliderComponent>()->GetLayer() == ColliderLayer::Player;
+    if (mIsStatic || !mIsEnabled || displacement == 0.0f) return displacement;
 
-    std::sort(colliders.begin(), colliders.end(), [this](AABBColliderComponent* a, AABBColliderComponent* b) {
-        return Math::Abs((a->GetCenter() - GetCenter()).LengthSq() < (b->GetCenter() - GetCenter()).LengthSq());
-    });
+    if (!(mCollisionMask & LayerBit(ColliderLayer::Blocks))) return displacement;
 
-    for (auto& collider : colliders)
+    const Vector2 min = GetMin();
+    const Vector2 max = GetMax();
+    float distance = Math::Abs(displacement);
+
+    for (auto collider : candidates)
     {
-        if (collider == this || !collider->IsEnabled()) continue;
+        if (collider == this || !collider->IsEnabled() || collider->GetLayer() != ColliderLayer::Blocks) continue;
+
+        const Vector2 otherMin = collider->GetMin();
+        const Vector2 otherMax = collider->GetMax();
 
-        // Check if the collider is in the same layer or if it should be ignored
-        if (ColliderIgnoreMap.at(mLayer).find(collider->GetLayer()) != ColliderIgnoreMap.at(mLayer).end())
+        // Gap to the block along the axis of motion, if it lies in the path
+        float gap;
+        if (isHorizontal)
         {
-            if(isPlayer && (collider->GetLayer() == ColliderLayer::Collectable || collider->GetLayer() == ColliderLayer::Exit)  && Intersect(*collider)) {
-                float minHorizontalOverlap = GetMinHorizontalOverlap(collider);
-                mOwner->OnHorizontalCollision(minHorizontalOverlap, collider);
-            }
-            continue; // Ignore this collider
+            if (min.y >= otherMax.y || max.y <= otherMin.y) continue;
+            gap = displacement > 0.0f ? otherMin.x - max.x : min.x - otherMax.x;
         }
-
-        if (Intersect(*collider))
+        else
         {
-            float minVerticalOverlap = GetMinVerticalOverlap(collider);
-            ResolveVerticalCollisions(rigidBody, minVerticalOverlap);
-
-            // Callback only for closest (first) collision
-            mOwner->OnVerticalCollision(minVerticalOverlap, collider);
-            return minVerticalOverlap;
+            if (min.x >= otherMax.x || max.x <= otherMin.x) continue;
+            gap = displacement > 0.0f ? otherMin.y - max.y : min.y - otherMax.y;
         }
+
+        // Blocks behind us or already overlapping are left to the discrete pass
+        if (gap < 0.0f) continue;
+
+        distance = Math::Min(distance, gap + CONTACT_PENETRATION);
     }
 
-    return 0.0f;
+    return displacement > 0.0f ? distance : -distance;
 }
 
 void AABBColliderComponent::ResolveHorizontalCollisions(RigidBodyComponent *rigidBody, const float minXOverlap)
@@ -6,9 +6,8 @@
 #include "../Component.h"
 #include "../../Math.h"
 #include "../RigidBodyComponent.h"
+#include <cstdint>
 #include <vector>
-#include <map>
-#include <set>
 
 enum class ColliderLayer
 {
@@ -19,27 +18,79 @@ enum class ColliderLayer
     Exit
 };
 
+const int NUM_COLLIDER_LAYERS = 5;
+
+// Category bit of a layer, used in collision and query masks
+constexpr uint32_t LayerBit(ColliderLayer layer)
+{
+    return 1u << static_cast<uint32_t>(layer);
+}
+
+constexpr uint32_t ALL_COLLIDER_LAYERS = (1u << NUM_COLLIDER_LAYERS) - 1;
+
+// Layers a layer collides with (overlaps are resolved)
+constexpr uint32_t CollisionMask(ColliderLayer layer)
+{
+    switch (layer)
+    {
+        case ColliderLayer::Player:
+            return LayerBit(ColliderLayer::Enemy) | LayerBit(ColliderLayer::Blocks);
+        case ColliderLayer::Blocks:
+            return ALL_COLLIDER_LAYERS & ~LayerBit(ColliderLayer::Blocks);
+        case ColliderLayer::Collectable:
+            return ALL_COLLIDER_LAYERS & ~LayerBit(ColliderLayer::Player);
+        default:
+            return ALL_COLLIDER_LAYERS;
+    }
+}
+
+// Layers a layer only reports overlaps with, without resolving them
+constexpr uint32_t TriggerMask(ColliderLayer layer)
+{
+    return layer == ColliderLayer::Player ? LayerBit(ColliderLayer::Collectable) | LayerBit(ColliderLayer::Exit) : 0u;
+}
+
+// Overlap of a moving collider with another one along the axis it moved on
+struct Contact
+{
+    class AABBColliderComponent* other;
+    Vector2 normal;     // Direction the moving collider is pushed out along
+    float depth;        // Penetration along the normal
+    float minOverlap;   // Signed overlap along the axis
+};
+
+// A collision found while resolving a body. Game turns them into the owner's
+// OnCollisionBegin/Stay/End once every body of the step has moved.
+struct CollisionEvent
+{
+    class Actor* actor;
+    class AABBColliderComponent* other;
+    Vector2 normal;     // Direction the actor was pushed out along, zero for triggers
+};
+
 class AABBColliderComponent : public Component
 {
 public:
-    // Collider ignore map
-    const std::map<ColliderLayer, const std::set<ColliderLayer>> ColliderIgnoreMap = {
-        {ColliderLayer::Player, {ColliderLayer::Player, ColliderLayer::Collectable, ColliderLayer::Exit}},
-        {ColliderLayer::Enemy,  {}},
-        {ColliderLayer::Blocks, {ColliderLayer::Blocks}},
-        {ColliderLayer::Collectable,  {ColliderLayer::Player}},
-        {ColliderLayer::Exit,  {}},
-    };
-
     AABBColliderComponent(class Actor* owner, int dx, int dy, int w, int h,
                                 ColliderLayer layer, bool isStatic = false, int updateOrder = 10);
     ~AABBColliderComponent() override;
 
     bool Intersect(const AABBColliderComponent& b) const;
 
-    float DetectHorizontalCollision(RigidBodyComponent *rigidBody);
-    float DetectVertialCollision(RigidBodyComponent *rigidBody);
-    bool DetectHorizontalCollisionWithBlocks(RigidBodyComponent *rigidBody);
+    // Colliders this one can touch during a step: one broad phase query per
+    // body, shared by the sweeps and both axis passes
+    std::vector<AABBColliderComponent*> QueryCandidates() const;
+
+    // Clamp a move along one axis so the collider stops at the first block in
+    // its way, slightly inside it so ResolveContacts still resolves the
+    // contact and reports it. Keeps fast bodies from tunneling.
+    float SweepBlocks(const std::vector<AABBColliderComponent*>& candidates, float displacement, bool isHorizontal) const;
+
+    // Push the collider out of the candidates it overlaps after moving along
+    // one axis, deepest contact first. Every contact and trigger touched is
+    // queued into events. Returns the last resolved overlap.
+    float ResolveContacts(const std::vector<AABBColliderComponent*>& candidates, RigidBodyComponent *rigidBody,
+                          bool isHorizontal, std::vector<CollisionEvent>& events);
 
     void SetStatic(bool isStatic) { mIsStatic = isStatic; }
 
@@ -47,12 +98,18 @@ public:
     Vector2 GetMax() const;
     Vector2 GetCenter() const;
     ColliderLayer GetLayer() const { return mLayer; }
+    uint32_t GetCategory() const { return mCategory; }
     int GetHeight() const { return mHeight; }
 
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
+
 private:
     float GetMinVerticalOverlap(AABBColliderComponent* b) const;
     float GetMinHorizontalOverlap(AABBColliderComponent* b) const;
 
+    Contact MakeContact(AABBColliderComponent* other, bool isHorizontal) const;
+
     void ResolveHorizontalCollisions(RigidBodyComponent *rigidBody, const float minOverlap);
     void ResolveVerticalCollisions(RigidBodyComponent *rigidBody, const float minOverlap);
 
@@ -62,4 +119,7 @@ private:
     bool mIsStatic;
 
     ColliderLayer mLayer;
+    uint32_t mCategory;
+    uint32_t mCollisionMask;
+    uint32_t mTriggerMask;
 };
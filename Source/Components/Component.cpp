@@ -8,6 +8,7 @@
 
 #include "Component.h"
 #include "../Actors/Actor.h"
+#include "../Snapshot.h"
 
 Component::Component(Actor* owner, int updateOrder)
           :mOwner(owner)
@@ -26,12 +27,14 @@ void Component::Update(float deltaTime)
 {
 }
 
-void Component::ProcessInput(const Uint8* keyState)
+void Component::SaveState(SnapshotWriter& writer) const
 {
+    writer.Write(mIsEnabled);
 }
 
-void Component::HandleKeyPress(const int key, bool isPressed)
+void Component::LoadState(SnapshotReader& reader)
 {
+    reader.Read(mIsEnabled);
 }
 
 class Game* Component::GetGame() const
@@ -8,6 +8,7 @@
 
 #pragma once
 #include <SDL_stdinc.h>
+#include "../SceneArena.h"
 
 class Component
 {
@@ -17,12 +18,12 @@ public:
     explicit Component(class Actor* owner, int updateOrder = 100);
     // Destructor
     virtual ~Component();
+
+    // Components are allocated from the current scene arena
+    static void* operator new(size_t size) { return SceneArena::AllocateObject(size); }
+    static void operator delete(void* ptr) { SceneArena::FreeObject(ptr); }
     // Reinsert this component by delta time
     virtual void Update(float deltaTime);
-    // Process input for this component (if needed)
-    virtual void ProcessInput(const Uint8* keyState);
-    // Handle key press for this component (if needed)
-    virtual void HandleKeyPress(const int key, const bool isPressed);
 
     int GetUpdateOrder() const { return mUpdateOrder; }
     class Actor* GetOwner() const { return mOwner; }
@@ -31,6 +32,10 @@ public:
     void SetEnabled(const bool enabled) { mIsEnabled = enabled; };
     bool IsEnabled() const { return mIsEnabled; };
 
+    // World snapshots: state that changes while playing (see Actor::SaveState)
+    virtual void SaveState(class SnapshotWriter& writer) const;
+    virtual void LoadState(class SnapshotReader& reader);
+
 protected:
     // Owning actor
     class Actor* mOwner;
@@ -4,53 +4,65 @@
 
 #include "DrawAnimatedComponent.h"
 #include "../../Actors/Actor.h"
+#include "../../Animation.h"
 #include "../../Game.h"
-#include "../../Json.h"
-#include <fstream>
-
-DrawAnimatedComponent::DrawAnimatedComponent(class Actor* owner, const std::string &spriteSheetPath, const std::string &spriteSheetData, int drawOrder)
-        :DrawSpriteComponent(owner, spriteSheetPath, 0, 0, drawOrder)
+#include "../../RenderFrame.h"
+#include "../../Snapshot.h"
+#include "../../TextureAtlas.h"
+
+DrawAnimatedComponent::DrawAnimatedComponent(class Actor* owner, const std::string &spriteSheetPath, const std::string &spriteSheetData,
+                                             const std::string &animationSetPath, int drawOrder)
+        :DrawSpriteComponent(owner, "", 0, 0, drawOrder)
+        ,mAnimationSystem(owner->GetGame()->GetAnimationSystem())
 {
     LoadSpriteSheet(spriteSheetPath, spriteSheetData);
+
+    mAnimationSet = mAnimationSystem->GetSet(animationSetPath);
+    mPlayhead = mAnimationSystem->AllocatePlayhead();
 }
 
 DrawAnimatedComponent::~DrawAnimatedComponent()
 {
-    DrawSpriteComponent::~DrawSpriteComponent();
+    mAnimationSystem->FreePlayhead(mPlayhead);
 
-    for (const auto& rect : mSpriteSheetData)
-    {
-        delete rect;
-    }
-    mSpriteSheetData.clear();
+    DrawSpriteComponent::~DrawSpriteComponent();
 }
 
 void DrawAnimatedComponent::LoadSpriteSheet(const std::string& texturePath, const std::string& dataPath)
 {
-    // Load sprite sheet texture
-    mSpriteSheetSurface = mOwner->GetGame()->LoadTexture(texturePath);
+    ReleaseTexture();
 
-    // Load sprite sheet data
-    std::ifstream spriteSheetFile(dataPath);
-    nlohmann::json spriteSheetData = nlohmann::json::parse(spriteSheetFile);
+    // Sheets packed into the sprite atlas already know their frames
+    mAtlasFrames = mOwner->GetGame()->GetAtlas()->FindSheet(texturePath);
+    if (mAtlasFrames)
+    {
+        mSheetFrames = nullptr;
+        mSpriteSheetSurface = mAtlasFrames->empty() ? nullptr : (*mAtlasFrames)[0].texture;
+        return;
+    }
 
-    SDL_Rect* rect = nullptr;
-    for(const auto& frame : spriteSheetData["frames"]) {
+    // Loose sheets go through the game's caches, so respawning an actor
+    // doesn't load the texture or parse the frame data again
+    mSpriteSheetSurface = mOwner->GetGame()->GetTexture(texturePath);
+    mSheetFrames = &mOwner->GetGame()->GetSpriteSheetFrames(dataPath);
+}
 
-        int x = frame["frame"]["x"].get<int>();
-        int y = frame["frame"]["y"].get<int>();
-        int w = frame["frame"]["w"].get<int>();
-        int h = frame["frame"]["h"].get<int>();
-        rect = new SDL_Rect({x, y, w, h});
+bool DrawAnimatedComponent::GetFrame(int& spriteIdx, SDL_Rect& dstRect) const
+{
+    const AnimationPlayhead& playhead = mAnimationSystem->GetPlayhead(mPlayhead);
+    if (!playhead.clip) {
+        return false;
+    }
+
+    spriteIdx = playhead.clip->sprites[playhead.frame];
 
-        mSpriteSheetData.emplace_back(rect);
+    // Sheet data missing or failed to load
+    const size_t numSprites = mAtlasFrames ? mAtlasFrames->size() : mSheetFrames->size();
+    if (spriteIdx >= static_cast<int>(numSprites)) {
+        return false;
     }
-}
 
-void DrawAnimatedComponent::Draw(SDL_Renderer* renderer, const Vector3 &modColor)
-{
-    int spriteIdx = mAnimations[mAnimName][static_cast<int>(mAnimTimer)];
-    SDL_Rect* srcRect = mSpriteSheetData[spriteIdx];
+    const SDL_Rect* srcRect = mAtlasFrames ? &(*mAtlasFrames)[spriteIdx].rect : &(*mSheetFrames)[spriteIdx];
 
     int colliderHeight = srcRect->h;
     auto collider = mOwner->GetComponent<AABBColliderComponent>();
@@ -59,60 +71,98 @@ void DrawAnimatedComponent::Draw(SDL_Renderer* renderer, const Vector3 &modColor
     }
     int yOffset = srcRect->h - colliderHeight;
 
-    SDL_Rect dstRect = {
+    dstRect = {
         static_cast<int>(mOwner->GetPosition().x - mOwner->GetGame()->GetCameraPos().x),
         static_cast<int>(mOwner->GetPosition().y - mOwner->GetGame()->GetCameraPos().y) - yOffset,
         srcRect->w,
         srcRect->h
     };
+    return true;
+}
+
+DrawState DrawAnimatedComponent::GetDrawState() const
+{
+    int spriteIdx = 0;
+    SDL_Rect dstRect;
+    if (!GetFrame(spriteIdx, dstRect)) {
+        return DrawComponent::GetDrawState();
+    }
+
+    const float rotation = mOwner->GetRotation();
+    if (mAtlasFrames) {
+        const AtlasRegion& region = (*mAtlasFrames)[spriteIdx];
+        return {GetRotatedBounds(dstRect, rotation), region.texture, region.rect, rotation};
+    }
+    return {GetRotatedBounds(dstRect, rotation), mSpriteSheetSurface, (*mSheetFrames)[spriteIdx], rotation};
+}
+
+void DrawAnimatedComponent::Draw(RenderFrame& frame, const Vector3 &modColor)
+{
+    int spriteIdx = 0;
+    SDL_Rect dstRect;
+    if (!GetFrame(spriteIdx, dstRect)) {
+        return;
+    }
+
+    const SDL_Rect* srcRect = mAtlasFrames ? &(*mAtlasFrames)[spriteIdx].rect : &(*mSheetFrames)[spriteIdx];
+
+    // Frames of an atlas sheet may be spread over several pages
+    if (mAtlasFrames) {
+        mSpriteSheetSurface = (*mAtlasFrames)[spriteIdx].texture;
+    }
 
     SDL_RendererFlip flip = SDL_FLIP_NONE;
     if (mOwner->GetRotation() == Math::Pi) {
         flip = SDL_FLIP_HORIZONTAL;
     }
 
-    SDL_SetTextureBlendMode(mSpriteSheetSurface, SDL_BLENDMODE_BLEND);
-    SDL_SetTextureColorMod(mSpriteSheetSurface,
-                           static_cast<Uint8>(modColor.x),
-                           static_cast<Uint8>(modColor.y),
-                           static_cast<Uint8>(modColor.z));
+    SDL_Color color = {static_cast<Uint8>(modColor.x), static_cast<Uint8>(modColor.y),
+                       static_cast<Uint8>(modColor.z), 255};
+    frame.Copy(mSpriteSheetSurface, srcRect, dstRect, mOwner->GetRotation(), flip, color);
+}
+
+void DrawAnimatedComponent::SaveState(SnapshotWriter& writer) const
+{
+    DrawSpriteComponent::SaveState(writer);
 
-    SDL_RenderCopyEx(renderer, mSpriteSheetSurface, srcRect, &dstRect, mOwner->GetRotation(), nullptr, flip);
+    const AnimationPlayhead& playhead = mAnimationSystem->GetPlayhead(mPlayhead);
+    writer.Write(playhead.clip ? playhead.clip->name.GetHash() : uint64_t(0));
+    writer.Write(playhead.time);
+    writer.Write(playhead.frame);
+    writer.Write(playhead.isPaused);
 }
 
-void DrawAnimatedComponent::Update(float deltaTime)
+void DrawAnimatedComponent::LoadState(SnapshotReader& reader)
 {
-    if (mIsPaused) {
-        return;
-    }
+    DrawSpriteComponent::LoadState(reader);
+
+    AnimationPlayhead& playhead = mAnimationSystem->GetPlayhead(mPlayhead);
+    playhead.clip = mAnimationSet->FindClip(StringId(reader.Read<uint64_t>()));
+    reader.Read(playhead.time);
+    reader.Read(playhead.frame);
+    reader.Read(playhead.isPaused);
 
-    mAnimTimer += mAnimFPS * deltaTime;
-    if (mAnimTimer >= mAnimations[mAnimName].size()) {
-        while (mAnimTimer >= mAnimations[mAnimName].size()) {
-            mAnimTimer -= mAnimations[mAnimName].size();
-        }
+    if (playhead.clip && playhead.frame >= playhead.clip->sprites.size()) {
+        playhead.frame = 0;
     }
 }
 
-void DrawAnimatedComponent::SetAnimation(const std::string& name)
+void DrawAnimatedComponent::SetAnimation(StringId name)
 {
-    mAnimName = name;
-    Update(0.0f);
+    const AnimationPlayhead& playhead = mAnimationSystem->GetPlayhead(mPlayhead);
+    if (playhead.clip && playhead.clip->name == name) {
+        return;
+    }
+
+    mAnimationSystem->Play(mPlayhead, mAnimationSet->FindClip(name));
 }
 
-void DrawAnimatedComponent::AddAnimation(const std::string& name, const std::vector<int>& spriteNums)
+void DrawAnimatedComponent::SetIsPaused(bool pause)
 {
-    mAnimations.emplace(name, spriteNums);
+    mAnimationSystem->GetPlayhead(mPlayhead).isPaused = pause;
 }
 
 void DrawAnimatedComponent::ChangeSpriteSheet(const std::string& spriteSheetPath, const std::string& spriteSheetData)
 {
-    for (const auto& rect : mSpriteSheetData)
-    {
-        delete rect;
-    }
-    mSpriteSheetData.clear();
-
     LoadSpriteSheet(spriteSheetPath, spriteSheetData);
 }
-
@@ -5,50 +5,48 @@
 #pragma once
 
 #include "DrawSpriteComponent.h"
-#include <unordered_map>
+#include "../../StringId.h"
+#include <vector>
 
 class DrawAnimatedComponent : public DrawSpriteComponent {
 public:
-    // (Lower draw order corresponds with further back)
-    DrawAnimatedComponent(class Actor* owner, const std::string &spriteSheetPath, const std::string &spriteSheetData, int drawOrder = 100);
+    // (Lower draw order corresponds with further back). The clips come from
+    // the animation set file, shared by every instance using it.
+    DrawAnimatedComponent(class Actor* owner, const std::string &spriteSheetPath, const std::string &spriteSheetData,
+                          const std::string &animationSetPath, int drawOrder = 100);
     ~DrawAnimatedComponent() override;
 
-    void Draw(SDL_Renderer* renderer, const Vector3 &modColor = Color::White) override;
-    void Update(float deltaTime) override;
+    void Draw(class RenderFrame& frame, const Vector3 &modColor = Color::White) override;
+    DrawState GetDrawState() const override;
 
-    // Use to change the FPS of the animation
-    void SetAnimFPS(float fps) { mAnimFPS = fps; }
-
-    // Set the current active animation
-    void SetAnimation(const std::string& name);
+    // Set the current active animation (e.g. "run"_id), restarting it when
+    // it changes. The playhead is advanced by the game's animation system.
+    void SetAnimation(StringId name);
 
     // Use to pause/unpause the animation
-    void SetIsPaused(bool pause) { mIsPaused = pause; }
-
-    // Add an animation of the corresponding name to the animation map
-    void AddAnimation(const std::string& name, const std::vector<int>& images);
+    void SetIsPaused(bool pause);
 
     // Add this method to allow changing the sprite sheet at runtime
     void ChangeSpriteSheet(const std::string& spriteSheetPath, const std::string& spriteSheetData);
 
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
+
 private:
     void LoadSpriteSheet(const std::string& texturePath, const std::string& dataPath);
 
-    // Vector of sprites
-    std::vector<SDL_Rect*> mSpriteSheetData;
-
-    // Map of animation name to vector of textures corresponding to the animation
-    std::unordered_map<std::string, std::vector<int>> mAnimations;
-
-    // Name of current animation
-    std::string mAnimName;
-
-    // Tracks current elapsed time in animation
-    float mAnimTimer = 0.0f;
+    // Sprite of the current animation frame and where it goes on screen
+    // (false if the sheet has no such sprite)
+    bool GetFrame(int& spriteIdx, SDL_Rect& dstRect) const;
 
-    // The frames per second the animation should run at
-    float mAnimFPS = 10.0f;
+    // Sprites of the sheet, shared with every instance using it: atlas
+    // regions when the sheet is packed, otherwise the game's parsed frames
+    const std::vector<struct AtlasRegion>* mAtlasFrames = nullptr;
+    const std::vector<SDL_Rect>* mSheetFrames = nullptr;
 
-    // Whether or not the animation is paused (defaults to false)
-    bool mIsPaused = false;
+    // Clips of the archetype and this instance's playhead in the game's
+    // animation system
+    const class AnimationSet* mAnimationSet;
+    class AnimationSystem* mAnimationSystem;
+    uint32_t mPlayhead;
 };
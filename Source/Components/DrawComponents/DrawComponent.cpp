@@ -5,6 +5,7 @@
 #include "DrawComponent.h"
 #include "../../Actors/Actor.h"
 #include "../../Game.h"
+#include "../../Snapshot.h"
 
 DrawComponent::DrawComponent(class Actor* owner, int drawOrder)
     :Component(owner)
@@ -20,7 +21,35 @@ DrawComponent::~DrawComponent()
 }
 
 
-void DrawComponent::Draw(SDL_Renderer* renderer, const Vector3 &modColor)
+void DrawComponent::Draw(RenderFrame& frame, const Vector3 &modColor)
 {
 
-}
\ No newline at end of file
+}
+
+DrawState DrawComponent::GetDrawState() const
+{
+    return {{0, 0, 0, 0}, nullptr, {0, 0, 0, 0}, 0.0f};
+}
+
+SDL_Rect DrawComponent::GetRotatedBounds(const SDL_Rect& rect, float rotation)
+{
+    if (rotation == 0.0f) {
+        return rect;
+    }
+
+    // Any rotation fits in the circle through the corners
+    int diagonal = static_cast<int>(Math::Sqrt(static_cast<float>(rect.w * rect.w + rect.h * rect.h))) + 2;
+    return {rect.x + rect.w / 2 - diagonal / 2, rect.y + rect.h / 2 - diagonal / 2, diagonal, diagonal};
+}
+
+void DrawComponent::SaveState(SnapshotWriter& writer) const
+{
+    Component::SaveState(writer);
+    writer.Write(mIsVisible);
+}
+
+void DrawComponent::LoadState(SnapshotReader& reader)
+{
+    Component::LoadState(reader);
+    reader.Read(mIsVisible);
+}
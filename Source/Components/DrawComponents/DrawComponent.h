@@ -6,6 +6,7 @@
 #include "../Component.h"
 #include "../../Math.h"
 #include <vector>
+#include "../../DirtyRegions.h"
 #include <SDL.h>
 
 class DrawComponent : public Component
@@ -15,14 +16,26 @@ public:
     explicit DrawComponent(class Actor* owner, int drawOrder = 100);
     ~DrawComponent() override;
 
-    virtual void Draw(SDL_Renderer* renderer, const Vector3 &modColor = Color::White);
+    // Record the draw calls into the frame
+    virtual void Draw(class RenderFrame& frame, const Vector3 &modColor = Color::White);
 
     bool IsVisible() const { return mIsVisible; }
     void SetIsVisible(const bool isVisible) { mIsVisible = isVisible; }
 
     int GetDrawOrder() const { return mDrawOrder; }
 
+    // Texture bound when drawing (used to group draws sharing an atlas page)
+    virtual SDL_Texture* GetTexture() const { return nullptr; }
+
+    virtual DrawState GetDrawState() const;
+
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
+
 protected:
+    // Bounds of a rect once SDL_RenderCopyEx rotates it about its center
+    static SDL_Rect GetRotatedBounds(const SDL_Rect& rect, float rotation);
+
     bool mIsVisible;
     int mDrawOrder;
 };
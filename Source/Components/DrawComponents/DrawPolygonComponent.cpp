@@ -5,6 +5,7 @@
 #include "DrawPolygonComponent.h"
 #include "../../Actors/Actor.h"
 #include "../../Game.h"
+#include "../../RenderFrame.h"
 
 DrawPolygonComponent::DrawPolygonComponent(class Actor* owner, std::vector<Vector2> &vertices, int drawOrder)
         :DrawComponent(owner)
@@ -13,25 +14,48 @@ DrawPolygonComponent::DrawPolygonComponent(class Actor* owner, std::vector<Vecto
 {
 }
 
-void DrawPolygonComponent::Draw(SDL_Renderer *renderer, const Vector3 &modColor)
+DrawState DrawPolygonComponent::GetDrawState() const
 {
-    // Set draw color to green
-    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
+    if (mVertices.empty()) {
+        return DrawComponent::GetDrawState();
+    }
+
+    Vector2 min = mVertices[0];
+    Vector2 max = mVertices[0];
+    for (const auto& vertex : mVertices)
+    {
+        min.x = Math::Min(min.x, vertex.x);
+        min.y = Math::Min(min.y, vertex.y);
+        max.x = Math::Max(max.x, vertex.x);
+        max.y = Math::Max(max.y, vertex.y);
+    }
+
+    // Lines are drawn on the pixels at the vertices, so one more on each side
+    Vector2 origin = mOwner->GetPosition() - mOwner->GetGame()->GetCameraPos();
+    SDL_Rect bounds = {static_cast<int>(origin.x + min.x) - 1, static_cast<int>(origin.y + min.y) - 1,
+                       static_cast<int>(max.x - min.x) + 3, static_cast<int>(max.y - min.y) + 3};
+    return {bounds, nullptr, {0, 0, 0, 0}, 0.0f};
+}
+
+void DrawPolygonComponent::Draw(RenderFrame& frame, const Vector3 &modColor)
+{
+    // Draw in green
+    const SDL_Color color = {0, 255, 0, 255};
 
     Vector2 pos = mOwner->GetPosition();
     Vector2 cameraPos = mOwner->GetGame()->GetCameraPos();
 
     // Render vertices as lines
     for(int i = 0; i < mVertices.size() - 1; i++) {
-        SDL_RenderDrawLine(renderer, pos.x + mVertices[i].x - cameraPos.x,
-                                     pos.y + mVertices[i].y - cameraPos.y,
-                                     pos.x + mVertices[i+1].x - cameraPos.x,
-                                     pos.y + mVertices[i+1].y - cameraPos.y);
+        frame.DrawLine(pos.x + mVertices[i].x - cameraPos.x,
+                       pos.y + mVertices[i].y - cameraPos.y,
+                       pos.x + mVertices[i+1].x - cameraPos.x,
+                       pos.y + mVertices[i+1].y - cameraPos.y, color);
     }
 
     // Close geometry
-    SDL_RenderDrawLine(renderer, pos.x + mVertices[mVertices.size() - 1].x - cameraPos.x,
-                                 pos.y + mVertices[mVertices.size() - 1].y - cameraPos.y,
-                                 pos.x + mVertices[0].x - cameraPos.x,
-                                 pos.y + mVertices[0].y - cameraPos.y);
+    frame.DrawLine(pos.x + mVertices[mVertices.size() - 1].x - cameraPos.x,
+                   pos.y + mVertices[mVertices.size() - 1].y - cameraPos.y,
+                   pos.x + mVertices[0].x - cameraPos.x,
+                   pos.y + mVertices[0].y - cameraPos.y, color);
 }
\ No newline at end of file
@@ -11,7 +11,8 @@ public:
     // (Lower draw order corresponds with further back)
     DrawPolygonComponent(class Actor* owner, std::vector<Vector2> &vertices, int drawOrder = 100);
 
-    void Draw(SDL_Renderer* renderer, const Vector3 &modColor = Color::White) override;
+    void Draw(class RenderFrame& frame, const Vector3 &modColor = Color::White) override;
+    DrawState GetDrawState() const override;
     std::vector<Vector2>& GetVertices() { return mVertices; }
 protected:
     int mDrawOrder;
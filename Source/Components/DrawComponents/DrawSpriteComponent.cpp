@@ -5,45 +5,84 @@
 #include "DrawSpriteComponent.h"
 #include "../../Actors/Actor.h"
 #include "../../Game.h"
+#include "../../RenderFrame.h"
+#include "../../TextureAtlas.h"
 
 DrawSpriteComponent::DrawSpriteComponent(class Actor* owner, const std::string &texturePath, const int width, const int height, const int drawOrder)
+        :DrawSpriteComponent(owner, texturePath.empty() ? StringId() : StringId(texturePath), width, height, drawOrder)
+{
+}
+
+DrawSpriteComponent::DrawSpriteComponent(class Actor* owner, StringId texture, const int width, const int height, const int drawOrder)
         :DrawComponent(owner, drawOrder)
+        ,mSpriteSheetSurface(nullptr)
+        ,mSrcRect({0, 0, 0, 0})
+        ,mHasSrcRect(false)
         ,mWidth(width)
         ,mHeight(height)
 {
-    mSpriteSheetSurface = mOwner->GetGame()->LoadTexture(texturePath);
+    if (!texture.IsEmpty()) {
+        SetTexture(texture);
+    }
 }
 
 DrawSpriteComponent::~DrawSpriteComponent()
 {
     DrawComponent::~DrawComponent();
 
-    if (mSpriteSheetSurface) {
-        SDL_DestroyTexture(mSpriteSheetSurface);
-        mSpriteSheetSurface = nullptr;
+    ReleaseTexture();
+}
+
+void DrawSpriteComponent::SetTexture(StringId texture)
+{
+    ReleaseTexture();
+
+    AtlasRegion region;
+    if (mOwner->GetGame()->GetAtlas()->FindSprite(texture, region))
+    {
+        mSpriteSheetSurface = region.texture;
+        mSrcRect = region.rect;
+        mHasSrcRect = true;
     }
+    else
+    {
+        mSpriteSheetSurface = mOwner->GetGame()->GetTexture(texture);
+        mHasSrcRect = false;
+    }
+}
+
+void DrawSpriteComponent::ReleaseTexture()
+{
+    mSpriteSheetSurface = nullptr;
 }
 
-void DrawSpriteComponent::Draw(SDL_Renderer *renderer, const Vector3 &modColor)
+SDL_Rect DrawSpriteComponent::GetDstRect() const
 {
-    SDL_Rect dstRect = {
+    return {
         static_cast<int>(mOwner->GetPosition().x - mOwner->GetGame()->GetCameraPos().x),
         static_cast<int>(mOwner->GetPosition().y - mOwner->GetGame()->GetCameraPos().y),
         mWidth,
         mHeight
     };
+}
+
+DrawState DrawSpriteComponent::GetDrawState() const
+{
+    const float rotation = mOwner->GetRotation();
+    return {GetRotatedBounds(GetDstRect(), rotation), mSpriteSheetSurface,
+            mHasSrcRect ? mSrcRect : SDL_Rect{0, 0, 0, 0}, rotation};
+}
+
+void DrawSpriteComponent::Draw(RenderFrame& frame, const Vector3 &modColor)
+{
+    SDL_Rect dstRect = GetDstRect();
 
     SDL_RendererFlip flip = SDL_FLIP_NONE;
     if (mOwner->GetRotation() == Math::Pi) {
         flip = SDL_FLIP_HORIZONTAL;
     }
 
-    SDL_SetTextureBlendMode(mSpriteSheetSurface, SDL_BLENDMODE_BLEND);
-
-    SDL_SetTextureColorMod(mSpriteSheetSurface,
-                           static_cast<Uint8>(modColor.x),
-                           static_cast<Uint8>(modColor.y),
-                           static_cast<Uint8>(modColor.z));
-
-    SDL_RenderCopyEx(renderer, mSpriteSheetSurface, nullptr, &dstRect, mOwner->GetRotation(), nullptr, flip);
+    SDL_Color color = {static_cast<Uint8>(modColor.x), static_cast<Uint8>(modColor.y),
+                       static_cast<Uint8>(modColor.z), 255};
+    frame.Copy(mSpriteSheetSurface, mHasSrcRect ? &mSrcRect : nullptr, dstRect, mOwner->GetRotation(), flip, color);
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 #include "DrawComponent.h"
+#include "../../StringId.h"
 #include <string>
 
 class DrawSpriteComponent : public DrawComponent
@@ -11,14 +12,31 @@ class DrawSpriteComponent : public DrawComponent
 public:
     // (Lower draw order corresponds with further back)
     DrawSpriteComponent(class Actor* owner, const std::string &texturePath, int width = 0, int height = 0, int drawOrder = 100);
+    // Same, for a path that is already an id (no hashing or interning)
+    DrawSpriteComponent(class Actor* owner, StringId texture, int width = 0, int height = 0, int drawOrder = 100);
     ~DrawSpriteComponent() override;
 
-    void Draw(SDL_Renderer* renderer, const Vector3 &modColor = Color::White) override;
+    void Draw(class RenderFrame& frame, const Vector3 &modColor = Color::White) override;
+
+    SDL_Texture* GetTexture() const override { return mSpriteSheetSurface; }
+    DrawState GetDrawState() const override;
 
 protected:
+    // Resolve the texture through the sprite atlas, falling back to the game's
+    // texture cache (both are owned by the game)
+    void SetTexture(StringId texture);
+    void ReleaseTexture();
+
+    // Where the sprite goes on screen
+    SDL_Rect GetDstRect() const;
+
     // Map of textures loaded
     SDL_Texture* mSpriteSheetSurface;
 
+    // Sub-rect of the texture to draw (whole texture when not from an atlas)
+    SDL_Rect mSrcRect;
+    bool mHasSrcRect;
+
     int mWidth;
     int mHeight;
-};
\ No newline at end of file
+};
@@ -6,6 +6,7 @@
 #include "../Actors/Actor.h"
 #include "../Game.h"
 #include "RigidBodyComponent.h"
+#include "../Snapshot.h"
 #include "ColliderComponents/AABBColliderComponent.h"
 
 const float MAX_SPEED_X = 750.0f;
@@ -14,6 +15,8 @@ const float GRAVITY = 1555.0f;
 
 RigidBodyComponent::RigidBodyComponent(class Actor* owner, float mass, float friction, bool applyGravity, int updateOrder)
         :Component(owner, updateOrder)
+        ,mIsSleeping(false)
+        ,mRestTime(0.0f)
         ,mMass(mass)
         ,mApplyGravity(applyGravity)
         ,mApplyFriction(true)
@@ -25,11 +28,67 @@ RigidBodyComponent::RigidBodyComponent(class Actor* owner, float mass, float fri
 }
 
 void RigidBodyComponent::ApplyForce(const Vector2 &force) {
+    if (force.x != 0.0f || force.y != 0.0f) {
+        WakeUp();
+    }
     mAcceleration += force * (1.f/mMass);
 }
 
-void RigidBodyComponent::Update(float deltaTime)
+void RigidBodyComponent::SetVelocity(const Vector2& velocity)
+{
+    if (velocity.x != mVelocity.x || velocity.y != mVelocity.y) {
+        WakeUp();
+    }
+    mVelocity = velocity;
+}
+
+void RigidBodyComponent::SetAcceleration(const Vector2& acceleration)
+{
+    if (acceleration.x != mAcceleration.x || acceleration.y != mAcceleration.y) {
+        WakeUp();
+    }
+    mAcceleration = acceleration;
+}
+
+void RigidBodyComponent::SetApplyGravity(const bool applyGravity)
 {
+    if (applyGravity) {
+        WakeUp();
+    }
+    mApplyGravity = applyGravity;
+}
+
+void RigidBodyComponent::WakeUp()
+{
+    mIsSleeping = false;
+    mRestTime = 0.0f;
+}
+
+void RigidBodyComponent::SaveState(SnapshotWriter& writer) const
+{
+    Component::SaveState(writer);
+    writer.Write(mVelocity);
+    writer.Write(mAcceleration);
+    writer.Write(mApplyGravity);
+    writer.Write(mApplyFriction);
+    writer.Write(mIsSleeping);
+    writer.Write(mRestTime);
+}
+
+void RigidBodyComponent::LoadState(SnapshotReader& reader)
+{
+    Component::LoadState(reader);
+    reader.Read(mVelocity);
+    reader.Read(mAcceleration);
+    reader.Read(mApplyGravity);
+    reader.Read(mApplyFriction);
+    reader.Read(mIsSleeping);
+    reader.Read(mRestTime);
+}
+
+void RigidBodyComponent::Integrate(float deltaTime)
+{
+    const bool isDriven = mApplyGravity || mAcceleration.x != 0.0f || mAcceleration.y != 0.0f;
     // Apply gravity acceleration
     if(mApplyGravity) {
         ApplyForce(Vector2::UnitY * GRAVITY);
@@ -50,29 +109,54 @@ void RigidBodyComponent::Update(float deltaTime)
         mVelocity.x = 0.f;
     }
 
+    // Fall asleep after resting long enough
+    if (!isDriven && mVelocity.x == 0.0f && mVelocity.y == 0.0f) {
+        mRestTime += deltaTime;
+        mIsSleeping = mRestTime >= SLEEP_TIME;
+    } else {
+        mRestTime = 0.0f;
+    }
+}
+
+void RigidBodyComponent::Move(float deltaTime, std::vector<CollisionEvent>& events)
+{
     auto collider = mOwner->GetComponent<AABBColliderComponent>();
 
+    std::vector<AABBColliderComponent*> candidates;
+    if (collider && (mVelocity.x != 0.0f || mVelocity.y != 0.0f)) {
+        candidates = collider->QueryCandidates();
+    }
+
     if(mVelocity.x != 0.0f)
     {
-        mOwner->SetPosition(Vector2(mOwner->GetPosition().x + mVelocity.x * deltaTime,
+        float dx = mVelocity.x * deltaTime;
+        if (collider) {
+            dx = collider->SweepBlocks(candidates, dx, true);
+        }
+
+        mOwner->SetPosition(Vector2(mOwner->GetPosition().x + dx,
                                          mOwner->GetPosition().y));
 
         if (collider) {
-            collider->DetectHorizontalCollision(this);
+            collider->ResolveContacts(candidates, this, true, events);
         }
     }
 
     if(mVelocity.y != 0.0f)
     {
+        float dy = mVelocity.y * deltaTime;
+        if (collider) {
+            dy = collider->SweepBlocks(candidates, dy, false);
+        }
+
         mOwner->SetPosition(Vector2(mOwner->GetPosition().x,
-                                         mOwner->GetPosition().y + mVelocity.y * deltaTime));
+                                         mOwner->GetPosition().y + dy));
 
         if (collider) {
-            collider->DetectVertialCollision(this);
+            collider->ResolveContacts(candidates, this, false, events);
         }
 
     }
 
     mAcceleration.Set(0.f, 0.f);
 }
-
@@ -5,6 +5,7 @@
 #pragma once
 #include "Component.h"
 #include "../Math.h"
+#include <vector>
 
 class RigidBodyComponent : public Component
 {
@@ -13,20 +14,38 @@ public:
     RigidBodyComponent(class Actor* owner, float mass = 1.0f, float friction = 0.0f,
                         bool applyGravity = true, int updateOrder = 10);
 
-    void Update(float deltaTime) override;
+    // Bodies don't step in Update, Game::StepPhysics steps them all in two
+    // phases. Integrate only touches this body, so bodies can integrate in parallel.
+    void Integrate(float deltaTime);
+    // Move the owner by the integrated velocity and resolve its collisions.
+    // The collisions are queued into events, gameplay reacts to them later.
+    void Move(float deltaTime, std::vector<struct CollisionEvent>& events);
 
     const Vector2& GetVelocity() const { return mVelocity; }
-    void SetVelocity(const Vector2& velocity) { mVelocity = velocity; }
+    void SetVelocity(const Vector2& velocity);
 
     const Vector2& GetAcceleration() const { return mAcceleration; }
-    void SetAcceleration(const Vector2& acceleration) { mAcceleration = acceleration; }
+    void SetAcceleration(const Vector2& acceleration);
 
-    void SetApplyGravity(const bool applyGravity) { mApplyGravity = applyGravity; }
+    void SetApplyGravity(const bool applyGravity);
     void SetApplyFriction(const bool applyFriction) { mApplyFriction = applyFriction;  }
 
     void ApplyForce(const Vector2 &force);
 
+    // A body that stays at rest without gravity or forces for SLEEP_TIME falls
+    // asleep and is skipped by the update until something moves it: a force,
+    // a new velocity, gravity, or another body starting to touch it.
+    bool IsSleeping() const { return mIsSleeping; }
+    void WakeUp();
+
+    void SaveState(class SnapshotWriter& writer) const override;
+    void LoadState(class SnapshotReader& reader) override;
+
 private:
+    const float SLEEP_TIME = 0.5f;
+    bool mIsSleeping;
+    float mRestTime;
+
     bool mApplyGravity;
     bool mApplyFriction;
 
@@ -0,0 +1,87 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "DirtyRegions.h"
+#include <algorithm>
+
+DirtyRegions::DirtyRegions(int width, int height)
+    :mWidth(width)
+    ,mHeight(height)
+    ,mIsFull(false)
+{
+}
+
+void DirtyRegions::Add(const SDL_Rect& rect)
+{
+    if (mIsFull || rect.w <= 0 || rect.h <= 0) {
+        return;
+    }
+
+    // Clip to the screen
+    int left = std::max(rect.x, 0);
+    int top = std::max(rect.y, 0);
+    int right = std::min(rect.x + rect.w, mWidth);
+    int bottom = std::min(rect.y + rect.h, mHeight);
+    if (left >= right || top >= bottom) {
+        return;
+    }
+
+    // Grow it with every rect it (nearly) overlaps until none is left
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < mRects.size(); ++i)
+        {
+            const SDL_Rect& other = mRects[i];
+            if (left > other.x + other.w + MERGE_DISTANCE || other.x > right + MERGE_DISTANCE ||
+                top > other.y + other.h + MERGE_DISTANCE || other.y > bottom + MERGE_DISTANCE) {
+                continue;
+            }
+
+            left = std::min(left, other.x);
+            top = std::min(top, other.y);
+            right = std::max(right, other.x + other.w);
+            bottom = std::max(bottom, other.y + other.h);
+
+            mRects[i] = mRects.back();
+            mRects.pop_back();
+            merged = true;
+            break;
+        }
+    }
+
+    mRects.push_back({left, top, right - left, bottom - top});
+
+    // Past this point redrawing everything is cheaper than the bookkeeping
+    if (mRects.size() > MAX_RECTS || GetArea() * 2 > mWidth * mHeight) {
+        MarkFull();
+    }
+}
+
+void DirtyRegions::MarkFull()
+{
+    mRects.assign(1, {0, 0, mWidth, mHeight});
+    mIsFull = true;
+}
+
+bool DirtyRegions::Intersects(const SDL_Rect& rect) const
+{
+    for (const auto& dirty : mRects)
+    {
+        if (SDL_HasIntersection(&dirty, &rect)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int DirtyRegions::GetArea() const
+{
+    int area = 0;
+    for (const auto& rect : mRects) {
+        area += rect.w * rect.h;
+    }
+    return area;
+}
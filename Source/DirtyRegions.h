@@ -0,0 +1,58 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <vector>
+#include <SDL.h>
+
+// What a drawable puts on screen. The dirty-rectangle renderer redraws the
+// area of a drawable when its state differs from the previous frame.
+struct DrawState
+{
+    SDL_Rect bounds;        // Screen area covered, empty when nothing is drawn
+    const void* texture;
+    SDL_Rect src;
+    float rotation;
+
+    bool operator==(const DrawState& other) const
+    {
+        return SDL_RectEquals(&bounds, &other.bounds) && texture == other.texture &&
+               SDL_RectEquals(&src, &other.src) && rotation == other.rotation;
+    }
+};
+
+// Screen rectangles to redraw in the dirty-rectangle render mode. Rects
+// that overlap (or nearly touch) are merged so nothing is drawn twice, and
+// once they cover most of the screen or get too many it is cheaper to
+// redraw everything, so the whole screen becomes a single rect.
+class DirtyRegions
+{
+public:
+    static const int MAX_RECTS = 16;
+    static const int MERGE_DISTANCE = 8;
+
+    DirtyRegions(int width, int height);
+
+    void Clear() { mRects.clear(); mIsFull = false; }
+
+    // Clipped to the screen, empty rects are ignored
+    void Add(const SDL_Rect& rect);
+    void MarkFull();
+
+    bool IsFull() const { return mIsFull; }
+    bool IsEmpty() const { return mRects.empty(); }
+    bool Intersects(const SDL_Rect& rect) const;
+
+    const std::vector<SDL_Rect>& GetRects() const { return mRects; }
+
+    // Pixels covered by the rects
+    int GetArea() const;
+
+private:
+    int mWidth;
+    int mHeight;
+    bool mIsFull;
+    std::vector<SDL_Rect> mRects;
+};
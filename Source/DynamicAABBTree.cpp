@@ -0,0 +1,450 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "DynamicAABBTree.h"
+#include <algorithm>
+
+namespace
+{
+    // Perimeter of the box enclosing both boxes
+    float UnionPerimeter(const Vector2& aMin, const Vector2& aMax, const Vector2& bMin, const Vector2& bMax)
+    {
+        return 2.0f * ((std::max(aMax.x, bMax.x) - std::min(aMin.x, bMin.x)) +
+                       (std::max(aMax.y, bMax.y) - std::min(aMin.y, bMin.y)));
+    }
+
+    float Perimeter(const Vector2& min, const Vector2& max)
+    {
+        return 2.0f * ((max.x - min.x) + (max.y - min.y));
+    }
+}
+
+void DynamicAABBTree::SetUnion(Node& node, const Node& a, const Node& b)
+{
+    node.min = Vector2(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y));
+    node.max = Vector2(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y));
+}
+
+DynamicAABBTree::DynamicAABBTree(int cellSize, int width, int height)
+    : BroadPhase(cellSize, width, height)
+    , mRoot(NullNode)
+    , mFreeList(NullNode)
+    , mMargin(cellSize / 4.0f)
+{
+}
+
+DynamicAABBTree::~DynamicAABBTree()
+{
+    // Delete all actors (each one removes itself from the tree)
+    while (!mLeaves.empty())
+    {
+        delete mLeaves.begin()->first;
+    }
+
+    mNodes.clear();
+}
+
+int DynamicAABBTree::AllocateNode()
+{
+    int index;
+    if (mFreeList != NullNode)
+    {
+        index = mFreeList;
+        mFreeList = mNodes[index].parent;
+    }
+    else
+    {
+        index = static_cast<int>(mNodes.size());
+        mNodes.emplace_back();
+    }
+
+    Node& node = mNodes[index];
+    node.parent = NullNode;
+    node.left = NullNode;
+    node.right = NullNode;
+    node.height = 0;
+    node.actor = nullptr;
+    return index;
+}
+
+void DynamicAABBTree::FreeNode(int index)
+{
+    mNodes[index].parent = mFreeList;
+    mNodes[index].height = -1;
+    mFreeList = index;
+}
+
+void DynamicAABBTree::Insert(Actor *actor)
+{
+    if (!IsInBounds(actor->GetPosition()))
+    {
+        return; // Out of bounds, do not insert
+    }
+
+    Vector2 position = GetIndexPosition(actor->GetPosition());
+
+    int leaf = AllocateNode();
+    Node& node = mNodes[leaf];
+    node.actor = actor;
+    node.position = position;
+    node.min = Vector2(position.x - mMargin, position.y - mMargin);
+    node.max = Vector2(position.x + mMargin, position.y + mMargin);
+
+    InsertLeaf(leaf);
+    mLeaves[actor] = leaf;
+}
+
+void DynamicAABBTree::Remove(Actor *actor)
+{
+    auto iter = mLeaves.find(actor);
+    if (iter != mLeaves.end())
+    {
+        RemoveLeaf(iter->second);
+        FreeNode(iter->second);
+        mLeaves.erase(iter);
+    }
+}
+
+void DynamicAABBTree::Reinsert(Actor *actor)
+{
+    auto iter = mLeaves.find(actor);
+    if (iter == mLeaves.end())
+    {
+        Insert(actor);
+        return;
+    }
+
+    if (!IsInBounds(actor->GetPosition()))
+    {
+        Remove(actor);
+        return;
+    }
+
+    Vector2 position = GetIndexPosition(actor->GetPosition());
+
+    int leaf = iter->second;
+    Node& node = mNodes[leaf];
+    node.position = position;
+
+    // Still inside its fat box, nothing to restructure
+    if (position.x >= node.min.x && position.x <= node.max.x &&
+        position.y >= node.min.y && position.y <= node.max.y)
+    {
+        return;
+    }
+
+    RemoveLeaf(leaf);
+
+    Node& moved = mNodes[leaf];
+    moved.min = Vector2(position.x - mMargin, position.y - mMargin);
+    moved.max = Vector2(position.x + mMargin, position.y + mMargin);
+
+    InsertLeaf(leaf);
+}
+
+void DynamicAABBTree::InsertLeaf(int leaf)
+{
+    if (mRoot == NullNode)
+    {
+        mRoot = leaf;
+        mNodes[mRoot].parent = NullNode;
+        return;
+    }
+
+    const Vector2 leafMin = mNodes[leaf].min;
+    const Vector2 leafMax = mNodes[leaf].max;
+
+    // Walk down to the sibling that grows the tree's total perimeter the least
+    int index = mRoot;
+    while (!mNodes[index].IsLeaf())
+    {
+        const Node& node = mNodes[index];
+
+        float combined = UnionPerimeter(node.min, node.max, leafMin, leafMax);
+
+        // Cost of making a new parent for this node and the leaf
+        float cost = 2.0f * combined;
+
+        // Minimum cost of pushing the leaf further down
+        float inheritance = 2.0f * (combined - Perimeter(node.min, node.max));
+
+        auto childCost = [&](int child) {
+            const Node& c = mNodes[child];
+            float grown = UnionPerimeter(c.min, c.max, leafMin, leafMax);
+            return (c.IsLeaf() ? grown : grown - Perimeter(c.min, c.max)) + inheritance;
+        };
+
+        float leftCost = childCost(node.left);
+        float rightCost = childCost(node.right);
+
+        if (cost < leftCost && cost < rightCost)
+        {
+            break;
+        }
+
+        index = leftCost < rightCost ? node.left : node.right;
+    }
+
+    int sibling = index;
+    int oldParent = mNodes[sibling].parent;
+    int newParent = AllocateNode();
+
+    Node& parent = mNodes[newParent];
+    parent.parent = oldParent;
+    parent.left = sibling;
+    parent.right = leaf;
+    SetUnion(parent, mNodes[sibling], mNodes[leaf]);
+    parent.height = mNodes[sibling].height + 1;
+
+    if (oldParent != NullNode)
+    {
+        if (mNodes[oldParent].left == sibling) {
+            mNodes[oldParent].left = newParent;
+        } else {
+            mNodes[oldParent].right = newParent;
+        }
+    }
+    else
+    {
+        mRoot = newParent;
+    }
+
+    mNodes[sibling].parent = newParent;
+    mNodes[leaf].parent = newParent;
+
+    Refit(oldParent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int leaf)
+{
+    if (leaf == mRoot)
+    {
+        mRoot = NullNode;
+        return;
+    }
+
+    int parent = mNodes[leaf].parent;
+    int grandParent = mNodes[parent].parent;
+    int sibling = mNodes[parent].left == leaf ? mNodes[parent].right : mNodes[parent].left;
+
+    // The sibling takes the parent's place
+    if (grandParent != NullNode)
+    {
+        if (mNodes[grandParent].left == parent) {
+            mNodes[grandParent].left = sibling;
+        } else {
+            mNodes[grandParent].right = sibling;
+        }
+        mNodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        Refit(grandParent);
+    }
+    else
+    {
+        mRoot = sibling;
+        mNodes[sibling].parent = NullNode;
+        FreeNode(parent);
+    }
+}
+
+void DynamicAABBTree::Refit(int index)
+{
+    while (index != NullNode)
+    {
+        index = Balance(index);
+
+        Node& node = mNodes[index];
+        const Node& left = mNodes[node.left];
+        const Node& right = mNodes[node.right];
+
+        node.height = 1 + std::max(left.height, right.height);
+        SetUnion(node, left, right);
+
+        index = node.parent;
+    }
+}
+
+int DynamicAABBTree::Balance(int iA)
+{
+    Node& A = mNodes[iA];
+    if (A.IsLeaf() || A.height < 2)
+    {
+        return iA;
+    }
+
+    int iB = A.left;
+    int iC = A.right;
+    Node& B = mNodes[iB];
+    Node& C = mNodes[iC];
+
+    int balance = C.height - B.height;
+
+    // Rotate C up
+    if (balance > 1)
+    {
+        int iF = C.left;
+        int iG = C.right;
+        Node& F = mNodes[iF];
+        Node& G = mNodes[iG];
+
+        C.left = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if (C.parent != NullNode)
+        {
+            if (mNodes[C.parent].left == iA) {
+                mNodes[C.parent].left = iC;
+            } else {
+                mNodes[C.parent].right = iC;
+            }
+        }
+        else
+        {
+            mRoot = iC;
+        }
+
+        // Keep the taller grandchild under C
+        if (F.height > G.height)
+        {
+            C.right = iF;
+            A.right = iG;
+            G.parent = iA;
+            SetUnion(A, B, G);
+            SetUnion(C, A, F);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        }
+        else
+        {
+            C.right = iG;
+            A.right = iF;
+            F.parent = iA;
+            SetUnion(A, B, F);
+            SetUnion(C, A, G);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+
+        return iC;
+    }
+
+    // Rotate B up
+    if (balance < -1)
+    {
+        int iD = B.left;
+        int iE = B.right;
+        Node& D = mNodes[iD];
+        Node& E = mNodes[iE];
+
+        B.left = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if (B.parent != NullNode)
+        {
+            if (mNodes[B.parent].left == iA) {
+                mNodes[B.parent].left = iB;
+            } else {
+                mNodes[B.parent].right = iB;
+            }
+        }
+        else
+        {
+            mRoot = iB;
+        }
+
+        // Keep the taller grandchild under B
+        if (D.height > E.height)
+        {
+            B.right = iD;
+            A.left = iE;
+            E.parent = iA;
+            SetUnion(A, C, E);
+            SetUnion(B, A, D);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        }
+        else
+        {
+            B.right = iE;
+            A.left = iD;
+            D.parent = iA;
+            SetUnion(A, C, D);
+            SetUnion(B, A, E);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+void DynamicAABBTree::QueryBounds(const Vector2& min, const Vector2& max, std::vector<Actor*>& results) const
+{
+    if (mRoot == NullNode)
+    {
+        return;
+    }
+
+    std::vector<int> stack;
+    stack.push_back(mRoot);
+
+    while (!stack.empty())
+    {
+        const Node& node = mNodes[stack.back()];
+        stack.pop_back();
+
+        if (node.max.x < min.x || node.min.x >= max.x || node.max.y < min.y || node.min.y >= max.y)
+        {
+            continue;
+        }
+
+        if (node.IsLeaf())
+        {
+            // The fat box overlaps, check the actual position
+            if (node.position.x >= min.x && node.position.x < max.x &&
+                node.position.y >= min.y && node.position.y < max.y)
+            {
+                results.push_back(node.actor);
+            }
+        }
+        else
+        {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+std::vector<Actor*> DynamicAABBTree::Query(const Vector2& position, const int range) const
+{
+    std::vector<Actor*> results;
+
+    Vector2 min, max;
+    if (!GetQueryBounds(position, range, min, max))
+    {
+        return results; // Out of bounds
+    }
+
+    QueryBounds(min, max, results);
+    return results;
+}
+
+std::vector<Actor*> DynamicAABBTree::QueryOnCamera(const Vector2& cameraPosition,
+                                                   const float screenWidth,
+                                                   const float screenHeight,
+                                                   const float extraRadius) const
+{
+    std::vector<Actor*> results;
+
+    Vector2 min, max;
+    GetCameraBounds(cameraPosition, screenWidth, screenHeight, extraRadius, min, max);
+
+    QueryBounds(min, max, results);
+    return results;
+}
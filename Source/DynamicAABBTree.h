@@ -0,0 +1,75 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include "Math.h"
+#include "BroadPhase.h"
+#include "Actors/Actor.h"
+
+// Bounding volume hierarchy over the actors, kept balanced with tree
+// rotations as leaves come and go. Leaves store a fattened box around the
+// actor, so an actor moving inside it only updates its position and the tree
+// is left untouched.
+class DynamicAABBTree : public BroadPhase
+{
+public:
+    DynamicAABBTree(int cellSize, int width, int height);
+    ~DynamicAABBTree() override;
+
+    void Insert(Actor *actor) override;
+    void Remove(Actor *actor) override;
+    void Reinsert(Actor *actor) override;
+
+    std::vector<Actor*> Query(const Vector2& position, const int range = 1) const override;
+    std::vector<Actor*> QueryOnCamera(const Vector2& cameraPosition,
+                                      const float screenWidth,
+                                      const float screenHeight,
+                                      const float extraRadius = 0.0f) const override;
+
+    int GetHeight() const { return mRoot == NullNode ? 0 : mNodes[mRoot].height; }
+
+private:
+    static const int NullNode = -1;
+
+    struct Node
+    {
+        Vector2 min;
+        Vector2 max;
+        int parent;
+        int left;
+        int right;
+        int height; // 0 for leaves
+        Actor* actor;
+        Vector2 position; // Actual position of the actor (leaves only)
+
+        bool IsLeaf() const { return left == NullNode; }
+    };
+
+    // Set node's box to the box enclosing a and b
+    static void SetUnion(Node& node, const Node& a, const Node& b);
+
+    int AllocateNode();
+    void FreeNode(int index);
+
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+
+    // Rotate the subtree at index if it is unbalanced, returns its new root
+    int Balance(int index);
+
+    // Recompute the boxes and heights from index up to the root
+    void Refit(int index);
+
+    void QueryBounds(const Vector2& min, const Vector2& max, std::vector<Actor*>& results) const;
+
+    std::vector<Node> mNodes;
+    int mRoot;
+    int mFreeList; // Free nodes are linked through their parent index
+    float mMargin; // Distance the fat boxes extend past the actor position
+
+    std::unordered_map<Actor*, int> mLeaves; // Maps actor to its leaf node
+};
@@ -14,36 +14,90 @@
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
+#include "Animation.h"
+#include "AssetManager.h"
 #include "CSV.h"
 #include "Random.h"
 #include "Game.h"
 #include "HUD.h"
-#include "SpatialHashing.h"
+#include "Json.h"
+#include "LayeredBroadPhase.h"
+#include "SceneArena.h"
+#include "Snapshot.h"
+#include "TextureAtlas.h"
+#include "JobSystem.h"
+#include "Metrics.h"
+#include "NetSession.h"
+#include "InputSystem.h"
 #include "Actors/Actor.h"
 #include "Actors/Mouse.h"
 #include "Actors/Block.h"
 #include "Actors/Cheese.h"
 #include "Actors/Exit.h"
+#include "Actors/Goomba.h"
 #include "UIElements/UIScreen.h"
 #include "Components/DrawComponents/DrawComponent.h"
 #include "Components/DrawComponents/DrawSpriteComponent.h"
 #include "Components/DrawComponents/DrawPolygonComponent.h"
 #include "Components/ColliderComponents/AABBColliderComponent.h"
+#include "Components/RigidBodyComponent.h"
 
 Game::Game(int windowWidth, int windowHeight)
-        :mWindow(nullptr)
+        :mSimulationFrame(0)
+        ,mFrameDeltaTimes{}
+        ,mNumAwakeBodies(0)
+        ,mNumSleepingBodies(0)
+        ,mSceneArena(nullptr)
+        ,mBroadPhase(nullptr)
+        ,mBroadPhaseType(BroadPhaseType::Grid)
+        ,mJobSystem(nullptr)
+        ,mNumWorkerThreads(0)
+        ,mDeferReinserts(false)
+        ,mIsUpdatingActors(false)
+        ,mNextActorId(0)
+        ,mAssets(nullptr)
+        ,mAssetBudget(AssetManager::DEFAULT_BUDGET)
+        ,mWindow(nullptr)
         ,mRenderer(nullptr)
+        ,mAudio(nullptr)
+        ,mInput(nullptr)
+        ,mAtlas(nullptr)
+        ,mAnimationSystem(nullptr)
         ,mTicksCount(0)
         ,mIsRunning(true)
         ,mWindowWidth(windowWidth)
         ,mWindowHeight(windowHeight)
+        ,mUseSimulationThread(false)
+        ,mIsSimulating(false)
+        ,mTick(0)
+        ,mUseDirtyRects(false)
+        ,mShowDirtyRects(false)
+        ,mHasDrawnFrame(false)
+        ,mDirtyRegions(windowWidth, windowHeight)
+        ,mPreviewRects{}
+        ,mDrawnCameraPos(Vector2::Zero)
+        ,mDrawnModColor(Vector3::Zero)
+        ,mDrawnBackgroundColor(Vector3::Zero)
+        ,mDrawnBackgroundTexture(nullptr)
+        ,mDrawnTransition(false)
+        ,mLevelWidth(LEVEL_WIDTH)
+        ,mLevelHeight(LEVEL_HEIGHT)
+        ,mStartInStress(false)
+        ,mUseNetplay(false)
+        ,mNetSession(nullptr)
+        ,mNetTick(0)
+        ,mNetCheckedTick(0)
+        ,mNetCastSpell(false)
+        ,mNetPointerX(0)
+        ,mNetPointerY(0)
+        ,mNetBotActions(0)
+        ,mNetBotTicks(0)
         ,mPlayer1(nullptr)
         ,mPlayer2(nullptr)
         ,mHUD(nullptr)
         ,mBackgroundColor(0, 0, 0)
         ,mModColor(255, 255, 255)
         ,mCameraPos(Vector2::Zero)
-        ,mAudio(nullptr)
         ,mGameTimer(0.0f)
         ,mGameTimeLimit(0)
         ,mSceneManagerTimer(0.0f)
@@ -57,6 +111,9 @@ Game::Game(int windowWidth, int windowHeight)
         ,mIntroTimer(0.0f)
 {
     mGameSceneSequence = {GameScene::MainMenu, GameScene::Level1, GameScene::Level2, GameScene::Level3};
+
+    mSceneArena = new SceneArena();
+    SceneArena::SetCurrent(mSceneArena);
 }
 
 bool Game::Initialize()
@@ -74,7 +131,19 @@ bool Game::Initialize()
         return false;
     }
 
-    mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (mUseDirtyRects)
+    {
+        // Draw straight into the window surface, which keeps whatever isn't
+        // redrawn from one frame to the next
+        SDL_Surface* windowSurface = SDL_GetWindowSurface(mWindow);
+        mRenderer = windowSurface ? SDL_CreateSoftwareRenderer(windowSurface) : nullptr;
+        SDL_Log("Rendering dirty rectangles only (F2 shows them)");
+    }
+    else
+    {
+        mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    }
+
     if (!mRenderer)
     {
         SDL_Log("Failed to create renderer: %s", SDL_GetError());
@@ -105,15 +174,58 @@ bool Game::Initialize()
     Random::Init();
 
     // Initialize game systems
-    mAudio = new AudioSystem();
+    mInput = new InputSystem();
+
+    mJobSystem = new JobSystem(mNumWorkerThreads);
+    SDL_Log("Updating actors with %d worker thread(s)", mNumWorkerThreads);
+
+    // The dirty-rectangle renderer diffs the live draw components
+    if (mUseSimulationThread && mUseDirtyRects)
+    {
+        SDL_Log("The dirty-rectangle renderer needs the simulation on the main thread");
+        mUseSimulationThread = false;
+    }
+
+    if (mUseSimulationThread) {
+        SDL_Log("Simulating on a separate thread");
+    }
+    RenderResources::Init(mRenderer, mUseSimulationThread ? mJobSystem : nullptr);
+
+    // Load the sprite atlas generated by the atlas-packer target
+    mAtlas = new TextureAtlas();
+    mAtlas->Load(mRenderer, "../Assets/Atlases/sprites.json", mJobSystem);
 
-    mSpatialHashing = new SpatialHashing(TILE_SIZE * 4.0f,
-                                         LEVEL_WIDTH * TILE_SIZE,
-                                         LEVEL_HEIGHT * TILE_SIZE);
+    mAssets = new AssetManager(mRenderer, mJobSystem, mAtlas, mAssetBudget);
+    mAudio = new AudioSystem(mAssets);
+    mAnimationSystem = new AnimationSystem();
+
+    SDL_Log("Using the %s broad phase", BroadPhase::GetTypeName(mBroadPhaseType));
+    ResetBroadPhase(LEVEL_WIDTH * TILE_SIZE, LEVEL_HEIGHT * TILE_SIZE);
     mTicksCount = SDL_GetTicks();
 
+    // Netplay skips the menu, both sides start in the first level
+    if (mUseNetplay)
+    {
+        mNetSession = new NetSession(mNetplayParams);
+        if (mNetSession->Open()) {
+            mIsTwoPlayerMode = true;
+
+            // Both sides must draw the same numbers
+            Random::Seed(NET_RANDOM_SEED);
+            mNetBot.Seed(mNetplayParams.botSeed, mNetplayParams.localPlayer);
+        } else {
+            SDL_Log("Netplay disabled");
+            delete mNetSession;
+            mNetSession = nullptr;
+        }
+    }
+
     // Init all game actors
-    SetGameScene(GameScene::MainMenu);
+    if (mNetSession) {
+        SetGameScene(GameScene::Level1);
+    } else {
+        SetGameScene(mStartInStress ? GameScene::Stress : GameScene::MainMenu);
+    }
 
     return true;
 }
@@ -123,7 +235,7 @@ void Game::SetGameScene(Game::GameScene scene, float transitionTime)
     // Scene Manager FSM: using if/else instead of switch
     if (mSceneManagerState == SceneManagerState::None)
     {
-        if (scene == GameScene::MainMenu || scene == GameScene::Intro || scene == GameScene::Level1 || scene == GameScene::Level2 || scene == GameScene::Level3)
+        if (scene == GameScene::MainMenu || scene == GameScene::Intro || scene == GameScene::Level1 || scene == GameScene::Level2 || scene == GameScene::Level3 || scene == GameScene::Stress)
         {
             mNextScene = scene;
             mSceneManagerState = SceneManagerState::Entering;
@@ -151,17 +263,31 @@ void Game::ChangeScene()
     // Unload current Scene
     UnloadScene();
 
+    // Hold the new scene's assets, the ones only the old scene used can go
+    mAssets->BeginScene(GetSceneName(mNextScene));
+
     // Reset camera position
     mCameraPos.Set(0.0f, 0.0f);
 
     // Reset game timer
     mGameTimer = 0.0f;
+    mSimulationFrame = 0;
+    std::fill(std::begin(mFrameDeltaTimes), std::end(mFrameDeltaTimes), 0.0f);
 
     // Reset gameplau state
     mGamePlayState = GamePlayState::Playing;
 
+    // Stress levels have their own size
+    if (mNextScene == GameScene::Stress) {
+        mLevelWidth = mStressParams.width;
+        mLevelHeight = mStressParams.height;
+    } else {
+        mLevelWidth = LEVEL_WIDTH;
+        mLevelHeight = LEVEL_HEIGHT;
+    }
+
     // Reset scene manager state
-    mSpatialHashing = new SpatialHashing(TILE_SIZE * 4.0f, LEVEL_WIDTH * TILE_SIZE, LEVEL_HEIGHT * TILE_SIZE);
+    ResetBroadPhase(mLevelWidth * TILE_SIZE, mLevelHeight * TILE_SIZE);
 
     // Scene Manager FSM: using if/else instead of switch
     if (mNextScene == GameScene::MainMenu)
@@ -181,7 +307,7 @@ void Game::ChangeScene()
     else if (mNextScene == GameScene::Level1)
     {
         // Start Music
-        mMusicHandle = mAudio->PlaySound("MusicMain.ogg", true);
+        mMusicHandle = mAudio->PlaySound("MusicMain.ogg"_id, true);
 
         // Set background color
         mBackgroundColor.Set(107.0f, 140.0f, 255.0f);
@@ -223,9 +349,58 @@ void Game::ChangeScene()
         mGameTimeLimit = 400;
         LoadLevel("../Assets/Levels/level3.csv", LEVEL_WIDTH, LEVEL_HEIGHT);
     }
+    else if (mNextScene == GameScene::Stress)
+    {
+        mBackgroundColor.Set(107.0f, 140.0f, 255.0f);
+        SetBackgroundImage("../Assets/Sprites/background0.png", Vector2(0,0), Vector2(960,640));
+        mHUD = new HUD(this, "../Assets/Fonts/SB.ttf");
+        mGameTimeLimit = 999;
+        LoadStressLevel(mStressParams);
+    }
 
     // Set new scene
     mGameScene = mNextScene;
+
+    // Load what comes next while this scene plays
+    mAssets->Prefetch(GetSceneName(GetNextScene(mGameScene)));
+}
+
+Game::GameScene Game::GetNextScene(GameScene scene) const
+{
+    if (scene == GameScene::MainMenu) {
+        return GameScene::Intro;
+    }
+    if (scene == GameScene::Intro) {
+        return GameScene::Level1;
+    }
+
+    auto iter = std::find(mGameSceneSequence.begin(), mGameSceneSequence.end(), scene);
+    if (iter != mGameSceneSequence.end() && iter + 1 != mGameSceneSequence.end()) {
+        return *(iter + 1);
+    }
+
+    // Last level, or a scene outside the sequence (stress level)
+    return GameScene::MainMenu;
+}
+
+const char* Game::GetSceneName(GameScene scene)
+{
+    switch (scene)
+    {
+        case GameScene::MainMenu:
+            return "main_menu";
+        case GameScene::Intro:
+            return "intro";
+        case GameScene::Level1:
+            return "level1";
+        case GameScene::Level2:
+            return "level2";
+        case GameScene::Level3:
+            return "level3";
+        case GameScene::Stress:
+            return "stress";
+    }
+    return "unknown";
 }
 
 void Game::LoadIntroScreen()
@@ -274,72 +449,183 @@ void Game::LoadMainMenu()
 
 void Game::LoadLevel(const std::string& levelName, const int levelWidth, const int levelHeight)
 {
-    // Load level data
-    int **mLevelData = ReadLevelData(levelName, levelWidth, levelHeight);
+    Uint64 start = SDL_GetPerformanceCounter();
 
-    if (!mLevelData) {
-        SDL_Log("Failed to load level data");
-        return;
+    // Only the first load of a level touches the file, restarts reuse its template
+    auto iter = mSceneTemplates.find(levelName);
+    bool fromTemplate = iter != mSceneTemplates.end();
+
+    if (!fromTemplate)
+    {
+        // Load level data
+        int **levelData = ReadLevelData(levelName, levelWidth, levelHeight);
+
+        if (!levelData) {
+            SDL_Log("Failed to load level data");
+            return;
+        }
+
+        iter = mSceneTemplates.emplace(levelName, BuildSceneTemplate(levelData, levelWidth, levelHeight)).first;
+
+        for (int i = 0; i < levelHeight; ++i) {
+            delete[] levelData[i];
+        }
+        delete[] levelData;
     }
 
     // Instantiate level actors
-    BuildLevel(mLevelData, levelWidth, levelHeight);
+    InstantiateSceneTemplate(iter->second);
+
+    float elapsedMs = static_cast<float>(SDL_GetPerformanceCounter() - start) * 1000.0f /
+                      static_cast<float>(SDL_GetPerformanceFrequency());
+
+    if (fromTemplate) {
+        SDL_Log("Restarted %s from its template in %.2f ms (first load took %.2f ms)",
+                levelName.c_str(), elapsedMs, iter->second.buildTimeMs);
+    } else {
+        iter->second.buildTimeMs = elapsedMs;
+        SDL_Log("Loaded %s in %.2f ms", levelName.c_str(), elapsedMs);
+    }
 }
 
-void Game::BuildLevel(int** levelData, int width, int height)
+void Game::LoadStressLevel(const LevelGeneratorParams& params)
 {
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    // Generated once per set of parameters, restarts reuse the template
+    const std::string levelName = "stress:" + std::to_string(params.width) + "x" + std::to_string(params.height) +
+                                  ":" + std::to_string(params.seed) + ":" + std::to_string(params.numGoombas) +
+                                  ":" + std::to_string(params.numCheese) + ":" + std::to_string(params.numClusters);
+
+    auto iter = mSceneTemplates.find(levelName);
+    bool fromTemplate = iter != mSceneTemplates.end();
+
+    if (!fromTemplate)
+    {
+        std::vector<int> tiles = LevelGenerator::Generate(params);
+        if (tiles.empty()) {
+            SDL_Log("Failed to generate stress level");
+            return;
+        }
 
-    // Const map to convert tile ID to block type
-    const std::map<int, const std::string> tileMap = {
-            {0, "../Assets/Sprites/Blocks/Grass.png"},
-            {1, "../Assets/Sprites/Blocks/BlockC.png"},
-            {2, "../Assets/Sprites/Blocks/BlockF.png"},
-            {4, "../Assets/Sprites/Blocks/Rock.png"},
-            {6, "../Assets/Sprites/Blocks/BlockI.png"},
-            {8, "empty"},
-            {9, "../Assets/Sprites/Blocks/BlockH.png"},
-            {12, "../Assets/Sprites/Blocks/BlockG.png"},
+        std::vector<int*> rows(params.height);
+        for (int y = 0; y < params.height; ++y) {
+            rows[y] = &tiles[static_cast<size_t>(y) * params.width];
+        }
+
+        iter = mSceneTemplates.emplace(levelName, BuildSceneTemplate(rows.data(), params.width, params.height)).first;
+    }
+
+    InstantiateSceneTemplate(iter->second);
+
+    float elapsedMs = static_cast<float>(SDL_GetPerformanceCounter() - start) * 1000.0f /
+                      static_cast<float>(SDL_GetPerformanceFrequency());
+
+    if (!fromTemplate) {
+        iter->second.buildTimeMs = elapsedMs;
+    }
+
+    SDL_Log("%s stress level %d x %d (seed %llu): %zu actors in %.2f ms", fromTemplate ? "Restarted" : "Generated",
+            params.width, params.height, static_cast<unsigned long long>(params.seed),
+            iter->second.spawns.size(), elapsedMs);
+}
+
+SceneTemplate Game::BuildSceneTemplate(int** levelData, int width, int height)
+{
+    // Const map to convert tile ID to block type (the paths are interned, so
+    // blocks can load their texture from the id)
+    const std::map<int, StringId> tileMap = {
+            {0, StringId("../Assets/Sprites/Blocks/Grass.png")},
+            {1, StringId("../Assets/Sprites/Blocks/BlockC.png")},
+            {2, StringId("../Assets/Sprites/Blocks/BlockF.png")},
+            {4, StringId("../Assets/Sprites/Blocks/Rock.png")},
+            {6, StringId("../Assets/Sprites/Blocks/BlockI.png")},
+            {8, "empty"_id},
+            {9, StringId("../Assets/Sprites/Blocks/BlockH.png")},
+            {12, StringId("../Assets/Sprites/Blocks/BlockG.png")},
     };
 
-    for (int y = 0; y < LEVEL_HEIGHT; ++y)
+    SceneTemplate sceneTemplate;
+
+    for (int y = 0; y < height; ++y)
     {
-        for (int x = 0; x < LEVEL_WIDTH; ++x)
+        for (int x = 0; x < width; ++x)
         {
             int tile = levelData[y][x];
-
-            const float forwardSpeed = 1000.0f;
-            const float jumpSpeed = -555.0f;
+            Vector2 position(x * TILE_SIZE, y * TILE_SIZE);
 
             if(tile == 16)
             {
+                sceneTemplate.spawns.push_back({SceneTemplate::Archetype::Player, position, StringId()});
+            }
+            else if(tile == 3)
+            {
+                sceneTemplate.spawns.push_back({SceneTemplate::Archetype::Cheese, position, StringId()});
+            }
+            else if(tile == 13)
+            {
+                sceneTemplate.spawns.push_back({SceneTemplate::Archetype::Exit, position, StringId()});
+            }
+            else if(tile == 10)
+            {
+                sceneTemplate.spawns.push_back({SceneTemplate::Archetype::Goomba, position, StringId()});
+            }
+            else
+            {
+                auto it = tileMap.find(tile);
+                if (it != tileMap.end()) {
+                    sceneTemplate.spawns.push_back({SceneTemplate::Archetype::Block, position, it->second});
+                }
+            }
+        }
+    }
+
+    return sceneTemplate;
+}
+
+void Game::InstantiateSceneTemplate(const SceneTemplate& sceneTemplate)
+{
+    const float forwardSpeed = 1000.0f;
+    const float jumpSpeed = -555.0f;
+
+    for (const auto& spawn : sceneTemplate.spawns)
+    {
+        switch (spawn.archetype)
+        {
+            case SceneTemplate::Archetype::Player:
                 mPlayer1 = new Mouse(this, forwardSpeed, jumpSpeed, true);
-                mPlayer1->SetPosition(Vector2(x * TILE_SIZE, y * TILE_SIZE));
+                mPlayer1->SetPosition(spawn.position);
                 if (mIsTwoPlayerMode) {
                     mPlayer2 = new Mouse(this, forwardSpeed, jumpSpeed, false);
-                    mPlayer2->SetPosition(Vector2(x * TILE_SIZE, y * TILE_SIZE));
+                    mPlayer2->SetPosition(spawn.position);
                 } else {
                     mPlayer2 = nullptr;
                 }
-            }
-            else if(tile == 3)
+                break;
+            case SceneTemplate::Archetype::Cheese:
             {
                 Cheese* cheese = new Cheese(this);
-                cheese->SetPosition(Vector2(x * TILE_SIZE, y * TILE_SIZE));
+                cheese->SetPosition(spawn.position);
+                break;
             }
-            else if(tile == 13)
+            case SceneTemplate::Archetype::Exit:
             {
                 Exit* exit = new Exit(this);
-                exit->SetPosition(Vector2(x * TILE_SIZE, y * TILE_SIZE));
+                exit->SetPosition(spawn.position);
+                break;
             }
-            else
+            case SceneTemplate::Archetype::Goomba:
             {
-                auto it = tileMap.find(tile);
-                if (it != tileMap.end())
-                {
-                    // Create a block actor
-                    Block* block = new Block(this, it->second);
-                    block->SetPosition(Vector2(x * TILE_SIZE, y * TILE_SIZE));
-                }
+                Goomba* goomba = new Goomba(this);
+                goomba->SetPosition(spawn.position);
+                break;
+            }
+            case SceneTemplate::Archetype::Block:
+            {
+                // Create a block actor
+                Block* block = new Block(this, spawn.texture);
+                block->SetPosition(spawn.position);
+                break;
             }
         }
     }
@@ -388,20 +674,123 @@ int **Game::ReadLevelData(const std::string& fileName, int width, int height)
 }
 
 void Game::RunLoop()
+{
+    if (!mUseSimulationThread)
+    {
+        SimulationLoop();
+        return;
+    }
+
+    mPendingKeyboardState.assign(SDL_NUM_SCANCODES, 0);
+    mKeyboardState.assign(SDL_NUM_SCANCODES, 0);
+    mInput->SetKeyboardState(mKeyboardState.data());
+
+    // This thread keeps the window: it pumps the events and draws the
+    // latest frame the simulation published, without ever waiting for it
+    mIsSimulating = true;
+    mSimulationThread = std::thread(&Game::SimulationLoop, this);
+
+    while (mIsRunning)
+    {
+        PumpEvents();
+
+        // Textures the simulation is waiting for
+        mJobSystem->PumpMainThreadJobs();
+
+        const RenderFrame* frame = mRenderFrames.AcquireLatest();
+        if (!frame)
+        {
+            SDL_Delay(1);
+            continue;
+        }
+
+        RenderResources::CollectReleased(frame->GetTick());
+        PresentFrame(*frame);
+    }
+
+    // The simulation may still be waiting for a texture
+    while (mIsSimulating)
+    {
+        mJobSystem->PumpMainThreadJobs();
+        std::this_thread::yield();
+    }
+    mSimulationThread.join();
+}
+
+void Game::SimulationLoop()
 {
     while (mIsRunning)
     {
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        RenderResources::BeginTick(mTick);
+
         ProcessInput();
         UpdateGame();
         GenerateOutput();
+
+        // The draw counts come from the thread presenting the frames, which
+        // may be a few ticks behind (see Metrics::SetFrameDraws)
+        if (Metrics::IsEnabled())
+        {
+            Uint64 elapsed = SDL_GetPerformanceCounter() - frameStart;
+            Metrics::Set(Metric::FrameTimeUs, elapsed * 1000000 / SDL_GetPerformanceFrequency());
+            Metrics::Set(Metric::TexturesResident, mAssets->GetNumResident(AssetType::Texture) + mAtlas->GetNumPages());
+            Metrics::Set(Metric::AssetBytesResident, mAssets->GetResidentBytes());
+            Metrics::Set(Metric::SoundsPlaying, mAudio->GetNumPlayingSounds());
+            Metrics::Set(Metric::AwakeBodies, mNumAwakeBodies);
+            Metrics::Set(Metric::SleepingBodies, mNumSleepingBodies);
+            Metrics::EndFrame(mTick);
+        }
+        ++mTick;
     }
+
+    mIsSimulating = false;
 }
 
-void Game::ProcessInput()
+void Game::PumpEvents()
 {
+    std::lock_guard<std::mutex> lock(mEventMutex);
+
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
+        // Don't wait for the next tick to close the window
+        if (event.type == SDL_QUIT) {
+            Quit();
+        }
+        mPendingEvents.push_back(event);
+    }
+
+    int numKeys = 0;
+    const Uint8* state = SDL_GetKeyboardState(&numKeys);
+    std::copy(state, state + std::min(numKeys, static_cast<int>(mPendingKeyboardState.size())),
+              mPendingKeyboardState.begin());
+}
+
+void Game::ProcessInput()
+{
+    mInput->BeginFrame();
+
+    // With a simulation thread the events were pumped by the render thread
+    mEvents.clear();
+    if (mUseSimulationThread)
+    {
+        std::lock_guard<std::mutex> lock(mEventMutex);
+        mEvents.swap(mPendingEvents);
+        std::copy(mPendingKeyboardState.begin(), mPendingKeyboardState.end(), mKeyboardState.begin());
+    }
+    else
+    {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            mEvents.push_back(event);
+        }
+    }
+
+    for (const SDL_Event& event : mEvents)
+    {
+        mInput->HandleEvent(event);
+
         switch (event.type)
         {
             case SDL_QUIT:
@@ -413,28 +802,54 @@ void Game::ProcessInput()
                     mUIStack.back()->HandleKeyPress(event.key.keysym.sym);
                 }
 
-                HandleKeyPressActors(event.key.keysym.sym, event.key.repeat == 0);
+                // Pausing and quick saves would only happen on one side of a netplay session
+                if (mNetSession && (event.key.keysym.sym == SDLK_RETURN || event.key.keysym.sym == SDLK_F5 ||
+                                    event.key.keysym.sym == SDLK_F9))
+                {
+                    break;
+                }
 
                 // Check if the Return key has been pressed to pause/unpause the game
                 if (event.key.keysym.sym == SDLK_RETURN)
                 {
                     TogglePause();
                 }
-                break;
-            case SDL_MOUSEMOTION:
-                if (mPlayer1 && mPlayer1->GetSpellMode()) {
-                    mPlayer1->UpdateBlockPreview(event.motion.x, event.motion.y);
+                else if (event.key.keysym.sym == SDLK_F5 && event.key.repeat == 0)
+                {
+                    SaveQuickSnapshot();
+                }
+                else if (event.key.keysym.sym == SDLK_F9 && event.key.repeat == 0)
+                {
+                    RestoreQuickSnapshot();
                 }
-                if (mPlayer2 && mPlayer2->GetSpellMode()) {
-                    mPlayer2->UpdateBlockPreview(event.motion.x, event.motion.y);
+                else if (event.key.keysym.sym == SDLK_F3 && event.key.repeat == 0)
+                {
+                    SDL_Log("Rigid bodies: %d awake, %d sleeping", mNumAwakeBodies, mNumSleepingBodies);
+                }
+                else if (event.key.keysym.sym == SDLK_F2 && event.key.repeat == 0 && mUseDirtyRects)
+                {
+                    mShowDirtyRects = !mShowDirtyRects;
                 }
                 break;
             case SDL_MOUSEBUTTONDOWN:
-                HandleSpell(event);
+                // In netplay the click is part of the next tick's input
+                if (mNetSession) {
+                    if (event.button.button == SDL_BUTTON_LEFT) {
+                        mNetCastSpell = true;
+                        mNetPointerX = static_cast<int16_t>(event.button.x);
+                        mNetPointerY = static_cast<int16_t>(event.button.y);
+                    }
+                } else {
+                    HandleSpell(event);
+                }
         }
     }
 
-    ProcessInputActors();
+    // Actions and pointer motion go to the subscribed actors only (netplay
+    // dispatches each tick's inputs when simulating it)
+    if (mGamePlayState == GamePlayState::Playing && !mNetSession) {
+        mInput->Dispatch();
+    }
 }
 
 void Game::HandleSpell(SDL_Event event) {
@@ -455,67 +870,6 @@ void Game::HandleSpell(SDL_Event event) {
     }
 }
 
-void Game::ProcessInputActors()
-{
-    if(mGamePlayState == GamePlayState::Playing)
-    {
-        // Get actors on camera
-        std::vector<Actor*> actorsOnCamera =
-                mSpatialHashing->QueryOnCamera(mCameraPos,mWindowWidth,mWindowHeight);
-
-        const Uint8* state = SDL_GetKeyboardState(nullptr);
-
-        bool arePlayersOnCamera = false;
-        for (auto actor: actorsOnCamera)
-        {
-            actor->ProcessInput(state);
-
-            if (actor == mPlayer1 || actor == mPlayer2) {
-                arePlayersOnCamera = true;
-            }
-        }
-
-        if (!arePlayersOnCamera && (mPlayer1 || mPlayer2)) {
-            if(mPlayer1) {
-                mPlayer1->ProcessInput(state);
-            }
-            if(mPlayer2) {
-                mPlayer2->ProcessInput(state);
-            }
-        }
-    }
-}
-
-void Game::HandleKeyPressActors(const int key, const bool isPressed)
-{
-    if(mGamePlayState == GamePlayState::Playing)
-    {
-        // Get actors on camera
-        std::vector<Actor*> actorsOnCamera =
-                mSpatialHashing->QueryOnCamera(mCameraPos,mWindowWidth,mWindowHeight);
-
-        // Handle key press for actors
-        bool arePlayersOnCamera = false;
-        for (auto actor: actorsOnCamera) {
-            actor->HandleKeyPress(key, isPressed);
-
-            if (actor == mPlayer1 && actor == mPlayer2) {
-                arePlayersOnCamera = true;
-            }
-        }
-
-        if (!arePlayersOnCamera && (mPlayer1 || mPlayer2)) {
-            if(mPlayer1) {
-                mPlayer1->HandleKeyPress(key, isPressed);
-            }
-            if(mPlayer2) {
-                mPlayer2->HandleKeyPress(key, isPressed);
-            }
-        }
-    }
-
-}
-
 void Game::TogglePause()
 {
     if (mGameScene != GameScene::MainMenu)
@@ -523,13 +877,13 @@ void Game::TogglePause()
         if (mGamePlayState == GamePlayState::Playing)
         {
             mGamePlayState = GamePlayState::Paused;
-            mAudio->PlaySound("Coin.wav");
+            mAudio->PlaySound("Coin.wav"_id);
             mAudio->PauseSound(mMusicHandle);
         }
         else if (mGamePlayState == GamePlayState::Paused)
         {
             mGamePlayState = GamePlayState::Playing;
-            mAudio->PlaySound("Coin.wav");
+            mAudio->PlaySound("Coin.wav"_id);
             mAudio->ResumeSound(mMusicHandle);
         }
     }
@@ -547,7 +901,19 @@ void Game::UpdateGame()
 
     mTicksCount = SDL_GetTicks();
 
-    if(mGamePlayState != GamePlayState::Paused && mGamePlayState != GamePlayState::GameOver)
+    // Run work that jobs handed back to the main thread (SDL calls). With a
+    // simulation thread the render loop does it.
+    if (mJobSystem->IsMainThread()) {
+        mJobSystem->PumpMainThreadJobs();
+    }
+
+    // Netplay simulates the levels in fixed ticks, scene manager included
+    const bool isNetplayTick = mNetSession && mGameScene != GameScene::MainMenu && mGameScene != GameScene::Intro;
+    if (isNetplayTick)
+    {
+        UpdateNetplay();
+    }
+    else if(mGamePlayState != GamePlayState::Paused && mGamePlayState != GamePlayState::GameOver)
     {
         // Reinsert all actors and pending actors
         UpdateActors(deltaTime);
@@ -555,6 +921,7 @@ void Game::UpdateGame()
 
     // Reinsert audio system
     mAudio->Update(deltaTime);
+    mAssets->Update();
 
     // Reinsert UI screens
     for (auto ui : mUIStack) {
@@ -577,7 +944,7 @@ void Game::UpdateGame()
     // ---------------------
     // Game Specific Updates
     // ---------------------
-    if(mGameScene != GameScene::MainMenu && mGamePlayState == GamePlayState::Playing)
+    if(mGameScene != GameScene::MainMenu && mGamePlayState == GamePlayState::Playing && !isNetplayTick)
     {
         // Reinsert level time
         UpdateLevelTime(deltaTime);
@@ -596,50 +963,266 @@ void Game::UpdateGame()
         }
     }
 
-    UpdateSceneManager(deltaTime);
-    UpdateCamera();
+    if (!isNetplayTick)
+    {
+        UpdateSceneManager(deltaTime);
+        UpdateCamera();
+    }
 }
 
-void Game::UpdateSceneManager(float deltaTime)
+void Game::UpdateNetplay()
 {
-    if(mSceneManagerState == SceneManagerState::Entering)
+    mNetSession->Poll(SDL_GetTicks());
+
+    if (mNetSession->HasPeerLeft())
     {
-        mSceneManagerTimer -= deltaTime;
-        if(mSceneManagerTimer <= 0.0f)
+        SDL_Log("Netplay: the other player left, quitting");
+        Quit();
+        return;
+    }
+
+    // Read before any re-simulation, which starts new input frames
+    const bool canAdvance = mNetSession->CanAdvance(mNetTick);
+    if (canAdvance) {
+        mNetSession->SetLocalInput(mNetTick, ReadLocalNetInput());
+    }
+
+    // Roll back to the first tick simulated with a wrong prediction. Its
+    // state was saved with confirmed inputs only.
+    const uint32_t historyStart = mNetSession->GetHistoryStart();
+    const uint32_t rollbackTick = mNetSession->TakeRollbackTick();
+    if (rollbackTick < mNetTick && rollbackTick >= historyStart && mNetSession->LoadState(rollbackTick, mNetState) &&
+        RestoreSnapshot(mNetState))
+    {
+        Uint64 start = SDL_GetPerformanceCounter();
+
+        // The sounds of these ticks were already played
+        mAudio->SetMuted(true);
+        for (uint32_t tick = rollbackTick; tick < mNetTick && mNetSession->GetHistoryStart() == historyStart; ++tick)
         {
-            mSceneManagerTimer = TRANSITION_TIME;
-            mSceneManagerState = SceneManagerState::Active;
+            if (tick > rollbackTick) {
+                SaveSnapshot(mNetState);
+                mNetSession->SaveState(tick, mNetState);
+            }
+            SimulateNetTick(tick);
         }
+        mAudio->SetMuted(false);
+
+        const uint32_t numTicks = mNetTick - rollbackTick;
+        const uint64_t elapsedUs = (SDL_GetPerformanceCounter() - start) * 1000000 / SDL_GetPerformanceFrequency();
+        mNetStats.rollbacks++;
+        mNetStats.resimulatedTicks += numTicks;
+        mNetStats.maxRollbackTicks = std::max(mNetStats.maxRollbackTicks, numTicks);
+        mNetStats.rollbackUs += elapsedUs;
+        mNetStats.maxRollbackUs = std::max(mNetStats.maxRollbackUs, elapsedUs);
+        Metrics::Add(Metric::RollbackTicks, numTicks);
+        Metrics::Add(Metric::RollbackTimeUs, elapsedUs);
     }
-    else if(mSceneManagerState == SceneManagerState::Active)
+
+    // This frame's tick, unless it would get too far ahead of the peer
+    if (canAdvance)
     {
-        mSceneManagerTimer -= deltaTime;
-        if(mSceneManagerTimer <= 0.0f)
-        {
-            ChangeScene();
-            mSceneManagerState = SceneManagerState::None;
+        SaveSnapshot(mNetState);
+        mNetSession->SaveState(mNetTick, mNetState);
+        SimulateNetTick(mNetTick);
+        ++mNetTick;
+    }
+    else
+    {
+        if (mNetStats.stalledFrames++ == 0 && !mNetSession->HasPeer()) {
+            SDL_Log("Netplay: waiting for player %d", mNetSession->GetRemotePlayer() + 1);
         }
     }
-}
 
-void Game::UpdateLevelTime(float deltaTime)
-{
+    // Checksum the states that are now confirmed, the peer compares them
+    // with its own. Only states still in the rollback history are known.
+    uint32_t tick = std::max(mNetCheckedTick, mNetSession->GetHistoryStart());
+    if (mNetTick > NetSession::MAX_ROLLBACK + 1) {
+        tick = std::max(tick, mNetTick - NetSession::MAX_ROLLBACK - 1);
+    }
+    for (; tick < mNetTick && tick <= mNetSession->GetConfirmedTick(); ++tick)
+    {
+        uint64_t checksum = 0;
+        if (mNetSession->GetSavedStateHash(tick, checksum)) {
+            mNetSession->SetStateChecksum(tick, checksum);
+        }
+    }
+    mNetCheckedTick = tick;
+
+    // The last level leads back to the menu, which is played alone
+    if (mGameScene == GameScene::MainMenu) {
+        EndNetplay();
+        return;
+    }
+
+    if (mNetplayParams.maxTicks > 0 && mNetTick >= mNetplayParams.maxTicks) {
+        Quit();
+    }
 }
 
-void Game::UpdateCamera()
+void Game::SimulateNetTick(uint32_t tick)
 {
-    if (!mPlayer1) return;
-
-    float player1PosX = mPlayer1->GetPosition().x;
+    // Both players' inputs, with the edges taken against the inputs the
+    // previous tick was simulated with
+    mInput->BeginFrame();
 
-    // Center camera on player 1
-    float horizontalCameraPos = player1PosX - (mWindowWidth / 2.0f);
+    NetInput inputs[InputSystem::MAX_PLAYERS];
+    for (int player = 0; player < InputSystem::MAX_PLAYERS; ++player)
+    {
+        inputs[player] = mNetSession->GetInput(player, tick);
+        NetInput previous;
+        if (tick > mNetSession->GetHistoryStart()) {
+            previous = mNetSession->GetUsedInput(player, tick - 1);
+        }
 
-    float maxCameraPos = (LEVEL_WIDTH * TILE_SIZE) - mWindowWidth;
-    horizontalCameraPos = Math::Clamp(horizontalCameraPos, 0.0f, maxCameraPos);
+        mInput->SetPlayerInput(player, inputs[player].actions, previous.actions,
+                               (inputs[player].flags & NetInput::POINTER_MOVED) != 0,
+                               inputs[player].pointerX, inputs[player].pointerY);
+    }
 
-    mCameraPos.x = horizontalCameraPos;
-}
+    if (mGamePlayState == GamePlayState::Playing)
+    {
+        mInput->Dispatch();
+
+        Mouse* players[InputSystem::MAX_PLAYERS] = {mPlayer1, mPlayer2};
+        for (int player = 0; player < InputSystem::MAX_PLAYERS; ++player)
+        {
+            if ((inputs[player].flags & NetInput::CAST_SPELL) && players[player] && players[player]->GetSpellMode()) {
+                players[player]->CastSpell(inputs[player].pointerX, inputs[player].pointerY);
+            }
+        }
+    }
+
+    if (mGamePlayState != GamePlayState::Paused && mGamePlayState != GamePlayState::GameOver) {
+        UpdateActors(NET_TICK_TIME);
+    }
+
+    if (mGamePlayState == GamePlayState::Playing) {
+        UpdateLevelTime(NET_TICK_TIME);
+    }
+
+    // Scene changes happen a whole transition after they were triggered, far
+    // more than MAX_ROLLBACK ticks, so both sides change at the same tick
+    const bool isChangingScene = mSceneManagerState == SceneManagerState::Active;
+    UpdateSceneManager(NET_TICK_TIME);
+    if (isChangingScene && mSceneManagerState == SceneManagerState::None) {
+        mNetSession->ResetHistory(tick + 1);
+    }
+
+    UpdateCamera();
+}
+
+NetInput Game::ReadLocalNetInput()
+{
+    NetInput input;
+
+    if (mNetplayParams.botSeed != 0)
+    {
+        // Mostly run right, sometimes left or stand, jumping now and then
+        if (--mNetBotTicks <= 0)
+        {
+            const float roll = mNetBot.GetFloat();
+            mNetBotActions = roll < 0.6f ? 1u << static_cast<uint32_t>(InputAction::MoveRight)
+                           : roll < 0.75f ? 1u << static_cast<uint32_t>(InputAction::MoveLeft) : 0u;
+            if (mNetBot.GetFloat() < 0.5f) {
+                mNetBotActions |= 1u << static_cast<uint32_t>(InputAction::Jump);
+            }
+            mNetBotTicks = mNetBot.GetIntRange(5, 40);
+        }
+        input.actions = static_cast<uint8_t>(mNetBotActions);
+        return input;
+    }
+
+    // Each side plays with the first player's keys
+    input.actions = static_cast<uint8_t>(mInput->ReadKeyboardActions(0));
+
+    int pointerX = 0;
+    int pointerY = 0;
+    if (mInput->GetPointerMotion(pointerX, pointerY)) {
+        input.flags |= NetInput::POINTER_MOVED;
+    }
+    if (mNetCastSpell) {
+        input.flags |= NetInput::CAST_SPELL;
+        mNetCastSpell = false;
+    }
+
+    // The spell is cast where the pointer last was
+    if (input.flags & NetInput::POINTER_MOVED) {
+        mNetPointerX = static_cast<int16_t>(pointerX);
+        mNetPointerY = static_cast<int16_t>(pointerY);
+    }
+    input.pointerX = mNetPointerX;
+    input.pointerY = mNetPointerY;
+    return input;
+}
+
+void Game::EndNetplay()
+{
+    if (!mNetSession) {
+        return;
+    }
+
+    SDL_Log("Netplay: %u ticks, %u rollbacks (%u ticks re-simulated, %.2f ms each on average, at most %u ticks "
+            "taking %.2f ms), %u frames waiting for the peer, %zu KB of rollback history, %d desyncs, "
+            "%d packets sent, %d dropped",
+            mNetTick, mNetStats.rollbacks, mNetStats.resimulatedTicks,
+            mNetStats.rollbacks > 0 ? mNetStats.rollbackUs / 1000.0f / mNetStats.rollbacks : 0.0f,
+            mNetStats.maxRollbackTicks, mNetStats.maxRollbackUs / 1000.0f, mNetStats.stalledFrames,
+            mNetSession->GetHistoryBytes() / 1024, mNetSession->GetNumDesyncs(),
+            mNetSession->GetNumPacketsSent(), mNetSession->GetNumPacketsDropped());
+
+    mNetSession->SendQuit();
+    delete mNetSession;
+    mNetSession = nullptr;
+}
+
+void Game::UpdateSceneManager(float deltaTime)
+{
+    if(mSceneManagerState == SceneManagerState::Entering)
+    {
+        mSceneManagerTimer -= deltaTime;
+        if(mSceneManagerTimer <= 0.0f)
+        {
+            mSceneManagerTimer = TRANSITION_TIME;
+            mSceneManagerState = SceneManagerState::Active;
+        }
+    }
+    else if(mSceneManagerState == SceneManagerState::Active)
+    {
+        mSceneManagerTimer -= deltaTime;
+        if(mSceneManagerTimer <= 0.0f)
+        {
+            ChangeScene();
+            mSceneManagerState = SceneManagerState::None;
+
+            // Whatever was left depends on the frame times, keep it out of the snapshots
+            mSceneManagerTimer = 0.0f;
+        }
+    }
+}
+
+void Game::UpdateLevelTime(float deltaTime)
+{
+}
+
+void Game::UpdateCamera()
+{
+    if (!mPlayer1) return;
+
+    float player1PosX = mPlayer1->GetPosition().x;
+
+    // Center camera on player 1
+    float horizontalCameraPos = player1PosX - (mWindowWidth / 2.0f);
+
+    float maxCameraPos = (mLevelWidth * TILE_SIZE) - mWindowWidth;
+    horizontalCameraPos = Math::Clamp(horizontalCameraPos, 0.0f, maxCameraPos);
+
+    mCameraPos.x = horizontalCameraPos;
+
+    // Levels taller than the window (stress levels) also scroll vertically
+    float maxVerticalPos = Math::Max((mLevelHeight * TILE_SIZE) - mWindowHeight, 0);
+    mCameraPos.y = Math::Clamp(mPlayer1->GetPosition().y - (mWindowHeight / 2.0f), 0.0f, maxVerticalPos);
+}
 
 int Game::PlayersLeaving() {
     int count = 0;
@@ -652,145 +1235,940 @@ int Game::PlayersLeaving() {
     return count;
 }
 
+static bool CompareActorIds(Actor* a, Actor* b)
+{
+    return a->GetId() < b->GetId();
+}
+
 void Game::UpdateActors(float deltaTime)
 {
-    // Get actors on camera
+    // Full rate: actors on camera and a margin around it
     std::vector<Actor*> actorsOnCamera =
-        mSpatialHashing->QueryOnCamera(mCameraPos,mWindowWidth,mWindowHeight);
+        mBroadPhase->QueryOnCamera(mCameraPos, mWindowWidth, mWindowHeight, FULL_RATE_MARGIN);
 
+    // Reduced rate: the ring around it, only the phase whose turn it is
+    const uint32_t frame = mSimulationFrame++;
+    const int phase = static_cast<int>(frame % REDUCED_RATE_INTERVAL);
+    mFrameDeltaTimes[phase] = deltaTime;
+
+    mFullRateActors.assign(actorsOnCamera.begin(), actorsOnCamera.end());
+    std::sort(mFullRateActors.begin(), mFullRateActors.end());
+    std::vector<Actor*> actorsNearCamera;
+    for (auto actor : mBroadPhase->QueryOnCamera(mCameraPos, mWindowWidth, mWindowHeight, REDUCED_RATE_MARGIN))
+    {
+        if (actor->GetId() % REDUCED_RATE_INTERVAL == static_cast<uint32_t>(phase) &&
+            !std::binary_search(mFullRateActors.begin(), mFullRateActors.end(), actor)) {
+            actorsNearCamera.emplace_back(actor);
+        }
+    }
+
+    // Netplay needs both sides (and re-simulations) to update in the same
+    // order, which the broad phase's internal layout doesn't guarantee
+    if (mNetSession)
+    {
+        std::sort(actorsOnCamera.begin(), actorsOnCamera.end(), CompareActorIds);
+        std::sort(actorsNearCamera.begin(), actorsNearCamera.end(), CompareActorIds);
+    }
+
+    ApplyUpdateBudget(actorsOnCamera, FULL_RATE_BUDGET);
+    ApplyUpdateBudget(actorsNearCamera, REDUCED_RATE_BUDGET);
+
+    // Each reduced rate actor catches up on the frames it missed: a full
+    // interval, or less if it was at full rate or spawned since. Dormant
+    // actors coming back only get one interval.
+    std::vector<float> fullDeltaTimes(actorsOnCamera.size(), deltaTime);
+    std::vector<float> reducedDeltaTimes;
+    reducedDeltaTimes.reserve(actorsNearCamera.size());
+    for (auto actor : actorsNearCamera)
+    {
+        const uint32_t missed = std::min<uint32_t>(frame - actor->GetLastUpdateFrame(), REDUCED_RATE_INTERVAL);
+        float elapsed = 0.0f;
+        for (uint32_t i = missed; i > 0; --i) {
+            elapsed += mFrameDeltaTimes[(frame + 1 - i) % REDUCED_RATE_INTERVAL];
+        }
+        reducedDeltaTimes.emplace_back(elapsed);
+    }
+
+    mNumAwakeBodies = 0;
+    mNumSleepingBodies = 0;
+
+    // Actors spawned from now on only enter the scene after the update
+    mIsUpdatingActors = true;
+
+    // Physics first, then the rest of each actor's update
+    std::vector<RigidBodyComponent*> bodiesOnCamera;
+    std::vector<RigidBodyComponent*> bodiesNearCamera;
+    StepPhysics(actorsOnCamera, fullDeltaTimes, bodiesOnCamera);
+    if (!actorsNearCamera.empty()) {
+        StepPhysics(actorsNearCamera, reducedDeltaTimes, bodiesNearCamera);
+    }
+
+    // An actor whose body sleeps is at rest and skipped entirely: its
+    // components and OnUpdate have nothing to do until a force, a velocity or
+    // a contact wakes it (Block::OnBump does). Bodies woken during the physics
+    // step are awake again by now and update as usual.
     bool arePlayersOnCamera = false;
-    for (auto actor : actorsOnCamera)
+    for (size_t i = 0; i < actorsOnCamera.size(); ++i)
     {
-        actor->Update(deltaTime);
+        Actor* actor = actorsOnCamera[i];
+        if (!bodiesOnCamera[i] || !bodiesOnCamera[i]->IsSleeping()) {
+            actor->Update(deltaTime);
+        }
+        actor->SetLastUpdateFrame(frame);
         if (actor == mPlayer1 && actor == mPlayer2) {
             arePlayersOnCamera = true;
         }
     }
 
+    for (size_t i = 0; i < actorsNearCamera.size(); ++i)
+    {
+        if (!bodiesNearCamera[i] || !bodiesNearCamera[i]->IsSleeping()) {
+            actorsNearCamera[i]->Update(reducedDeltaTimes[i]);
+        }
+        actorsNearCamera[i]->SetLastUpdateFrame(frame);
+    }
+
     if (!arePlayersOnCamera && (mPlayer1 || mPlayer2)) {
+        // Players step through the same physics, so their contacts are
+        // dispatched like everyone else's
+        std::vector<Actor*> players;
         if(mPlayer1) {
-            mPlayer1->Update(deltaTime);
+            players.emplace_back(mPlayer1);
         }
         if(mPlayer2) {
-            mPlayer2->Update(deltaTime);
+            players.emplace_back(mPlayer2);
+        }
+
+        std::vector<RigidBodyComponent*> playerBodies;
+        StepPhysics(players, std::vector<float>(players.size(), deltaTime), playerBodies);
+
+        for (auto player : players) {
+            player->Update(deltaTime);
+            player->SetLastUpdateFrame(frame);
         }
     }
 
-    for (auto actor : actorsOnCamera)
+    mIsUpdatingActors = false;
+
+    // Every playhead advances at full rate, animations are cheap enough that
+    // actors off camera don't need to skip them
+    mAnimationSystem->Update(deltaTime);
+
+    FlushActorCommands();
+}
+
+void Game::ApplyUpdateBudget(std::vector<Actor*>& actors, int budget) const
+{
+    if (static_cast<int>(actors.size()) <= budget) {
+        return;
+    }
+
+    const Vector2 center = mCameraPos + Vector2(mWindowWidth / 2.0f, mWindowHeight / 2.0f);
+    std::nth_element(actors.begin(), actors.begin() + budget, actors.end(), [&center](Actor* a, Actor* b) {
+        return (a->GetPosition() - center).LengthSq() < (b->GetPosition() - center).LengthSq();
+    });
+    actors.resize(budget);
+}
+
+void Game::FlushActorCommands()
+{
+    std::vector<Actor*> spawns;
+    std::vector<Actor*> destroys;
+
+    // Deleting actors may queue more commands
+    while (mActorCommands.Take(spawns, destroys))
     {
-        if (actor->GetState() == ActorState::Destroy)
-        {
+        for (auto actor : spawns) {
+            mBroadPhase->Insert(actor);
+        }
+
+        for (auto actor : destroys) {
             delete actor;
-            if (actor == mPlayer1) {
-                mPlayer1 = nullptr;
+        }
+    }
+}
+
+void Game::StepPhysics(const std::vector<Actor*>& actors, const std::vector<float>& deltaTimes,
+                       std::vector<RigidBodyComponent*>& actorBodies)
+{
+    actorBodies.assign(actors.size(), nullptr);
+    mSteppedBodies.clear();
+    for (size_t i = 0; i < actors.size(); ++i)
+    {
+        if (actors[i]->GetState() != ActorState::Active) continue;
+
+        auto rigidBody = actors[i]->GetComponent<RigidBodyComponent>();
+        if (!rigidBody || !rigidBody->IsEnabled()) {
+            continue;
+        }
+        actorBodies[i] = rigidBody;
+
+        if (rigidBody->IsSleeping()) {
+            mNumSleepingBodies++;
+        } else {
+            mSteppedBodies.push_back({rigidBody, deltaTimes[i], 0, mSteppedBodies.size()});
+        }
+    }
+    mNumAwakeBodies += static_cast<int>(mSteppedBodies.size());
+
+    // Phase 1: forces and velocities only touch the body itself
+    auto& bodies = mSteppedBodies;
+    mJobSystem->ParallelFor(static_cast<int>(bodies.size()), 256, [&bodies](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            bodies[i].rigidBody->Integrate(bodies[i].deltaTime);
+        }
+    });
+
+    // Phase 2: split bodies into vertical strips. A body only sees colliders in
+    // its own and the neighbouring strips, so strips of the same parity can be
+    // resolved concurrently. Inside a strip bodies keep their update order.
+    for (auto& body : bodies) {
+        body.strip = static_cast<int>(std::floor(body.rigidBody->GetOwner()->GetPosition().x / PHYSICS_STRIP_WIDTH));
+    }
+    std::sort(bodies.begin(), bodies.end(), [](const SteppedBody& a, const SteppedBody& b) {
+        return a.strip != b.strip ? a.strip < b.strip : a.order < b.order;
+    });
+
+    // Batches are kept between steps so their event lists keep their memory
+    size_t numBatches = 0;
+    for (size_t i = 0; i < bodies.size(); ++i)
+    {
+        if (i == 0 || bodies[i].strip != bodies[i - 1].strip)
+        {
+            if (numBatches == mPhysicsBatches.size()) {
+                mPhysicsBatches.emplace_back();
             }
-            if (actor == mPlayer2) {
-                mPlayer2 = nullptr;
+            PhysicsBatch& batch = mPhysicsBatches[numBatches++];
+            batch.strip = bodies[i].strip;
+            batch.begin = i;
+            batch.events.clear();
+        }
+        mPhysicsBatches[numBatches - 1].end = i + 1;
+    }
+
+    mDeferReinserts = true;
+    for (int parity = 0; parity < 2; ++parity)
+    {
+        mPhysicsPass.clear();
+        for (size_t i = 0; i < numBatches; ++i) {
+            if ((mPhysicsBatches[i].strip & 1) == parity) {
+                mPhysicsPass.emplace_back(&mPhysicsBatches[i]);
             }
         }
+
+        auto& pass = mPhysicsPass;
+        mJobSystem->ParallelFor(static_cast<int>(pass.size()), 1, [&pass, &bodies](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                for (size_t j = pass[i]->begin; j < pass[i]->end; ++j) {
+                    bodies[j].rigidBody->Move(bodies[j].deltaTime, pass[i]->events);
+                }
+            }
+        });
+    }
+    mDeferReinserts = false;
+
+    // Merge in strip order, so the result doesn't depend on the number of workers
+    for (auto& body : bodies) {
+        Reinsert(body.rigidBody->GetOwner());
     }
+
+    // Gameplay only runs once every body has been resolved
+    mTouchingPairs.clear();
+    for (size_t i = 0; i < numBatches; ++i) {
+        for (auto& event : mPhysicsBatches[i].events) {
+            mTouchingPairs.push_back({event.actor, event.other, event.other->GetOwner(), event.normal});
+        }
+    }
+
+    mSteppedActors.clear();
+    for (auto& body : bodies) {
+        mSteppedActors.emplace_back(body.rigidBody->GetOwner());
+    }
+    std::sort(mSteppedActors.begin(), mSteppedActors.end());
+
+    DispatchContactEvents();
+}
+
+void Game::DispatchContactEvents()
+{
+    const std::vector<ContactPair>& touching = mTouchingPairs;
+
+    mPreviousContacts.clear();
+    for (const auto& pair : mContactPairs) {
+        mPreviousContacts.emplace_back(pair.actor, pair.other);
+    }
+    std::sort(mPreviousContacts.begin(), mPreviousContacts.end());
+
+    mCurrentContacts.clear();
+    for (const auto& pair : touching) {
+        mCurrentContacts.emplace_back(pair.actor, pair.other);
+    }
+    std::sort(mCurrentContacts.begin(), mCurrentContacts.end());
+    mCurrentContacts.erase(std::unique(mCurrentContacts.begin(), mCurrentContacts.end()), mCurrentContacts.end());
+    mIsContactSent.assign(mCurrentContacts.size(), 0);
+
+    mLastContactPairs.clear();
+    mLastContactPairs.swap(mContactPairs);
+
+    // Begin and stay, in the order the collisions were found
+    for (const auto& pair : touching)
+    {
+        const ContactKey key(pair.actor, pair.other);
+        const size_t index = std::lower_bound(mCurrentContacts.begin(), mCurrentContacts.end(), key) - mCurrentContacts.begin();
+        if (mIsContactSent[index]) {
+            continue;
+        }
+        mIsContactSent[index] = 1;
+
+        mContactPairs.push_back(pair);
+
+        if (std::binary_search(mPreviousContacts.begin(), mPreviousContacts.end(), key)) {
+            pair.actor->OnCollisionStay(pair.other, pair.normal);
+        } else {
+            // Whatever gets touched wakes up, in case it reacts to it
+            auto otherBody = pair.otherOwner->GetComponent<RigidBodyComponent>();
+            if (otherBody) {
+                otherBody->WakeUp();
+            }
+
+            pair.actor->OnCollisionBegin(pair.other, pair.normal);
+        }
+    }
+
+    // End, for stepped actors that no longer touch
+    for (const auto& pair : mLastContactPairs)
+    {
+        if (std::binary_search(mCurrentContacts.begin(), mCurrentContacts.end(), ContactKey(pair.actor, pair.other))) {
+            continue;
+        }
+
+        if (std::binary_search(mSteppedActors.begin(), mSteppedActors.end(), pair.actor)) {
+            pair.actor->OnCollisionEnd(pair.other);
+        } else {
+            mContactPairs.push_back(pair);
+        }
+    }
+}
+
+void Game::PurgeContactPairs(Actor* actor)
+{
+    mContactPairs.erase(std::remove_if(mContactPairs.begin(), mContactPairs.end(), [actor](const ContactPair& pair) {
+        return pair.actor == actor || pair.otherOwner == actor;
+    }), mContactPairs.end());
 }
 
 void Game::AddActor(Actor* actor)
 {
-    mSpatialHashing->Insert(actor);
+    if (mIsUpdatingActors) {
+        mActorCommands.Spawn(actor);
+        return;
+    }
+
+    mBroadPhase->Insert(actor);
 }
 
 void Game::RemoveActor(Actor* actor)
 {
-    mSpatialHashing->Remove(actor);
+    mActorCommands.Forget(actor);
+    PurgeContactPairs(actor);
+    mBroadPhase->Remove(actor);
 }
+
+void Game::DestroyActor(Actor* actor)
+{
+    mActorCommands.Destroy(actor);
+}
+
 void Game::Reinsert(Actor* actor)
 {
-    mSpatialHashing->Reinsert(actor);
+    if (mDeferReinserts) {
+        return;
+    }
+
+    // Actors spawned during the update are inserted at their final position
+    if (mIsUpdatingActors && mActorCommands.IsSpawnPending(actor)) {
+        return;
+    }
+
+    mBroadPhase->Reinsert(actor);
+}
+
+void Game::ResetBroadPhase(int width, int height)
+{
+    // Actors remove themselves from mBroadPhase while it deletes them
+    delete mBroadPhase;
+    mBroadPhase = new LayeredBroadPhase(mBroadPhaseType, TILE_SIZE * 4, width, height);
+}
+
+uint32_t Game::RegisterActor(Actor* actor)
+{
+    uint32_t id = mNextActorId++;
+    if (id >= mActorsById.size()) {
+        mActorsById.resize(id + 1, nullptr);
+    }
+    mActorsById[id] = actor;
+    return id;
+}
+
+void Game::UnregisterActor(Actor* actor)
+{
+    uint32_t id = actor->GetId();
+    if (id < mActorsById.size() && mActorsById[id] == actor) {
+        mActorsById[id] = nullptr;
+    }
+
+    if (actor == mPlayer1) {
+        mPlayer1 = nullptr;
+    }
+    if (actor == mPlayer2) {
+        mPlayer2 = nullptr;
+    }
+}
+
+namespace
+{
+    const uint32_t SNAPSHOT_MAGIC = 0x50414E53; // "SNAP"
+    const uint16_t SNAPSHOT_VERSION = 8;
+}
+
+// Layout: header, game state, RNG, then one record per actor in id order
+// (id, type, size of its spawn arguments and of its state, both blocks) and
+// the contact pairs as actor ids. Keeping the actors in id order lines the
+// records of consecutive snapshots up, which is what makes deltas small.
+void Game::SaveSnapshot(std::vector<uint8_t>& snapshot)
+{
+    SnapshotWriter writer(snapshot);
+
+    writer.Write(SNAPSHOT_MAGIC);
+    writer.Write(SNAPSHOT_VERSION);
+    writer.Write(mGameScene);
+
+    writer.Write(mGamePlayState);
+    writer.Write(mGameTimer);
+    writer.Write(mGameTimeLimit);
+    writer.Write(mCameraPos);
+    writer.Write(mPlayersLeaving);
+    writer.Write(mSceneManagerState);
+    writer.Write(mSceneManagerTimer);
+    writer.Write(mNextScene);
+    writer.Write(mNextActorId);
+    writer.Write(mSimulationFrame);
+    writer.Write(mFrameDeltaTimes);
+    writer.Write(Random::GetGenerator());
+
+    const size_t countOffset = writer.GetSize();
+    uint32_t numActors = 0;
+    writer.Write(numActors);
+
+    for (auto actor : mActorsById)
+    {
+        if (!actor || actor->GetType() == ActorType::Other) {
+            continue;
+        }
+
+        writer.Write(actor->GetId());
+        writer.Write(actor->GetType());
+
+        const size_t sizesOffset = writer.GetSize();
+        writer.Write<uint16_t>(0);
+        writer.Write<uint16_t>(0);
+
+        const size_t spawnStart = writer.GetSize();
+        actor->SaveSpawn(writer);
+        const size_t stateStart = writer.GetSize();
+        actor->SaveState(writer);
+
+        writer.Patch(sizesOffset, static_cast<uint16_t>(stateStart - spawnStart));
+        writer.Patch(sizesOffset + sizeof(uint16_t), static_cast<uint16_t>(writer.GetSize() - stateStart));
+        ++numActors;
+    }
+    writer.Patch(countOffset, numActors);
+
+    writer.Write(static_cast<uint32_t>(mContactPairs.size()));
+    for (const auto& pair : mContactPairs)
+    {
+        writer.Write(pair.actor->GetId());
+        writer.Write(pair.otherOwner->GetId());
+    }
+
+    writer.Finish();
+}
+
+bool Game::RestoreSnapshot(const std::vector<uint8_t>& snapshot)
+{
+    SnapshotReader reader(snapshot.data(), snapshot.size());
+
+    if (reader.Read<uint32_t>() != SNAPSHOT_MAGIC || reader.Read<uint16_t>() != SNAPSHOT_VERSION) {
+        SDL_Log("Invalid world snapshot");
+        return false;
+    }
+
+    if (reader.Read<GameScene>() != mGameScene) {
+        SDL_Log("World snapshot was taken in another scene");
+        return false;
+    }
+
+    // Read everything before touching the world, so a bad snapshot changes nothing
+    auto gamePlayState = reader.Read<GamePlayState>();
+    auto gameTimer = reader.Read<float>();
+    auto gameTimeLimit = reader.Read<int>();
+    auto cameraPos = reader.Read<Vector2>();
+    auto playersLeaving = reader.Read<int>();
+    auto sceneManagerState = reader.Read<SceneManagerState>();
+    auto sceneManagerTimer = reader.Read<float>();
+    auto nextScene = reader.Read<GameScene>();
+    auto nextActorId = reader.Read<uint32_t>();
+    auto simulationFrame = reader.Read<uint32_t>();
+    float frameDeltaTimes[REDUCED_RATE_INTERVAL];
+    for (auto& time : frameDeltaTimes) {
+        reader.Read(time);
+    }
+    auto generator = reader.Read<RandomStream>();
+
+    struct Record
+    {
+        uint32_t id;
+        ActorType type;
+        SnapshotReader spawn;
+        SnapshotReader state;
+    };
+
+    std::vector<Record> records;
+    auto numActors = reader.Read<uint32_t>();
+    for (uint32_t i = 0; i < numActors && !reader.IsFailed(); ++i)
+    {
+        auto id = reader.Read<uint32_t>();
+        auto type = reader.Read<ActorType>();
+        auto spawnSize = reader.Read<uint16_t>();
+        auto stateSize = reader.Read<uint16_t>();
+        SnapshotReader spawn = reader.Slice(spawnSize);
+        SnapshotReader state = reader.Slice(stateSize);
+
+        if (id >= nextActorId || (!records.empty() && id <= records.back().id) || type == ActorType::Other) {
+            reader.Read<uint8_t>(); // Bad record, fail below
+            break;
+        }
+        records.push_back({id, type, spawn, state});
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> contacts;
+    auto numContacts = reader.Read<uint32_t>();
+    for (uint32_t i = 0; i < numContacts && !reader.IsFailed(); ++i)
+    {
+        auto actorId = reader.Read<uint32_t>();
+        auto otherId = reader.Read<uint32_t>();
+        contacts.emplace_back(actorId, otherId);
+    }
+
+    if (reader.IsFailed() || records.size() != numActors || !reader.IsAtEnd()) {
+        SDL_Log("Corrupt world snapshot");
+        return false;
+    }
+
+    // Delete the actors created since the snapshot (or replaced by another type)
+    size_t next = 0;
+    for (uint32_t id = 0; id < mActorsById.size(); ++id)
+    {
+        Actor* actor = mActorsById[id];
+        if (!actor || actor->GetType() == ActorType::Other) {
+            continue;
+        }
+
+        while (next < records.size() && records[next].id < id) {
+            ++next;
+        }
+
+        if (next == records.size() || records[next].id != id || records[next].type != actor->GetType()) {
+            delete actor;
+        }
+    }
+
+    // Recreate the ones deleted since then with their old ids, then load every state
+    for (auto& record : records)
+    {
+        Actor* actor = record.id < mActorsById.size() ? mActorsById[record.id] : nullptr;
+        if (!actor)
+        {
+            mNextActorId = record.id;
+            actor = SpawnActor(record.type, record.spawn);
+            if (!actor) {
+                continue;
+            }
+        }
+
+        actor->LoadState(record.state);
+        if (record.state.IsFailed()) {
+            SDL_Log("World snapshot state of actor %u is incomplete", record.id);
+        }
+    }
+
+    mNextActorId = nextActorId;
+    mGamePlayState = gamePlayState;
+    mGameTimer = gameTimer;
+    mGameTimeLimit = gameTimeLimit;
+    mCameraPos = cameraPos;
+    mPlayersLeaving = playersLeaving;
+    mSceneManagerState = sceneManagerState;
+    mSceneManagerTimer = sceneManagerTimer;
+    mNextScene = nextScene;
+    mSimulationFrame = simulationFrame;
+    std::copy(std::begin(frameDeltaTimes), std::end(frameDeltaTimes), std::begin(mFrameDeltaTimes));
+    Random::SetGenerator(generator);
+
+    mPlayer1 = nullptr;
+    mPlayer2 = nullptr;
+    for (const auto& record : records)
+    {
+        if (record.type != ActorType::Mouse || !mActorsById[record.id]) {
+            continue;
+        }
+
+        auto mouse = static_cast<Mouse*>(mActorsById[record.id]);
+        if (mouse->IsPlayer1()) {
+            mPlayer1 = mouse;
+        } else {
+            mPlayer2 = mouse;
+        }
+    }
+
+    mContactPairs.clear();
+    for (const auto& contact : contacts)
+    {
+        Actor* actor = contact.first < mActorsById.size() ? mActorsById[contact.first] : nullptr;
+        Actor* otherOwner = contact.second < mActorsById.size() ? mActorsById[contact.second] : nullptr;
+        auto other = otherOwner ? otherOwner->GetComponent<AABBColliderComponent>() : nullptr;
+        if (actor && other) {
+            mContactPairs.push_back({actor, other, otherOwner});
+        }
+    }
+
+    return true;
+}
+
+Actor* Game::SpawnActor(ActorType type, SnapshotReader& spawn)
+{
+    switch (type)
+    {
+        case ActorType::Mouse:
+        {
+            auto isPlayer1 = spawn.Read<bool>();
+            auto forwardSpeed = spawn.Read<float>();
+            auto jumpSpeed = spawn.Read<float>();
+            return new Mouse(this, forwardSpeed, jumpSpeed, isPlayer1);
+        }
+        case ActorType::Block:
+        {
+            StringId texture(spawn.ReadString());
+            auto isStatic = spawn.Read<bool>();
+            return new Block(this, texture, isStatic);
+        }
+        case ActorType::Cheese:
+            return new Cheese(this);
+        case ActorType::Exit:
+            return new Exit(this);
+        case ActorType::Goomba:
+            return new Goomba(this, spawn.Read<float>());
+        default:
+            SDL_Log("Can't recreate actors of type %d", static_cast<int>(type));
+            return nullptr;
+    }
+}
+
+void Game::SaveQuickSnapshot()
+{
+    if (!mPlayer1 && !mPlayer2) {
+        return;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    SaveSnapshot(mQuickSnapshot);
+    float elapsedMs = static_cast<float>(SDL_GetPerformanceCounter() - start) * 1000.0f /
+                      static_cast<float>(SDL_GetPerformanceFrequency());
+
+    SDL_Log("Saved world snapshot: %zu bytes in %.3f ms", mQuickSnapshot.size(), elapsedMs);
+}
+
+void Game::RestoreQuickSnapshot()
+{
+    if (mQuickSnapshot.empty()) {
+        return;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    bool restored = RestoreSnapshot(mQuickSnapshot);
+    float elapsedMs = static_cast<float>(SDL_GetPerformanceCounter() - start) * 1000.0f /
+                      static_cast<float>(SDL_GetPerformanceFrequency());
+
+    if (restored) {
+        SDL_Log("Restored world snapshot in %.3f ms", elapsedMs);
+    }
 }
 
 std::vector<Actor *> Game::GetNearbyActors(const Vector2& position, const int range)
 {
-    return mSpatialHashing->Query(position, range);
+    return mBroadPhase->Query(position, range);
 }
 
-std::vector<AABBColliderComponent *> Game::GetNearbyColliders(const Vector2& position, const int range)
+std::vector<AABBColliderComponent *> Game::GetNearbyColliders(const Vector2& position, const int range,
+                                                              const uint32_t layerMask)
 {
-    return mSpatialHashing->QueryColliders(position, range);
+    std::vector<AABBColliderComponent*> colliders = mBroadPhase->QueryColliders(position, range, layerMask);
+
+    // Collisions resolve in a fixed order in netplay, see UpdateActors
+    if (mNetSession)
+    {
+        std::sort(colliders.begin(), colliders.end(), [](AABBColliderComponent* a, AABBColliderComponent* b) {
+            return a->GetOwner()->GetId() < b->GetOwner()->GetId();
+        });
+    }
+    return colliders;
 }
 
 void Game::GenerateOutput()
 {
-    // Clear frame with background color
-    SDL_SetRenderDrawColor(mRenderer, mBackgroundColor.x, mBackgroundColor.y, mBackgroundColor.z, 255);
-
-    // Clear back buffer
-    SDL_RenderClear(mRenderer);
+    std::vector<DrawComponent*> drawables = GetDrawablesOnCamera();
 
-    if (mBackgroundTexture)
+    if (mUseDirtyRects)
     {
-        SDL_Rect dstRect = { static_cast<int>(mBackgroundPosition.x),
-                             static_cast<int>(mBackgroundPosition.y),
-                             static_cast<int>(mBackgroundSize.x),
-                             static_cast<int>(mBackgroundSize.y) };
+        GenerateDirtyOutput(drawables);
+        return;
+    }
+
+    RenderFrame& frame = mRenderFrames.GetWriteFrame();
+    frame.Clear();
+    frame.SetTick(mTick);
+    RecordFrame(frame, drawables, {}, nullptr);
 
-        SDL_RenderCopy(mRenderer, mBackgroundTexture, nullptr, &dstRect);
+    // The render thread draws it when it gets to it
+    if (mUseSimulationThread)
+    {
+        mRenderFrames.Publish();
+        return;
     }
 
+    PresentFrame(frame);
+}
+
+void Game::PresentFrame(const RenderFrame& frame)
+{
+    // Clear back buffer with background color
+    const Vector3& color = frame.GetBackgroundColor();
+    SDL_SetRenderDrawColor(mRenderer, color.x, color.y, color.z, 255);
+    SDL_RenderClear(mRenderer);
+
+    RenderFrame::DrawCounts counts;
+    frame.Execute(mRenderer, counts);
+    Metrics::SetFrameDraws(counts.drawCalls, counts.textureChanges);
+
+    // Swap front buffer and back buffer
+    SDL_RenderPresent(mRenderer);
+}
+
+std::vector<DrawComponent*> Game::GetDrawablesOnCamera()
+{
     // Get actors on camera
     std::vector<Actor*> actorsOnCamera =
-            mSpatialHashing->QueryOnCamera(mCameraPos,mWindowWidth,mWindowHeight);
+            mBroadPhase->QueryOnCamera(mCameraPos,mWindowWidth,mWindowHeight);
+
+    // Cull drawables in parallel (each slot is written by a single job),
+    // then compact them into the list to draw
+    std::vector<DrawComponent*> visible(actorsOnCamera.size(), nullptr);
+    mJobSystem->ParallelFor(static_cast<int>(actorsOnCamera.size()), 512, [&actorsOnCamera, &visible](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+        {
+            auto drawable = actorsOnCamera[i]->GetComponent<DrawComponent>();
+            if (drawable && drawable->IsVisible())
+            {
+                visible[i] = drawable;
+            }
+        }
+    });
 
     // Get list of drawables in draw order
     std::vector<DrawComponent*> drawables;
+    drawables.reserve(visible.size());
 
-    for (auto actor : actorsOnCamera)
+    for (auto drawable : visible)
     {
-        auto drawable = actor->GetComponent<DrawComponent>();
-        if (drawable && drawable->IsVisible())
+        if (drawable)
         {
             drawables.emplace_back(drawable);
         }
     }
 
-    // Sort drawables by draw order
+    // Sort drawables by draw order, then by texture so sprites sharing
+    // an atlas page are drawn back to back
     std::sort(drawables.begin(), drawables.end(),
               [](const DrawComponent* a, const DrawComponent* b) {
-                  return a->GetDrawOrder() < b->GetDrawOrder();
+                  if (a->GetDrawOrder() != b->GetDrawOrder()) {
+                      return a->GetDrawOrder() < b->GetDrawOrder();
+                  }
+                  return a->GetTexture() < b->GetTexture();
               });
 
+    return drawables;
+}
+
+void Game::RecordFrame(RenderFrame& frame, const std::vector<DrawComponent*>& drawables,
+                       const std::vector<DrawState>& states, const SDL_Rect* clip)
+{
+    frame.SetBackgroundColor(mBackgroundColor);
+
+    if (mBackgroundTexture)
+    {
+        SDL_Rect dstRect = { static_cast<int>(mBackgroundPosition.x),
+                             static_cast<int>(mBackgroundPosition.y),
+                             static_cast<int>(mBackgroundSize.x),
+                             static_cast<int>(mBackgroundSize.y) };
+
+        frame.Copy(mBackgroundTexture, nullptr, dstRect);
+    }
+
     // Draw all drawables
-    for (auto drawable : drawables)
+    for (size_t i = 0; i < drawables.size(); ++i)
     {
-        drawable->Draw(mRenderer, mModColor);
+        if (clip && !SDL_HasIntersection(clip, &states[i].bounds)) {
+            continue;
+        }
+
+        drawables[i]->Draw(frame, mModColor);
     }
 
-    if (mPlayer1) mPlayer1->DrawBlockPreview(mRenderer);
-    if (mPlayer2) mPlayer2->DrawBlockPreview(mRenderer);
+    if (mPlayer1) mPlayer1->DrawBlockPreview(frame);
+    if (mPlayer2) mPlayer2->DrawBlockPreview(frame);
 
     // Draw all UI screens
     for (auto ui :mUIStack)
     {
-        ui->Draw(mRenderer);
+        ui->Draw(frame);
     }
 
     // Draw transition rect
     if (mSceneManagerState == SceneManagerState::Active)
     {
-        SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 255);
         SDL_Rect rect = { 0, 0, mWindowWidth, mWindowHeight };
+        frame.FillRect(rect, {0, 0, 0, 255});
+    }
+}
+
+void Game::GenerateDirtyOutput(const std::vector<DrawComponent*>& drawables)
+{
+    const bool transition = mSceneManagerState == SceneManagerState::Active;
+
+    // Whatever changes the whole picture redraws everything (including the
+    // camera scrolling, everything on screen moves then)
+    mDirtyRegions.Clear();
+    if (!mHasDrawnFrame || transition || mDrawnTransition ||
+        mCameraPos.x != mDrawnCameraPos.x || mCameraPos.y != mDrawnCameraPos.y ||
+        mModColor.x != mDrawnModColor.x || mModColor.y != mDrawnModColor.y || mModColor.z != mDrawnModColor.z ||
+        mBackgroundColor.x != mDrawnBackgroundColor.x || mBackgroundColor.y != mDrawnBackgroundColor.y ||
+        mBackgroundColor.z != mDrawnBackgroundColor.z || mBackgroundTexture != mDrawnBackgroundTexture ||
+        mUIStack != mDrawnUIStack)
+    {
+        mDirtyRegions.MarkFull();
+    }
+
+    // Drawables that appeared, changed or went away since the last frame
+    std::vector<DrawState> states(drawables.size());
+    std::unordered_map<const DrawComponent*, DrawState> drawStates;
+    drawStates.reserve(drawables.size());
+
+    for (size_t i = 0; i < drawables.size(); ++i)
+    {
+        states[i] = drawables[i]->GetDrawState();
+        drawStates.emplace(drawables[i], states[i]);
+
+        auto last = mDrawStates.find(drawables[i]);
+        if (last == mDrawStates.end()) {
+            mDirtyRegions.Add(states[i].bounds);
+        } else if (!(last->second == states[i])) {
+            mDirtyRegions.Add(last->second.bounds);
+            mDirtyRegions.Add(states[i].bounds);
+        }
+    }
+
+    for (const auto& last : mDrawStates)
+    {
+        if (drawStates.find(last.first) == drawStates.end()) {
+            mDirtyRegions.Add(last.second.bounds);
+        }
+    }
+    mDrawStates.swap(drawStates);
+
+    const Mouse* players[2] = {mPlayer1, mPlayer2};
+    for (int i = 0; i < 2; ++i)
+    {
+        SDL_Rect preview = players[i] ? players[i]->GetBlockPreviewRect() : SDL_Rect{0, 0, 0, 0};
+        if (!SDL_RectEquals(&preview, &mPreviewRects[i])) {
+            mDirtyRegions.Add(mPreviewRects[i]);
+            mDirtyRegions.Add(preview);
+            mPreviewRects[i] = preview;
+        }
+    }
+
+    for (auto ui : mUIStack) {
+        ui->AddDirtyRects(mDirtyRegions);
+    }
+
+    // The overlay of the last frame is painted over
+    for (const auto& rect : mOverlayRects) {
+        mDirtyRegions.Add(rect);
+    }
+
+    RenderFrame& frame = mRenderFrames.GetWriteFrame();
+    const std::vector<SDL_Rect>& rects = mDirtyRegions.GetRects();
+    RenderFrame::DrawCounts counts;
+    for (const auto& rect : rects)
+    {
+        SDL_RenderSetClipRect(mRenderer, &rect);
+        SDL_SetRenderDrawColor(mRenderer, mBackgroundColor.x, mBackgroundColor.y, mBackgroundColor.z, 255);
         SDL_RenderFillRect(mRenderer, &rect);
+
+        frame.Clear();
+        RecordFrame(frame, drawables, states, &rect);
+        frame.Execute(mRenderer, counts);
     }
+    SDL_RenderSetClipRect(mRenderer, nullptr);
 
-    // Swap front buffer and back buffer
-    SDL_RenderPresent(mRenderer);
+    Metrics::SetFrameDraws(counts.drawCalls, counts.textureChanges);
+    Metrics::Add(Metric::RedrawnPixels, mDirtyRegions.GetArea());
+
+    mOverlayRects.clear();
+    if (mShowDirtyRects)
+    {
+        SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_BLEND);
+        for (const auto& rect : rects)
+        {
+            SDL_SetRenderDrawColor(mRenderer, 255, 0, 0, 48);
+            SDL_RenderFillRect(mRenderer, &rect);
+            SDL_SetRenderDrawColor(mRenderer, 255, 0, 0, 255);
+            SDL_RenderDrawRect(mRenderer, &rect);
+        }
+        SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_NONE);
+        mOverlayRects = rects;
+    }
+
+    // Present only what was redrawn
+    SDL_RenderFlush(mRenderer);
+    if (mDirtyRegions.IsFull()) {
+        SDL_UpdateWindowSurface(mWindow);
+    } else if (!rects.empty()) {
+        SDL_UpdateWindowSurfaceRects(mWindow, rects.data(), static_cast<int>(rects.size()));
+    }
+
+    mHasDrawnFrame = true;
+    mDrawnTransition = transition;
+    mDrawnCameraPos = mCameraPos;
+    mDrawnModColor = mModColor;
+    mDrawnBackgroundColor = mBackgroundColor;
+    mDrawnBackgroundTexture = mBackgroundTexture;
+    mDrawnUIStack = mUIStack;
 }
 
 void Game::SetBackgroundImage(const std::string& texturePath, const Vector2 &position, const Vector2 &size)
 {
-    if (mBackgroundTexture) {
-        SDL_DestroyTexture(mBackgroundTexture);
-        mBackgroundTexture = nullptr;
-    }
-
     // Load background texture
-    mBackgroundTexture = LoadTexture(texturePath);
+    mBackgroundTexture = GetTexture(texturePath);
     if (!mBackgroundTexture) {
         SDL_Log("Failed to load background texture: %s", texturePath.c_str());
     }
@@ -802,55 +2180,65 @@ void Game::SetBackgroundImage(const std::string& texturePath, const Vector2 &pos
     mBackgroundSize.Set(size.x, size.y);
 }
 
-SDL_Texture* Game::LoadTexture(const std::string& texturePath)
+UIFont* Game::LoadFont(const std::string& fileName)
 {
-    SDL_Surface* surface = IMG_Load(texturePath.c_str());
-
-    if (!surface) {
-        SDL_Log("Failed to load image: %s", IMG_GetError());
-        return nullptr;
-    }
-
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(mRenderer, surface);
-    SDL_FreeSurface(surface);
-
-    if (!texture) {
-        SDL_Log("Failed to create texture: %s", SDL_GetError());
-        return nullptr;
-    }
+    return mAssets->GetFont(StringId(fileName));
+}
 
-    return texture;
+SDL_Texture* Game::GetTexture(const std::string& texturePath)
+{
+    return mAssets->GetTexture(StringId(texturePath));
 }
 
+SDL_Texture* Game::GetTexture(StringId texturePath)
+{
+    return mAssets->GetTexture(texturePath);
+}
 
-UIFont* Game::LoadFont(const std::string& fileName)
+const std::vector<SDL_Rect>& Game::GetSpriteSheetFrames(const std::string& dataPath)
 {
-    auto iter = mFonts.find(fileName);
-    if (iter != mFonts.end())
-    {
+    auto iter = mSpriteSheetFrames.find(dataPath);
+    if (iter != mSpriteSheetFrames.end()) {
         return iter->second;
     }
-    else
-    {
-        UIFont* font = new UIFont(mRenderer);
-        if (font->Load(fileName))
-        {
-            mFonts.emplace(fileName, font);
-        }
-        else
-        {
-            font->Unload();
-            delete font;
-            font = nullptr;
+
+    std::vector<SDL_Rect> frames;
+
+    std::ifstream spriteSheetFile(dataPath);
+    nlohmann::json spriteSheetData = nlohmann::json::parse(spriteSheetFile, nullptr, false);
+    if (spriteSheetData.is_discarded()) {
+        SDL_Log("Failed to parse sprite sheet data %s", dataPath.c_str());
+    } else {
+        for (const auto& frame : spriteSheetData["frames"]) {
+            frames.push_back({frame["frame"]["x"].get<int>(), frame["frame"]["y"].get<int>(),
+                              frame["frame"]["w"].get<int>(), frame["frame"]["h"].get<int>()});
         }
-        return font;
     }
+
+    return mSpriteSheetFrames.emplace(dataPath, std::move(frames)).first->second;
 }
 
 void Game::UnloadScene()
 {
-    // Delete actors
-    delete mSpatialHashing;
+    // Delete actors (running their destructors), then hand their memory
+    // back to the arena in one go. Pending spawns go into the broad phase first
+    // so they are deleted with the rest.
+    if (mBroadPhase) {
+        FlushActorCommands();
+    }
+    mContactPairs.clear();
+    delete mBroadPhase;
+    mBroadPhase = nullptr;
+
+    if (mSceneArena->GetBytesUsed() > 0) {
+        SDL_Log("Releasing scene arena: %zu KB in %zu slab(s)",
+                mSceneArena->GetBytesUsed() / 1024, mSceneArena->GetNumSlabs());
+    }
+    mSceneArena->Reset();
+
+    mActorsById.clear();
+    mNextActorId = 0;
+    mQuickSnapshot.clear();
 
     // Delete UI screens
     for (auto ui : mUIStack) {
@@ -858,26 +2246,43 @@ void Game::UnloadScene()
     }
     mUIStack.clear();
 
-    // Delete background texture
-    if (mBackgroundTexture) {
-        SDL_DestroyTexture(mBackgroundTexture);
-        mBackgroundTexture = nullptr;
-    }
+    // The background texture belongs to the asset manager
+    mBackgroundTexture = nullptr;
 }
 
 void Game::Shutdown()
 {
+    EndNetplay();
+
     UnloadScene();
 
-    for (auto font : mFonts) {
-        font.second->Unload();
-        delete font.second;
-    }
-    mFonts.clear();
+    // The simulation thread is gone, textures released from now on are
+    // destroyed right away
+    RenderResources::Shutdown();
+
+    delete mAssets;
+    mAssets = nullptr;
+    mSpriteSheetFrames.clear();
+    mSceneTemplates.clear();
+
+    delete mAnimationSystem;
+    mAnimationSystem = nullptr;
 
     delete mAudio;
     mAudio = nullptr;
 
+    delete mInput;
+    mInput = nullptr;
+
+    delete mAtlas;
+    mAtlas = nullptr;
+
+    delete mJobSystem;
+    mJobSystem = nullptr;
+
+    delete mSceneArena;
+    mSceneArena = nullptr;
+
     Mix_CloseAudio();
 
     Mix_Quit();
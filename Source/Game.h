@@ -8,10 +8,24 @@
 
 #pragma once
 #include <SDL.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <unordered_map>
+#include "ActorCommandBuffer.h"
 #include "AudioSystem.h"
+#include "BroadPhase.h"
+#include "Components/ColliderComponents/AABBColliderComponent.h"
+#include "DirtyRegions.h"
+#include "LevelGenerator.h"
 #include "Math.h"
+#include "NetSession.h"
+#include "Random.h"
+#include "RenderFrame.h"
+#include "SceneTemplate.h"
+
+enum class ActorType : uint8_t;
 
 class Game
 {
@@ -21,6 +35,26 @@ public:
     static const int TILE_SIZE = 32;
     static const int SPAWN_DISTANCE = 700;
     static const int TRANSITION_TIME = 1;
+    // Broad phase cells around a body that GetNearbyColliders looks at: 2 is a
+    // 5x5 block of cells, more than a step can cover at the speed caps
+    static const int COLLIDER_QUERY_RANGE = 2;
+    // Width of the vertical strips the physics resolution phase is split into.
+    // Must be wider than what a body can see through GetNearbyColliders.
+    static const int PHYSICS_STRIP_WIDTH = TILE_SIZE * 16;
+
+    // Simulation LOD. Actors on camera (plus a margin) update every frame,
+    // actors in a wider ring every REDUCED_RATE_INTERVAL frames with the time
+    // they missed, and actors further away are dormant. Each tier updates at
+    // most its budget of actors per frame, closest to the camera first.
+    static const int FULL_RATE_MARGIN = TILE_SIZE * 4;
+    static const int REDUCED_RATE_MARGIN = TILE_SIZE * 32;
+    static const int REDUCED_RATE_INTERVAL = 4;
+    static const int FULL_RATE_BUDGET = 4096;
+    static const int REDUCED_RATE_BUDGET = 512;
+
+    // Netplay simulates fixed ticks, so both sides step the same way
+    static constexpr float NET_TICK_TIME = 1.0f / 60.0f;
+    static const unsigned int NET_RANDOM_SEED = 0x4D6F7573;
 
     enum class GameScene
     {
@@ -28,7 +62,8 @@ public:
         Intro,
         Level1,
         Level2,
-        Level3
+        Level3,
+        Stress
     };
 
     enum class SceneManagerState
@@ -50,6 +85,35 @@ public:
 
     Game(int windowWidth, int windowHeight);
 
+    // Number of worker threads used by the actor update (0 = single-threaded).
+    // Must be called before Initialize.
+    void SetNumWorkerThreads(int numWorkers) { mNumWorkerThreads = numWorkers; }
+
+    // Spatial index used for the scenes. Must be called before Initialize.
+    void SetBroadPhaseType(BroadPhaseType type) { mBroadPhaseType = type; }
+
+    // Software rendering that only redraws the parts of the screen that
+    // changed (--dirty-rects). Must be called before Initialize.
+    void SetDirtyRectRendering(bool enabled) { mUseDirtyRects = enabled; }
+
+    // Run the simulation on its own thread, publishing a frame of draw calls
+    // every tick that this thread draws (--sim-thread). Not used with the
+    // dirty-rectangle renderer. Must be called before Initialize.
+    void SetSimulationThread(bool enabled) { mUseSimulationThread = enabled; }
+
+    // Memory the loose textures, fonts and sounds may take before unused ones
+    // are evicted (--asset-budget). Must be called before Initialize.
+    void SetAssetBudget(size_t bytes) { mAssetBudget = bytes; }
+
+    // Start in a generated stress level instead of the main menu (--stress).
+    // Must be called before Initialize.
+    void SetStressLevel(const LevelGeneratorParams& params) { mStressParams = params; mStartInStress = true; }
+
+    // Two-player rollback netplay with another process (--net-*): start in
+    // the first level, this side playing params.localPlayer. Must be called
+    // before Initialize.
+    void SetNetplay(const NetplayParams& params) { mNetplayParams = params; mUseNetplay = true; }
+
     bool Initialize();
     void RunLoop();
     void Shutdown();
@@ -59,24 +123,65 @@ public:
     void UpdateActors(float deltaTime);
     void AddActor(class Actor* actor);
     void RemoveActor(class Actor* actor);
-    void ProcessInputActors();
-    void HandleKeyPressActors(const int key, const bool isPressed);
+    // Queue an actor for deletion at the end of the actors update (see Actor::Destroy)
+    void DestroyActor(class Actor* actor);
 
     // Level functions
     void LoadMainMenu();
     void LoadLevel(const std::string& levelName, const int levelWidth, const int levelHeight);
+    void LoadStressLevel(const LevelGeneratorParams& params);
+
+    // Size of the current level in tiles
+    int GetLevelWidth() const { return mLevelWidth; }
+    int GetLevelHeight() const { return mLevelHeight; }
 
     std::vector<Actor *> GetNearbyActors(const Vector2& position, const int range = 1);
-    std::vector<class AABBColliderComponent *> GetNearbyColliders(const Vector2& position, const int range = 2);
+    std::vector<class AABBColliderComponent *> GetNearbyColliders(const Vector2& position, const int range = COLLIDER_QUERY_RANGE,
+                                                                  const uint32_t layerMask = ~0u);
 
     void Reinsert(Actor* actor);
 
+    // Rigid bodies stepped and skipped because they sleep during the last frame
+    int GetNumAwakeBodies() const { return mNumAwakeBodies; }
+    int GetNumSleepingBodies() const { return mNumSleepingBodies; }
+
+    // Frames simulated since the scene started, see UpdateActors
+    uint32_t GetSimulationFrame() const { return mSimulationFrame; }
+
+    // Give a new actor its id and forget it once deleted (called by Actor)
+    uint32_t RegisterActor(class Actor* actor);
+    void UnregisterActor(class Actor* actor);
+
+    // World snapshots: the dynamic state of the current scene (actors and
+    // their components, level timer, camera, scene transitions and RNG) as a
+    // compact binary blob. Actors created since the snapshot are deleted and
+    // the ones deleted are recreated. A snapshot can only be restored in the
+    // scene it was taken in. Netplay keeps one per tick for rolling back,
+    // mostly as SnapshotDeltas (see NetSession).
+    void SaveSnapshot(std::vector<uint8_t>& snapshot);
+    bool RestoreSnapshot(const std::vector<uint8_t>& snapshot);
+
+    // Replace the broad phase (deleting the actors it holds) with an empty
+    // one covering a width x height level
+    void ResetBroadPhase(int width, int height);
+    class BroadPhase* GetBroadPhase() { return mBroadPhase; }
+
     // Camera functions
     Vector2& GetCameraPos() { return mCameraPos; };
     void SetCameraPos(const Vector2& position) { mCameraPos = position; };
 
     // Audio functions
     class AudioSystem* GetAudio() { return mAudio; }
+    class InputSystem* GetInput() { return mInput; }
+
+    // Job system shared by physics, culling and asset loading
+    class JobSystem* GetJobSystem() { return mJobSystem; }
+
+    // Sprite atlas (empty if the atlas-packer output is missing)
+    class TextureAtlas* GetAtlas() { return mAtlas; }
+
+    // Shared animation clips and the playheads of animated actors
+    class AnimationSystem* GetAnimationSystem() { return mAnimationSystem; }
 
     // UI functions
     void PushUI(class UIScreen* screen) { mUIStack.emplace_back(screen);}
@@ -86,9 +191,14 @@ public:
     int GetWindowWidth() const { return mWindowWidth; }
     int GetWindowHeight() const { return mWindowHeight; }
 
-    // Loading functions
+    // Loading functions, cached by the asset manager (held until the scene ends)
     class UIFont* LoadFont(const std::string& fileName);
-    SDL_Texture* LoadTexture(const std::string& texturePath);
+    SDL_Texture* GetTexture(const std::string& texturePath);
+    SDL_Texture* GetTexture(StringId texturePath);
+    class AssetManager* GetAssets() { return mAssets; }
+
+    // Sprite sheet frames, parsed once and kept across scenes
+    const std::vector<SDL_Rect>& GetSpriteSheetFrames(const std::string& dataPath);
 
     void SetGameScene(GameScene scene, float transitionTime = .0f);
     void ResetGameScene(float transitionTime = .0f);
@@ -105,6 +215,12 @@ public:
         return mGameScene;
     }
 
+    // Scene that follows the given one when it ends (what gets prefetched)
+    GameScene GetNextScene(GameScene scene) const;
+
+    // Name of the scene's asset manifest
+    static const char* GetSceneName(GameScene scene);
+
     // Game-specific
     const class Mouse* GetPlayer1() { return mPlayer1; }
     const class Mouse* GetPlayer2() { return mPlayer2; }
@@ -123,11 +239,47 @@ public:
     }
 
 private:
+    // Input, update and output once per tick until the game quits. Runs on
+    // the simulation thread, or on this one without it.
+    void SimulationLoop();
+
     void ProcessInput();
     void UpdateGame();
     void UpdateCamera();
     void GenerateOutput();
 
+    // Drawables on camera, in draw order
+    std::vector<class DrawComponent*> GetDrawablesOnCamera();
+
+    // Record the background, the drawables, the UI and the transition. With
+    // a clip rect only the drawables whose state bounds touch it are recorded.
+    void RecordFrame(RenderFrame& frame, const std::vector<class DrawComponent*>& drawables,
+                     const std::vector<DrawState>& states, const SDL_Rect* clip);
+
+    // Clear the window, draw the frame and present it
+    void PresentFrame(const RenderFrame& frame);
+
+    // Render thread: queue the SDL events and key state for the simulation
+    void PumpEvents();
+
+    // Dirty-rectangle mode: redraw the areas whose content changed since the
+    // last frame into the window surface and present just those
+    void GenerateDirtyOutput(const std::vector<class DrawComponent*>& drawables);
+
+    // Netplay frame: roll back to the first tick simulated with a wrong
+    // prediction of the peer's input and simulate forward again, then
+    // simulate this frame's tick
+    void UpdateNetplay();
+
+    // One fixed tick of the level with both players' inputs for it
+    void SimulateNetTick(uint32_t tick);
+
+    // This side's input for the next tick, from the keyboard and mouse or the bot
+    NetInput ReadLocalNetInput();
+
+    // Log the session's stats and tell the peer we're leaving
+    void EndNetplay();
+
     // Scene Manager
     void UpdateSceneManager(float deltaTime);
     void ChangeScene();
@@ -139,29 +291,212 @@ private:
 
     // Load the level from a CSV file as a 2D array
     int **ReadLevelData(const std::string& fileName, int width, int height);
-    void BuildLevel(int** levelData, int width, int height);
+    SceneTemplate BuildSceneTemplate(int** levelData, int width, int height);
+    void InstantiateSceneTemplate(const SceneTemplate& sceneTemplate);
+
+    // Templates of the levels loaded so far, by level file
+    std::unordered_map<std::string, SceneTemplate> mSceneTemplates;
 
-    // Spatial Hashing for collision detection
-    class SpatialHashing* mSpatialHashing;
+    // Two-phase physics step: integrate every body, then move and resolve
+    // collisions in vertical strips (even strips in parallel, then odd ones)
+    // (each actor with its own delta time). Fills bodies with each actor's
+    // enabled rigid body, or null, so the rest of the update can skip sleepers.
+    void StepPhysics(const std::vector<class Actor*>& actors, const std::vector<float>& deltaTimes,
+                     std::vector<class RigidBodyComponent*>& bodies);
+
+    // Scratch of StepPhysics, kept to reuse its memory every step
+    struct SteppedBody
+    {
+        class RigidBodyComponent* rigidBody;
+        float deltaTime;
+        int strip;
+        size_t order; // Update order, kept inside a strip
+    };
+
+    // Consecutive bodies of mSteppedBodies in the same strip
+    struct PhysicsBatch
+    {
+        int strip;
+        size_t begin;
+        size_t end;
+        std::vector<CollisionEvent> events;
+    };
+
+    std::vector<SteppedBody> mSteppedBodies;
+    std::vector<PhysicsBatch> mPhysicsBatches;
+    std::vector<PhysicsBatch*> mPhysicsPass;
+
+    // Keep the budget actors closest to the camera
+    void ApplyUpdateBudget(std::vector<class Actor*>& actors, int budget) const;
+
+    // Reduced rate actors are split into phases by id, one phase updating per
+    // frame. Each gets the time since its own last update, summed from the
+    // delta times of the last REDUCED_RATE_INTERVAL frames.
+    uint32_t mSimulationFrame;
+    float mFrameDeltaTimes[REDUCED_RATE_INTERVAL];
+    // Actors updated at full rate this frame, sorted, kept to reuse its memory
+    std::vector<class Actor*> mFullRateActors;
+
+    int mNumAwakeBodies;
+    int mNumSleepingBodies;
+
+    // Memory for the actors and components of the current scene
+    class SceneArena* mSceneArena;
+
+    // Broad phase for collision detection
+    class BroadPhase* mBroadPhase;
+    BroadPhaseType mBroadPhaseType;
+
+    // Worker threads for the physics step
+    class JobSystem* mJobSystem;
+    int mNumWorkerThreads;
+
+    // While set, actors moved by the physics step are reinserted in bulk afterwards
+    bool mDeferReinserts;
+
+    // Actors spawned while the actors update (mIsUpdatingActors) and actors
+    // destroyed are queued here and applied by FlushActorCommands
+    void FlushActorCommands();
+    ActorCommandBuffer mActorCommands;
+    bool mIsUpdatingActors;
+
+    // An actor and a collider it touched during a physics step
+    struct ContactPair
+    {
+        class Actor* actor;
+        class AABBColliderComponent* other;
+        class Actor* otherOwner; // Lets pairs be purged without touching a deleted collider
+        Vector2 normal;          // Of the first collision of the pair during the step
+    };
+
+    // Send begin/stay/end events by comparing the pairs touching during this
+    // step (mTouchingPairs) with the previous ones. Pairs of actors that
+    // weren't stepped (not in mSteppedActors) are kept.
+    void DispatchContactEvents();
+
+    // Drop the pairs involving an actor that is going away
+    void PurgeContactPairs(class Actor* actor);
+
+    std::vector<ContactPair> mContactPairs;
+
+    // Scratch of DispatchContactEvents, kept to reuse its memory every step:
+    // the sorted pairs touching before and during the step, and which of the
+    // current ones were already sent
+    using ContactKey = std::pair<class Actor*, class AABBColliderComponent*>;
+    std::vector<ContactKey> mPreviousContacts;
+    std::vector<ContactKey> mCurrentContacts;
+    std::vector<char> mIsContactSent;
+    std::vector<ContactPair> mLastContactPairs;
+    std::vector<ContactPair> mTouchingPairs;
+    std::vector<class Actor*> mSteppedActors; // Sorted
+
+    // Recreate an actor of the given type from the arguments it saved
+    class Actor* SpawnActor(ActorType type, class SnapshotReader& spawn);
+
+    // Quick save (F5) and load (F9) of the current level
+    void SaveQuickSnapshot();
+    void RestoreQuickSnapshot();
+
+    // Live actors by id (null once deleted) and the id the next one gets
+    std::vector<class Actor*> mActorsById;
+    uint32_t mNextActorId;
+
+    std::vector<uint8_t> mQuickSnapshot;
 
     // All the UI elements
     std::vector<class UIScreen*> mUIStack;
-    std::unordered_map<std::string, class UIFont*> mFonts;
+
+    // Loose textures, fonts and sounds, held per scene
+    class AssetManager* mAssets;
+    size_t mAssetBudget;
+
+    // Sprite sheet frames, loaded once
+    std::unordered_map<std::string, std::vector<SDL_Rect>> mSpriteSheetFrames;
 
     // SDL stuff
     SDL_Window* mWindow;
     SDL_Renderer* mRenderer;
     AudioSystem* mAudio;
+    class InputSystem* mInput;
+    class TextureAtlas* mAtlas;
+    class AnimationSystem* mAnimationSystem;
 
     // Window properties
     int mWindowWidth;
     int mWindowHeight;
 
+    // Simulation thread. Frames go through the triple buffer, events and the
+    // key state are pumped here and taken by the next tick.
+    bool mUseSimulationThread;
+    std::thread mSimulationThread;
+    std::atomic<bool> mIsSimulating;
+    RenderFrameBuffer mRenderFrames;
+    std::mutex mEventMutex;
+    std::vector<SDL_Event> mPendingEvents;
+    std::vector<Uint8> mPendingKeyboardState;
+    std::vector<SDL_Event> mEvents;
+    std::vector<Uint8> mKeyboardState;
+
+    // Ticks simulated so far
+    uint32_t mTick;
+
+    // Dirty-rectangle rendering: what was drawn last frame and the overlay
+    // of redrawn areas (F2), which has to be painted over the next frame
+    bool mUseDirtyRects;
+    bool mShowDirtyRects;
+    bool mHasDrawnFrame;
+    DirtyRegions mDirtyRegions;
+    std::unordered_map<const class DrawComponent*, DrawState> mDrawStates;
+    SDL_Rect mPreviewRects[2];
+    std::vector<SDL_Rect> mOverlayRects;
+    std::vector<class UIScreen*> mDrawnUIStack;
+    Vector2 mDrawnCameraPos;
+    Vector3 mDrawnModColor;
+    Vector3 mDrawnBackgroundColor;
+    SDL_Texture* mDrawnBackgroundTexture;
+    bool mDrawnTransition;
+
+    // Level size in tiles (LEVEL_WIDTH x LEVEL_HEIGHT but for stress levels)
+    int mLevelWidth;
+    int mLevelHeight;
+
+    LevelGeneratorParams mStressParams;
+    bool mStartInStress;
+
+    // Netplay session, the next tick to simulate, the next confirmed state to
+    // checksum, a left click waiting for the next tick and where the pointer
+    // last was
+    NetplayParams mNetplayParams;
+    bool mUseNetplay;
+    class NetSession* mNetSession;
+    uint32_t mNetTick;
+    uint32_t mNetCheckedTick;
+    std::vector<uint8_t> mNetState;
+    bool mNetCastSpell;
+    int16_t mNetPointerX;
+    int16_t mNetPointerY;
+
+    // Scripted input of --net-bot: actions held for a random number of ticks
+    RandomStream mNetBot;
+    uint32_t mNetBotActions;
+    int mNetBotTicks;
+
+    struct NetplayStats
+    {
+        uint32_t rollbacks = 0;
+        uint32_t resimulatedTicks = 0;
+        uint32_t maxRollbackTicks = 0;
+        uint64_t rollbackUs = 0;
+        uint64_t maxRollbackUs = 0;
+        uint32_t stalledFrames = 0;
+    };
+    NetplayStats mNetStats;
+
     // Track elapsed time since game start
     Uint32 mTicksCount;
 
     // Track actors state
-    bool mIsRunning;
+    std::atomic<bool> mIsRunning;
     GamePlayState mGamePlayState;
 
     // Track level state
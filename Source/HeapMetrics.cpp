@@ -0,0 +1,183 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+// Count heap allocations for the heap_allocations metric by replacing the
+// global operator new and delete. Only the game links this file: tools,
+// benchmarks and tests built on the engine library keep the default ones.
+// Actors and components come from the scene arena and don't show up here.
+
+#include "Metrics.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    // What malloc already guarantees, larger alignments need their own calls
+    const std::size_t DEFAULT_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    void* AllocateAligned(std::size_t size, std::size_t alignment)
+    {
+#ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+#else
+        void* ptr = nullptr;
+        if (alignment < sizeof(void*)) {
+            alignment = sizeof(void*);
+        }
+        return posix_memalign(&ptr, alignment, size) == 0 ? ptr : nullptr;
+#endif
+    }
+
+    void FreeAligned(void* ptr)
+    {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+    // Like the default operator new: retry through the new handler until the
+    // allocation succeeds, throw once there is no handler left
+    void* Allocate(std::size_t size, std::size_t alignment)
+    {
+        Metrics::Add(Metric::HeapAllocations);
+
+        if (size == 0) {
+            size = 1;
+        }
+
+        while (true)
+        {
+            void* ptr = alignment > DEFAULT_ALIGNMENT ? AllocateAligned(size, alignment) : std::malloc(size);
+            if (ptr) {
+                return ptr;
+            }
+
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void* AllocateNoThrow(std::size_t size, std::size_t alignment) noexcept
+    {
+        try {
+            return Allocate(size, alignment);
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    void Free(void* ptr, std::size_t alignment) noexcept
+    {
+        if (alignment > DEFAULT_ALIGNMENT) {
+            FreeAligned(ptr);
+        } else {
+            std::free(ptr);
+        }
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    return Allocate(size, DEFAULT_ALIGNMENT);
+}
+
+void* operator new[](std::size_t size)
+{
+    return Allocate(size, DEFAULT_ALIGNMENT);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return AllocateNoThrow(size, DEFAULT_ALIGNMENT);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return AllocateNoThrow(size, DEFAULT_ALIGNMENT);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+    Free(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    Free(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    Free(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    Free(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    Free(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    Free(ptr, DEFAULT_ALIGNMENT);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+    Free(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+    Free(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    Free(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    Free(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    Free(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    Free(ptr, static_cast<std::size_t>(alignment));
+}
@@ -0,0 +1,231 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "InputSystem.h"
+#include "Actors/Actor.h"
+#include <algorithm>
+
+InputSystem::InputSystem()
+    :mIsDispatching(false)
+    ,mHeldActions{}
+    ,mKeyboardState(nullptr)
+    ,mPointerMoved(false)
+    ,mPointerX(0)
+    ,mPointerY(0)
+    ,mPlayerInputs{}
+{
+    BindDefaults();
+}
+
+void InputSystem::Bind(int player, InputAction action, SDL_Scancode scancode)
+{
+    if (player < 0 || player >= MAX_PLAYERS || action == InputAction::Count) {
+        SDL_Log("Invalid input binding for player %d", player);
+        return;
+    }
+
+    mBindings.push_back({scancode, player, action});
+}
+
+void InputSystem::ClearBindings()
+{
+    mBindings.clear();
+}
+
+void InputSystem::BindDefaults()
+{
+    ClearBindings();
+
+    Bind(0, InputAction::MoveLeft, SDL_SCANCODE_A);
+    Bind(0, InputAction::MoveRight, SDL_SCANCODE_D);
+    Bind(0, InputAction::Jump, SDL_SCANCODE_W);
+    Bind(0, InputAction::Crouch, SDL_SCANCODE_S);
+    Bind(0, InputAction::ToggleSpell, SDL_SCANCODE_X);
+
+    Bind(1, InputAction::MoveLeft, SDL_SCANCODE_LEFT);
+    Bind(1, InputAction::MoveRight, SDL_SCANCODE_RIGHT);
+    Bind(1, InputAction::Jump, SDL_SCANCODE_UP);
+    Bind(1, InputAction::Crouch, SDL_SCANCODE_DOWN);
+    Bind(1, InputAction::ToggleSpell, SDL_SCANCODE_M);
+}
+
+void InputSystem::Subscribe(Actor* actor, int player)
+{
+    Unsubscribe(actor);
+    mSubscribers.push_back({actor, player});
+}
+
+void InputSystem::Unsubscribe(Actor* actor)
+{
+    for (auto& subscriber : mSubscribers)
+    {
+        if (subscriber.actor == actor) {
+            // Removed after the dispatch if one is running
+            subscriber.actor = nullptr;
+        }
+    }
+
+    if (!mIsDispatching) {
+        mSubscribers.erase(std::remove_if(mSubscribers.begin(), mSubscribers.end(),
+                                          [](const Subscriber& s) { return s.actor == nullptr; }),
+                           mSubscribers.end());
+    }
+}
+
+void InputSystem::BeginFrame()
+{
+    mEvents.clear();
+    mPointerMoved = false;
+
+    for (auto& input : mPlayerInputs) {
+        input.isSet = false;
+    }
+}
+
+void InputSystem::SetPlayerInput(int player, uint32_t actions, uint32_t previousActions,
+                                 bool pointerMoved, int pointerX, int pointerY)
+{
+    if (player < 0 || player >= MAX_PLAYERS) {
+        return;
+    }
+
+    mPlayerInputs[player] = {true, actions, pointerMoved, pointerX, pointerY};
+
+    const uint32_t changed = actions ^ previousActions;
+    for (int i = 0; i < static_cast<int>(InputAction::Count); ++i)
+    {
+        const auto action = static_cast<InputAction>(i);
+        if (changed & ActionBit(action)) {
+            mEvents.push_back({player, action, (actions & ActionBit(action)) != 0});
+        }
+    }
+}
+
+uint32_t InputSystem::ReadKeyboardActions(int player) const
+{
+    const Uint8* state = mKeyboardState ? mKeyboardState : SDL_GetKeyboardState(nullptr);
+
+    uint32_t actions = 0;
+    for (const auto& binding : mBindings)
+    {
+        if (binding.player == player && state[binding.scancode]) {
+            actions |= ActionBit(binding.action);
+        }
+    }
+    return actions;
+}
+
+bool InputSystem::GetPointerMotion(int& x, int& y) const
+{
+    x = mPointerX;
+    y = mPointerY;
+    return mPointerMoved;
+}
+
+void InputSystem::HandleEvent(const SDL_Event& event)
+{
+    switch (event.type)
+    {
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+        {
+            // Key repeats are not new presses
+            bool isPressed = event.type == SDL_KEYDOWN;
+            if (isPressed && event.key.repeat != 0) {
+                break;
+            }
+
+            for (const auto& binding : mBindings)
+            {
+                if (binding.scancode == event.key.keysym.scancode) {
+                    mEvents.push_back({binding.player, binding.action, isPressed});
+                }
+            }
+            break;
+        }
+        case SDL_MOUSEMOTION:
+            mPointerMoved = true;
+            mPointerX = event.motion.x;
+            mPointerY = event.motion.y;
+            break;
+        default:
+            break;
+    }
+}
+
+void InputSystem::UpdateHeldActions()
+{
+    const Uint8* state = mKeyboardState ? mKeyboardState : SDL_GetKeyboardState(nullptr);
+
+    for (int player = 0; player < MAX_PLAYERS; ++player) {
+        mHeldActions[player] = mPlayerInputs[player].isSet ? mPlayerInputs[player].actions : 0;
+    }
+
+    for (const auto& binding : mBindings)
+    {
+        if (!mPlayerInputs[binding.player].isSet && state[binding.scancode]) {
+            mHeldActions[binding.player] |= ActionBit(binding.action);
+        }
+    }
+}
+
+void InputSystem::Dispatch()
+{
+    UpdateHeldActions();
+
+    mIsDispatching = true;
+
+    // Subscribers added while dispatching wait for the next frame
+    const size_t numSubscribers = mSubscribers.size();
+    for (size_t i = 0; i < numSubscribers; ++i)
+    {
+        // Copy, the callbacks may subscribe new actors
+        Subscriber subscriber = mSubscribers[i];
+        if (!subscriber.actor || subscriber.actor->GetState() != ActorState::Active) {
+            continue;
+        }
+
+        for (const auto& event : mEvents)
+        {
+            if (event.player == subscriber.player && mSubscribers[i].actor) {
+                subscriber.actor->OnActionEvent(event.action, event.isPressed);
+            }
+        }
+
+        if (!mSubscribers[i].actor) {
+            continue;
+        }
+
+        subscriber.actor->OnActionInput(*this, subscriber.player);
+
+        if (!mSubscribers[i].actor) {
+            continue;
+        }
+
+        const PlayerInput& input = mPlayerInputs[subscriber.player];
+        if (input.isSet) {
+            if (input.pointerMoved) {
+                subscriber.actor->OnPointerMoved(input.pointerX, input.pointerY);
+            }
+        } else if (mPointerMoved) {
+            subscriber.actor->OnPointerMoved(mPointerX, mPointerY);
+        }
+    }
+
+    mIsDispatching = false;
+
+    // Drop whatever was unsubscribed during the dispatch
+    mSubscribers.erase(std::remove_if(mSubscribers.begin(), mSubscribers.end(),
+                                      [](const Subscriber& s) { return s.actor == nullptr; }),
+                       mSubscribers.end());
+}
+
+bool InputSystem::IsHeld(int player, InputAction action) const
+{
+    if (player < 0 || player >= MAX_PLAYERS) {
+        return false;
+    }
+
+    return (mHeldActions[player] & ActionBit(action)) != 0;
+}
@@ -0,0 +1,120 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <SDL.h>
+
+// Gameplay actions, independent of the keys they are bound to
+enum class InputAction : uint8_t
+{
+    MoveLeft,
+    MoveRight,
+    Jump,
+    Crouch,
+    ToggleSpell,
+    Count
+};
+
+// Maps keys to actions per player and delivers them to the actors that
+// subscribed, instead of handing the raw keyboard to every actor on camera.
+//
+// Each frame Game calls BeginFrame, feeds every SDL event to HandleEvent and
+// then calls Dispatch, which sends subscribers the pressed/released edges of
+// their player's actions, one OnActionInput call to poll held actions and,
+// if the pointer moved, a single OnPointerMoved with its last position.
+class InputSystem
+{
+public:
+    static const int MAX_PLAYERS = 2;
+
+    InputSystem();
+
+    // Bindings (the defaults are WASD + X for player 1, arrows + M for player 2)
+    void Bind(int player, InputAction action, SDL_Scancode scancode);
+    void ClearBindings();
+    void BindDefaults();
+
+    void Subscribe(class Actor* actor, int player);
+    void Unsubscribe(class Actor* actor);
+
+    void BeginFrame();
+    void HandleEvent(const SDL_Event& event);
+    void Dispatch();
+
+    // Held state of the action as of the last Dispatch
+    bool IsHeld(int player, InputAction action) const;
+
+    // Netplay: the player's held actions (bit per InputAction) come from the
+    // given ones instead of the keyboard, its edges from comparing them with
+    // the previous tick's, and its pointer motion only reaches its own
+    // subscribers. Applies to the next Dispatch, BeginFrame clears it.
+    void SetPlayerInput(int player, uint32_t actions, uint32_t previousActions,
+                        bool pointerMoved, int pointerX, int pointerY);
+
+    // Actions bound for the player that are held on the keyboard right now
+    uint32_t ReadKeyboardActions(int player) const;
+
+    // Last pointer position this frame, false if it didn't move
+    bool GetPointerMotion(int& x, int& y) const;
+
+    // Key state Dispatch reads the held actions from, SDL's when null. Set
+    // when the events are pumped on another thread than the dispatch.
+    void SetKeyboardState(const Uint8* state) { mKeyboardState = state; }
+
+private:
+    struct Binding
+    {
+        SDL_Scancode scancode;
+        int player;
+        InputAction action;
+    };
+
+    struct Subscriber
+    {
+        class Actor* actor;
+        int player;
+    };
+
+    struct ActionEvent
+    {
+        int player;
+        InputAction action;
+        bool isPressed;
+    };
+
+    struct PlayerInput
+    {
+        bool isSet;
+        uint32_t actions;
+        bool pointerMoved;
+        int pointerX;
+        int pointerY;
+    };
+
+    static uint32_t ActionBit(InputAction action) { return 1u << static_cast<uint32_t>(action); }
+
+    void UpdateHeldActions();
+
+    std::vector<Binding> mBindings;
+    std::vector<Subscriber> mSubscribers;
+    bool mIsDispatching;
+
+    // Edges queued by HandleEvent since BeginFrame
+    std::vector<ActionEvent> mEvents;
+
+    // Bit per InputAction
+    uint32_t mHeldActions[MAX_PLAYERS];
+    const Uint8* mKeyboardState;
+
+    // Last pointer position this frame (motion events are coalesced)
+    bool mPointerMoved;
+    int mPointerX;
+    int mPointerY;
+
+    // Players driven by SetPlayerInput this frame
+    PlayerInput mPlayerInputs[MAX_PLAYERS];
+};
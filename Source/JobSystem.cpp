@@ -0,0 +1,233 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "JobSystem.h"
+
+namespace
+{
+    // Index of the queue owned by the current thread (0 for non-workers)
+    thread_local int tQueueIndex = 0;
+}
+
+JobSystem::JobSystem(int numWorkers)
+    :mMainThreadId(std::this_thread::get_id())
+    ,mQueuedJobs(0)
+    ,mIsRunning(true)
+{
+    numWorkers = numWorkers < 0 ? 0 : numWorkers;
+
+    for (int i = 0; i < numWorkers + 1; ++i) {
+        mQueues.emplace_back(new WorkQueue());
+    }
+
+    for (int i = 0; i < numWorkers; ++i) {
+        mWorkers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mIsRunning = false;
+    }
+    mWorkAvailable.notify_all();
+
+    for (auto& worker : mWorkers) {
+        worker.join();
+    }
+    mWorkers.clear();
+}
+
+void JobSystem::Run(std::function<void()> job, JobCounter* counter, JobCounter* dependsOn)
+{
+    if (counter) {
+        counter->mValue.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (dependsOn)
+    {
+        std::lock_guard<std::mutex> lock(dependsOn->mMutex);
+        if (dependsOn->GetValue() != 0)
+        {
+            // Released by Finish once the dependency completes
+            dependsOn->mContinuations.emplace_back([this, job = std::move(job), counter]() mutable {
+                Push({std::move(job), counter});
+            });
+            return;
+        }
+    }
+
+    Push({std::move(job), counter});
+}
+
+void JobSystem::Push(Job job)
+{
+    if (mWorkers.empty()) {
+        Execute(job);
+        return;
+    }
+
+    {
+        WorkQueue& queue = *mQueues[tQueueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.emplace_back(std::move(job));
+    }
+
+    mQueuedJobs.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+    }
+    mWorkAvailable.notify_one();
+}
+
+bool JobSystem::PopOrSteal(int index, Job& job)
+{
+    // Newest job from our own queue first (its data is likely still in cache)
+    {
+        WorkQueue& own = *mQueues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            mQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Otherwise steal the oldest job of another queue
+    int numQueues = static_cast<int>(mQueues.size());
+    for (int i = 1; i < numQueues; ++i)
+    {
+        WorkQueue& victim = *mQueues[(index + i) % numQueues];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            mQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::Execute(Job& job)
+{
+    job.func();
+    Finish(job.counter);
+}
+
+void JobSystem::Finish(JobCounter* counter)
+{
+    if (!counter) {
+        return;
+    }
+
+    std::vector<std::function<void()>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->mMutex);
+        if (counter->mValue.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        continuations.swap(counter->mContinuations);
+    }
+
+    // The counter may already be gone here, only touch the continuations
+
+    for (auto& continuation : continuations) {
+        continuation();
+    }
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    const bool isMainThread = IsMainThread();
+
+    while (!counter.IsDone())
+    {
+        if (isMainThread) {
+            PumpMainThreadJobs();
+        }
+
+        Job job;
+        if (PopOrSteal(tQueueIndex, job)) {
+            Execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::ParallelFor(int count, int grainSize, const std::function<void(int, int)>& func)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    grainSize = grainSize < 1 ? 1 : grainSize;
+
+    // Not worth going through the queues for a single chunk
+    if (mWorkers.empty() || count <= grainSize) {
+        func(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (int begin = 0; begin < count; begin += grainSize)
+    {
+        int end = begin + grainSize < count ? begin + grainSize : count;
+        Run([&func, begin, end]() { func(begin, end); }, &counter);
+    }
+
+    Wait(counter);
+}
+
+void JobSystem::RunOnMainThread(std::function<void()> job, JobCounter* counter)
+{
+    if (counter) {
+        counter->mValue.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (IsMainThread()) {
+        Job inlineJob = {std::move(job), counter};
+        Execute(inlineJob);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMainThreadMutex);
+    mMainThreadJobs.push_back({std::move(job), counter});
+}
+
+void JobSystem::PumpMainThreadJobs()
+{
+    std::vector<Job> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mMainThreadMutex);
+        jobs.swap(mMainThreadJobs);
+    }
+
+    for (auto& job : jobs) {
+        Execute(job);
+    }
+}
+
+void JobSystem::WorkerLoop(int index)
+{
+    tQueueIndex = index;
+
+    while (mIsRunning)
+    {
+        Job job;
+        if (PopOrSteal(index, job)) {
+            Execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mWorkAvailable.wait(lock, [this]() {
+            return !mIsRunning || mQueuedJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
@@ -0,0 +1,113 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Tracks a group of jobs. It counts down as jobs finish, and other jobs can
+// be scheduled to start once it reaches zero.
+class JobCounter
+{
+public:
+    JobCounter() : mValue(0) {}
+
+    // Takes the lock, so a counter seen as done is no longer touched by the
+    // job that finished it and can safely go out of scope
+    bool IsDone()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mValue.load(std::memory_order_acquire) == 0;
+    }
+
+    int GetValue() const { return mValue.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> mValue;
+
+    // Guards reaching zero and the jobs waiting for it
+    std::mutex mMutex;
+    std::vector<std::function<void()>> mContinuations;
+};
+
+// Work-stealing job scheduler. Each worker owns a deque: it pushes and pops
+// its own jobs at the back and steals from the front of the others' deques
+// when it runs dry. Threads that aren't workers (the main thread) push to a
+// shared deque. SDL calls must stay on the main thread, so jobs can also be
+// queued for it and are run when Game pumps them once per frame.
+//
+// With zero workers every job runs inline on the calling thread.
+class JobSystem
+{
+public:
+    explicit JobSystem(int numWorkers = 0);
+    ~JobSystem();
+
+    int GetNumWorkers() const { return static_cast<int>(mWorkers.size()); }
+
+    // Schedule a job. The counter (optional) is incremented now and
+    // decremented when the job finishes. If dependsOn is given, the job is
+    // held back until that counter reaches zero.
+    void Run(std::function<void()> job, JobCounter* counter = nullptr, JobCounter* dependsOn = nullptr);
+
+    // Block until the counter reaches zero, running other jobs meanwhile
+    // (and main-thread jobs, when called from the main thread)
+    void Wait(JobCounter& counter);
+
+    // Calls func(begin, end) over [0, count) split into chunks of at most
+    // grainSize items, and returns once every chunk ran. Without workers the
+    // whole range is a single call.
+    void ParallelFor(int count, int grainSize, const std::function<void(int, int)>& func);
+
+    // Queue a job that must run on the main thread (e.g. anything touching SDL)
+    void RunOnMainThread(std::function<void()> job, JobCounter* counter = nullptr);
+
+    // Run the jobs queued for the main thread. Called by Game every frame.
+    void PumpMainThreadJobs();
+
+    bool IsMainThread() const { return std::this_thread::get_id() == mMainThreadId; }
+
+private:
+    struct Job
+    {
+        std::function<void()> func;
+        JobCounter* counter = nullptr;
+    };
+
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void WorkerLoop(int index);
+
+    void Push(Job job);
+    bool PopOrSteal(int index, Job& job);
+    void Execute(Job& job);
+    void Finish(JobCounter* counter);
+
+    // Queue 0 is shared by non-worker threads, queue i + 1 belongs to worker i
+    std::vector<std::unique_ptr<WorkQueue>> mQueues;
+    std::vector<std::thread> mWorkers;
+
+    std::mutex mMainThreadMutex;
+    std::vector<Job> mMainThreadJobs;
+    std::thread::id mMainThreadId;
+
+    // Idle workers sleep until a job is pushed
+    std::mutex mSleepMutex;
+    std::condition_variable mWorkAvailable;
+    std::atomic<int> mQueuedJobs;
+    std::atomic<bool> mIsRunning;
+};
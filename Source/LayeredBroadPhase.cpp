@@ -0,0 +1,121 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "LayeredBroadPhase.h"
+#include "Metrics.h"
+#include "Actors/Actor.h"
+
+LayeredBroadPhase::LayeredBroadPhase(BroadPhaseType type, int cellSize, int width, int height)
+    : BroadPhase(cellSize, width, height)
+{
+    for (auto& bucket : mBuckets) {
+        bucket = BroadPhase::Create(type, cellSize, width, height);
+    }
+}
+
+LayeredBroadPhase::~LayeredBroadPhase()
+{
+    // Each bucket deletes its actors, which remove themselves through Remove
+    for (auto& bucket : mBuckets) {
+        delete bucket;
+        bucket = nullptr;
+    }
+
+    mActorBuckets.clear();
+}
+
+int LayeredBroadPhase::GetBucket(Actor* actor)
+{
+    auto collider = actor->GetComponent<AABBColliderComponent>();
+    return collider ? static_cast<int>(collider->GetLayer()) : NUM_COLLIDER_LAYERS;
+}
+
+void LayeredBroadPhase::Insert(Actor* actor)
+{
+    Metrics::Add(Metric::SpatialInserts);
+
+    int bucket = GetBucket(actor);
+    mBuckets[bucket]->Insert(actor);
+    mActorBuckets[actor] = bucket;
+}
+
+void LayeredBroadPhase::Remove(Actor* actor)
+{
+    auto iter = mActorBuckets.find(actor);
+    if (iter != mActorBuckets.end())
+    {
+        if (mBuckets[iter->second]) {
+            mBuckets[iter->second]->Remove(actor);
+        }
+        mActorBuckets.erase(iter);
+    }
+}
+
+void LayeredBroadPhase::Reinsert(Actor* actor)
+{
+    auto iter = mActorBuckets.find(actor);
+    if (iter == mActorBuckets.end())
+    {
+        Insert(actor);
+        return;
+    }
+
+    Metrics::Add(Metric::SpatialReinserts);
+    mBuckets[iter->second]->Reinsert(actor);
+}
+
+std::vector<Actor*> LayeredBroadPhase::Query(const Vector2& position, const int range) const
+{
+    std::vector<Actor*> results;
+
+    for (auto bucket : mBuckets)
+    {
+        auto actors = bucket->Query(position, range);
+        results.insert(results.end(), actors.begin(), actors.end());
+    }
+
+    Metrics::Add(Metric::BroadPhaseQueries);
+    Metrics::Add(Metric::BroadPhaseCandidates, results.size());
+    return results;
+}
+
+std::vector<Actor*> LayeredBroadPhase::QueryOnCamera(const Vector2& cameraPosition,
+                                                     const float screenWidth,
+                                                     const float screenHeight,
+                                                     const float extraRadius) const
+{
+    std::vector<Actor*> results;
+
+    for (auto bucket : mBuckets)
+    {
+        auto actors = bucket->QueryOnCamera(cameraPosition, screenWidth, screenHeight, extraRadius);
+        results.insert(results.end(), actors.begin(), actors.end());
+    }
+
+    Metrics::Add(Metric::BroadPhaseQueries);
+    Metrics::Add(Metric::BroadPhaseCandidates, results.size());
+    return results;
+}
+
+std::vector<AABBColliderComponent*> LayeredBroadPhase::QueryColliders(const Vector2& position, const int range,
+                                                                      const uint32_t layerMask) const
+{
+    std::vector<AABBColliderComponent*> results;
+
+    for (int layer = 0; layer < NUM_COLLIDER_LAYERS; ++layer)
+    {
+        if (!(layerMask & (1u << layer))) {
+            continue;
+        }
+
+        // Every actor in a layer bucket has a collider of that layer
+        for (auto actor : mBuckets[layer]->Query(position, range)) {
+            results.push_back(actor->GetComponent<AABBColliderComponent>());
+        }
+    }
+
+    Metrics::Add(Metric::BroadPhaseQueries);
+    Metrics::Add(Metric::BroadPhaseCandidates, results.size());
+    return results;
+}
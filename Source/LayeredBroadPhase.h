@@ -0,0 +1,42 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <unordered_map>
+#include "BroadPhase.h"
+#include "Components/ColliderComponents/AABBColliderComponent.h"
+
+// Keeps one broad phase per collider layer (plus one for actors without a
+// collider), so collider queries only visit the layers in their mask. The
+// blocks, which are most of a level, are never enumerated by queries that
+// don't ask for them.
+class LayeredBroadPhase : public BroadPhase
+{
+public:
+    LayeredBroadPhase(BroadPhaseType type, int cellSize, int width, int height);
+    ~LayeredBroadPhase() override;
+
+    void Insert(class Actor* actor) override;
+    void Remove(class Actor* actor) override;
+    void Reinsert(class Actor* actor) override;
+
+    std::vector<class Actor*> Query(const Vector2& position, const int range = 1) const override;
+    std::vector<class Actor*> QueryOnCamera(const Vector2& cameraPosition,
+                                            const float screenWidth,
+                                            const float screenHeight,
+                                            const float extraRadius = 0.0f) const override;
+
+    std::vector<AABBColliderComponent*> QueryColliders(const Vector2& position, const int range = 1,
+                                                       const uint32_t layerMask = ~0u) const override;
+
+private:
+    static const int NUM_BUCKETS = NUM_COLLIDER_LAYERS + 1;
+
+    // Layer index of the actor's collider, or the last bucket if it has none
+    static int GetBucket(class Actor* actor);
+
+    BroadPhase* mBuckets[NUM_BUCKETS];
+    std::unordered_map<class Actor*, int> mActorBuckets; // Maps actor to the bucket holding it
+};
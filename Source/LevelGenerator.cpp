@@ -0,0 +1,190 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "LevelGenerator.h"
+#include "CommandLine.h"
+#include "Random.h"
+#include <SDL.h>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+std::vector<int> LevelGenerator::Generate(const LevelGeneratorParams& params)
+{
+    const int width = params.width;
+    const int height = params.height;
+    if (width < MIN_WIDTH || height < MIN_HEIGHT) {
+        SDL_Log("Stress level must be at least %d x %d tiles", MIN_WIDTH, MIN_HEIGHT);
+        return {};
+    }
+    if (width > MAX_WIDTH || height > MAX_HEIGHT || static_cast<int64_t>(width) * height > MAX_TILES) {
+        SDL_Log("Stress level must be at most %d x %d and %d tiles", MAX_WIDTH, MAX_HEIGHT, MAX_TILES);
+        return {};
+    }
+
+    std::vector<int> tiles(static_cast<size_t>(width) * height, LevelTile::Empty);
+    auto at = [&tiles, width](int x, int y) -> int& { return tiles[static_cast<size_t>(y) * width + x]; };
+
+    RandomStream root(params.seed);
+    RandomStream groundStream = root.Fork();
+    RandomStream clusterStream = root.Fork();
+    RandomStream goombaStream = root.Fork();
+    RandomStream cheeseStream = root.Fork();
+
+    const int ground = height - 1;
+
+    // Ground with pits, walls on both ends
+    for (int x = 0; x < width; ++x) {
+        at(x, ground) = LevelTile::Grass;
+    }
+
+    for (int x = SAFE_COLUMNS; x < width - SAFE_COLUMNS; ++x)
+    {
+        if (groundStream.GetFloat() < params.pitChance) {
+            int pitWidth = groundStream.GetIntRange(2, 4);
+            for (int i = 0; i < pitWidth && x < width - SAFE_COLUMNS; ++i, ++x) {
+                at(x, ground) = LevelTile::Empty;
+            }
+        }
+    }
+
+    for (int y = 0; y < ground; ++y) {
+        at(0, y) = LevelTile::Wall;
+        at(width - 1, y) = LevelTile::Wall;
+    }
+
+    // Block clusters, leaving the two rows over the ground free to walk on
+    const int blockTypes[] = {LevelTile::BlockC, LevelTile::BlockF, LevelTile::Rock,
+                              LevelTile::BlockI, LevelTile::BlockH, LevelTile::BlockG};
+    const int maxClusterSize = std::max(params.maxClusterSize, 1);
+    const int clusterTop = 1;
+    const int clusterBottom = ground - 3;
+
+    for (int i = 0; i < params.numClusters && clusterBottom >= clusterTop; ++i)
+    {
+        int clusterWidth = clusterStream.GetIntRange(1, maxClusterSize);
+        int clusterHeight = clusterStream.GetIntRange(1, std::max(maxClusterSize / 2, 1));
+        int left = clusterStream.GetIntRange(SAFE_COLUMNS, width - SAFE_COLUMNS - 1);
+        int top = clusterStream.GetIntRange(clusterTop, clusterBottom);
+        int block = blockTypes[clusterStream.GetIntRange(0, 5)];
+
+        for (int y = top; y < std::min(top + clusterHeight, clusterBottom + 1); ++y)
+        {
+            for (int x = left; x < std::min(left + clusterWidth, width - SAFE_COLUMNS); ++x)
+            {
+                if (clusterStream.GetFloat() < params.clusterFill) {
+                    at(x, y) = block;
+                }
+            }
+        }
+    }
+
+    at(SAFE_COLUMNS / 4, ground - 1) = LevelTile::Player;
+    at(width - SAFE_COLUMNS / 2, ground - 1) = LevelTile::Exit;
+
+    // Goombas and cheese in free tiles (goombas fall to whatever is below)
+    auto scatter = [&](RandomStream& stream, int count, int tile, const char* name)
+    {
+        int placed = 0;
+        const long long maxAttempts = static_cast<long long>(count) * 32;
+        for (long long attempt = 0; attempt < maxAttempts && placed < count; ++attempt)
+        {
+            int x = stream.GetIntRange(SAFE_COLUMNS, width - SAFE_COLUMNS - 1);
+            int y = stream.GetIntRange(1, ground - 1);
+            if (at(x, y) == LevelTile::Empty) {
+                at(x, y) = tile;
+                placed++;
+            }
+        }
+
+        if (placed < count) {
+            SDL_Log("Only found room for %d of %d %s", placed, count, name);
+        }
+    };
+
+    scatter(goombaStream, params.numGoombas, LevelTile::Goomba, "goombas");
+    scatter(cheeseStream, params.numCheese, LevelTile::Cheese, "cheese");
+
+    return tiles;
+}
+
+bool LevelGenerator::WriteCSV(const std::string& fileName, const std::vector<int>& tiles, int width, int height)
+{
+    if (tiles.size() != static_cast<size_t>(width) * height) {
+        SDL_Log("Level size doesn't match its tiles: %d x %d", width, height);
+        return false;
+    }
+
+    std::ofstream file(fileName);
+    if (!file.is_open()) {
+        SDL_Log("Failed to write level: %s", fileName.c_str());
+        return false;
+    }
+
+    std::string line;
+    for (int y = 0; y < height; ++y)
+    {
+        line.clear();
+        for (int x = 0; x < width; ++x)
+        {
+            if (x > 0) {
+                line += ',';
+            }
+            line += std::to_string(tiles[static_cast<size_t>(y) * width + x]);
+        }
+        file << line << '\n';
+    }
+
+    return file.good();
+}
+
+bool LevelGenerator::ParseOption(int argc, char** argv, int& i, LevelGeneratorParams& params, bool& isValid)
+{
+    const char* option = argv[i];
+    const bool isSize = strcmp(option, "--stress-size") == 0;
+    const bool isSeed = strcmp(option, "--stress-seed") == 0;
+    int* count = nullptr;
+    if (strcmp(option, "--stress-goombas") == 0) {
+        count = &params.numGoombas;
+    } else if (strcmp(option, "--stress-cheese") == 0) {
+        count = &params.numCheese;
+    } else if (strcmp(option, "--stress-clusters") == 0) {
+        count = &params.numClusters;
+    } else if (!isSize && !isSeed) {
+        return false;
+    }
+
+    if (i + 1 >= argc) {
+        SDL_Log("Missing value for %s", option);
+        isValid = false;
+        return true;
+    }
+    const char* value = argv[++i];
+
+    if (isSize) {
+        const char* separator = strchr(value, 'x');
+        const std::string width = separator ? std::string(value, separator) : std::string();
+        if (!separator || !CommandLine::ParseInt(width.c_str(), MIN_WIDTH, MAX_WIDTH, params.width) ||
+            !CommandLine::ParseInt(separator + 1, MIN_HEIGHT, MAX_HEIGHT, params.height) ||
+            static_cast<int64_t>(params.width) * params.height > MAX_TILES) {
+            SDL_Log("Invalid stress level size %s (expected WxH, from %dx%d to %dx%d and at most %d tiles)",
+                    value, MIN_WIDTH, MIN_HEIGHT, MAX_WIDTH, MAX_HEIGHT, MAX_TILES);
+            isValid = false;
+        }
+    }
+    else if (isSeed) {
+        if (!CommandLine::ParseUInt64(value, params.seed)) {
+            SDL_Log("Invalid stress level seed %s (expected a number)", value);
+            isValid = false;
+        }
+    }
+    else if (!CommandLine::ParseInt(value, 0, INT_MAX, *count)) {
+        SDL_Log("Invalid value %s for %s (expected a count of 0 or more)", value, option);
+        isValid = false;
+    }
+
+    return true;
+}
@@ -0,0 +1,74 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Tile IDs of the level CSV files, as read by Game::BuildSceneTemplate
+namespace LevelTile
+{
+    const int Empty = -1;
+    const int Grass = 0;
+    const int BlockC = 1;
+    const int BlockF = 2;
+    const int Cheese = 3;
+    const int Rock = 4;
+    const int BlockI = 6;
+    const int Wall = 8; // Invisible
+    const int BlockH = 9;
+    const int Goomba = 10;
+    const int BlockG = 12;
+    const int Exit = 13;
+    const int Player = 16;
+}
+
+struct LevelGeneratorParams
+{
+    int width = 2000;
+    int height = 20;
+    uint64_t seed = 1;
+    int numGoombas = 1000;
+    int numCheese = 500;
+    // Rectangles of blocks floating over the ground
+    int numClusters = 400;
+    int maxClusterSize = 8;
+    float clusterFill = 0.75f;
+    // Chance of a ground column starting a pit
+    float pitChance = 0.02f;
+};
+
+// Procedural stress levels for scaling tests. The same parameters always
+// give the same level, and each feature (ground, clusters, goombas, cheese)
+// draws from its own stream, so changing the goomba count doesn't move the
+// blocks around. Used by the stress scene (--stress) and the level-generator
+// tool, which writes the level as a CSV file like the shipped ones.
+class LevelGenerator
+{
+public:
+    // Tiles in row-major order (height rows of width tiles), empty if the
+    // level is smaller than MIN_WIDTH x MIN_HEIGHT or larger than the maximums
+    static std::vector<int> Generate(const LevelGeneratorParams& params);
+
+    static bool WriteCSV(const std::string& fileName, const std::vector<int>& tiles, int width, int height);
+
+    // Parse the generator option at argv[i] (--stress-size WxH, --stress-seed,
+    // --stress-goombas, --stress-cheese, --stress-clusters), advancing i past
+    // its value. Returns false if argv[i] isn't one of them. A missing,
+    // malformed or out of range value is logged and clears isValid.
+    static bool ParseOption(int argc, char** argv, int& i, LevelGeneratorParams& params, bool& isValid);
+
+    static const int MIN_WIDTH = 32;
+    static const int MIN_HEIGHT = 8;
+    // Every tile can become an actor, so the area is capped as well
+    static const int MAX_WIDTH = 65536;
+    static const int MAX_HEIGHT = 1024;
+    static const int MAX_TILES = 1 << 22;
+
+private:
+    // Tiles at the start and end of the level kept clear for the player and the exit
+    static const int SAFE_COLUMNS = 12;
+};
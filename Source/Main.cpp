@@ -6,20 +6,114 @@
 // See LICENSE in root directory for full details.
 // ----------------------------------------------------------------
 #define SDL_MAIN_HANDLED
+#include <cstring>
+#include <string>
+#include "CommandLine.h"
 #include "Game.h"
+#include "LevelGenerator.h"
+#include "Metrics.h"
+#include "NetSession.h"
 
 //Screen dimension constants
 const int SCREEN_WIDTH = 960;
 const int SCREEN_HEIGHT = 640;
 
+// Largest --threads accepted
+const int MAX_WORKER_THREADS = 256;
+
+// Largest --asset-budget accepted, in MB
+const int MAX_ASSET_BUDGET_MB = 65536;
+
 int main(int argc, char** argv)
 {
     Game game = Game(SCREEN_WIDTH, SCREEN_HEIGHT);
+    LevelGeneratorParams stressParams;
+    bool stress = false;
+    NetplayParams netplayParams;
+    bool netplay = false;
+    bool areOptionsValid = true;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        // --threads N: worker threads for the actor update
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            int numWorkers = 0;
+            if (CommandLine::ParseInt(argv[++i], 0, MAX_WORKER_THREADS, numWorkers)) {
+                game.SetNumWorkerThreads(numWorkers);
+            } else {
+                SDL_Log("Invalid thread count %s (expected 0 to %d)", argv[i], MAX_WORKER_THREADS);
+                areOptionsValid = false;
+            }
+        }
+        // --broadphase grid|sap|tree: spatial index used for the scenes
+        else if (strcmp(argv[i], "--broadphase") == 0 && i + 1 < argc) {
+            BroadPhaseType type;
+            if (BroadPhase::ParseType(argv[++i], type)) {
+                game.SetBroadPhaseType(type);
+            } else {
+                SDL_Log("Unknown broad phase %s, using the grid", argv[i]);
+            }
+        }
+        // --metrics file.csv|file.jsonl: write the engine metrics of every frame
+        else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            Metrics::Open(argv[++i]);
+        }
+        // --dirty-rects: software renderer that only redraws what changed (F2 shows it)
+        else if (strcmp(argv[i], "--dirty-rects") == 0) {
+            game.SetDirtyRectRendering(true);
+        }
+        // --sim-thread: simulate on a separate thread from the rendering
+        else if (strcmp(argv[i], "--sim-thread") == 0) {
+            game.SetSimulationThread(true);
+        }
+        // --asset-budget MB: memory for loose textures, fonts and sounds before unused ones are evicted
+        else if (strcmp(argv[i], "--asset-budget") == 0 && i + 1 < argc) {
+            int budget = 0;
+            if (CommandLine::ParseInt(argv[++i], 1, MAX_ASSET_BUDGET_MB, budget)) {
+                game.SetAssetBudget(static_cast<size_t>(budget) * 1024 * 1024);
+            } else {
+                SDL_Log("Invalid asset budget %s (expected 1 to %d MB)", argv[i], MAX_ASSET_BUDGET_MB);
+                areOptionsValid = false;
+            }
+        }
+        // --stress [--stress-size WxH] [--stress-seed N] [--stress-goombas N] ...:
+        // start in a generated level (see LevelGenerator)
+        else if (strcmp(argv[i], "--stress") == 0) {
+            stress = true;
+        }
+        else if (LevelGenerator::ParseOption(argc, argv, i, stressParams, areOptionsValid)) {
+            stress = true;
+        }
+        // --net-player 1|2 [--net-port N] [--net-peer host:port] [--net-latency MS] ...:
+        // two-player rollback netplay, one process per player (see NetSession)
+        else if (NetSession::ParseOption(argc, argv, i, netplayParams, areOptionsValid)) {
+            netplay = true;
+        }
+    }
+
+    if (!areOptionsValid) {
+        SDL_Log("Usage: tp-final [--threads N] [--broadphase grid|sap|tree] [--metrics FILE] [--dirty-rects]"
+                " [--sim-thread] [--asset-budget MB] [--stress [--stress-size WxH] [--stress-seed N]"
+                " [--stress-goombas N] [--stress-cheese N] [--stress-clusters N]]"
+                " [--net-player 1|2 [--net-port N] [--net-peer HOST:PORT] [--net-latency MS]"
+                " [--net-loss PERCENT] [--net-bot SEED] [--net-ticks N]]");
+        Metrics::Close();
+        return 1;
+    }
+
+    if (stress) {
+        game.SetStressLevel(stressParams);
+    }
+    if (netplay) {
+        game.SetNetplay(netplayParams);
+    }
+
     bool success = game.Initialize();
     if (success)
     {
         game.RunLoop();
     }
     game.Shutdown();
+    Metrics::Close();
     return 0;
 }
@@ -45,6 +45,22 @@ const Matrix4 Matrix4::Identity(m4Ident);
 const Quaternion Quaternion::Identity(0.0f, 0.0f, 0.0f, 1.0f);
 
 Vector2 Vector2::Transform(const Vector2& vec, const Matrix3& mat, float w /*= 1.0f*/)
+{
+#ifdef MATH_SIMD
+	// x * row0 + y * row1 + w * row2, on the xy lanes only
+	__m128 r = _mm_mul_ps(_mm_set1_ps(vec.x), _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(mat.mat[0]))));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(vec.y), _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(mat.mat[1])))));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(w), _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(mat.mat[2])))));
+
+	Vector2 retVal;
+	_mm_store_sd(reinterpret_cast<double*>(&retVal.x), _mm_castps_pd(r));
+	return retVal;
+#else
+	return TransformScalar(vec, mat, w);
+#endif
+}
+
+Vector2 Vector2::TransformScalar(const Vector2& vec, const Matrix3& mat, float w /*= 1.0f*/)
 {
 	Vector2 retVal;
 	retVal.x = vec.x * mat.mat[0][0] + vec.y * mat.mat[1][0] + w * mat.mat[2][0];
@@ -53,7 +69,62 @@ Vector2 Vector2::Transform(const Vector2& vec, const Matrix3& mat, float w /*= 1
 	return retVal;
 }
 
+void Vector2::TransformBatch(const Vector2* in, Vector2* out, size_t count, const Matrix3& mat, float w /*= 1.0f*/)
+{
+	size_t i = 0;
+
+#ifdef MATH_SIMD
+	// Two vectors per register: [x0 y0 x1 y1] * [m00 m01 m00 m01] and so on
+	const __m128 row0 = _mm_setr_ps(mat.mat[0][0], mat.mat[0][1], mat.mat[0][0], mat.mat[0][1]);
+	const __m128 row1 = _mm_setr_ps(mat.mat[1][0], mat.mat[1][1], mat.mat[1][0], mat.mat[1][1]);
+	const __m128 row2 = _mm_setr_ps(w * mat.mat[2][0], w * mat.mat[2][1], w * mat.mat[2][0], w * mat.mat[2][1]);
+
+#ifdef MATH_SIMD_AVX2
+	// And four per register with AVX2
+	const __m256 row0x4 = _mm256_set_m128(row0, row0);
+	const __m256 row1x4 = _mm256_set_m128(row1, row1);
+	const __m256 row2x4 = _mm256_set_m128(row2, row2);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m256 v = _mm256_loadu_ps(&in[i].x);
+		__m256 r = _mm256_mul_ps(_mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0)), row0x4);
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1)), row1x4));
+		_mm256_storeu_ps(&out[i].x, _mm256_add_ps(r, row2x4));
+	}
+#endif
+
+	for (; i + 2 <= count; i += 2)
+	{
+		const __m128 v = _mm_loadu_ps(&in[i].x);
+		__m128 r = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0)), row0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1)), row1));
+		_mm_storeu_ps(&out[i].x, _mm_add_ps(r, row2));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		out[i] = TransformScalar(in[i], mat, w);
+	}
+}
+
 Vector3 Vector3::Transform(const Vector3& vec, const Matrix4& mat, float w /*= 1.0f*/)
+{
+#ifdef MATH_SIMD
+	const __m128 v = _mm_setr_ps(vec.x, vec.y, vec.z, w);
+	__m128 r = MathSIMD::CombineRows(v, _mm_loadu_ps(mat.mat[0]), _mm_loadu_ps(mat.mat[1]),
+	                                 _mm_loadu_ps(mat.mat[2]), _mm_loadu_ps(mat.mat[3]));
+
+	Vector3 retVal;
+	MathSIMD::Store3(&retVal.x, r);
+	return retVal;
+#else
+	return TransformScalar(vec, mat, w);
+#endif
+}
+
+Vector3 Vector3::TransformScalar(const Vector3& vec, const Matrix4& mat, float w /*= 1.0f*/)
 {
 	Vector3 retVal;
 	retVal.x = vec.x * mat.mat[0][0] + vec.y * mat.mat[1][0] +
@@ -66,6 +137,31 @@ Vector3 Vector3::Transform(const Vector3& vec, const Matrix4& mat, float w /*= 1
 	return retVal;
 }
 
+void Vector3::TransformBatch(const Vector3* in, Vector3* out, size_t count, const Matrix4& mat, float w /*= 1.0f*/)
+{
+#ifdef MATH_SIMD
+	// The rows are loaded once for the whole batch
+	const __m128 row0 = _mm_loadu_ps(mat.mat[0]);
+	const __m128 row1 = _mm_loadu_ps(mat.mat[1]);
+	const __m128 row2 = _mm_loadu_ps(mat.mat[2]);
+	const __m128 row3 = _mm_mul_ps(_mm_set1_ps(w), _mm_loadu_ps(mat.mat[3]));
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const __m128 v = MathSIMD::Load3(&in[i].x);
+		__m128 r = _mm_mul_ps(_mm_shuffle_ps(v, v, 0x00), row0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, 0x55), row1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, 0xAA), row2));
+		MathSIMD::Store3(&out[i].x, _mm_add_ps(r, row3));
+	}
+#else
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = TransformScalar(in[i], mat, w);
+	}
+#endif
+}
+
 // This will transform the vector and renormalize the w component
 Vector3 Vector3::TransformWithPerspDiv(const Vector3& vec, const Matrix4& mat, float w /*= 1.0f*/)
 {
@@ -97,6 +193,99 @@ Vector3 Vector3::Transform(const Vector3& v, const Quaternion& q)
 }
 
 void Matrix4::Invert()
+{
+#ifdef MATH_SIMD
+	// Same cofactor expansion as InvertScalar, four cofactors at a time
+	// (after Intel's "Streaming SIMD Extensions - Inverse of 4x4 Matrix")
+	float* src = &mat[0][0];
+	__m128 minor0, minor1, minor2, minor3;
+	__m128 row0, row1, row2, row3;
+	__m128 det, tmp1;
+
+	// Load the transpose
+	tmp1 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(src)),
+	                    reinterpret_cast<const __m64*>(src + 4));
+	row1 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(src + 8)),
+	                    reinterpret_cast<const __m64*>(src + 12));
+	row0 = _mm_shuffle_ps(tmp1, row1, 0x88);
+	row1 = _mm_shuffle_ps(row1, tmp1, 0xDD);
+	tmp1 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(src + 2)),
+	                    reinterpret_cast<const __m64*>(src + 6));
+	row3 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(src + 10)),
+	                    reinterpret_cast<const __m64*>(src + 14));
+	row2 = _mm_shuffle_ps(tmp1, row3, 0x88);
+	row3 = _mm_shuffle_ps(row3, tmp1, 0xDD);
+
+	// Cofactors
+	tmp1 = _mm_mul_ps(row2, row3);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	minor0 = _mm_mul_ps(row1, tmp1);
+	minor1 = _mm_mul_ps(row0, tmp1);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor0 = _mm_sub_ps(_mm_mul_ps(row1, tmp1), minor0);
+	minor1 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor1);
+	minor1 = _mm_shuffle_ps(minor1, minor1, 0x4E);
+
+	tmp1 = _mm_mul_ps(row1, row2);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	minor0 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor0);
+	minor3 = _mm_mul_ps(row0, tmp1);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row3, tmp1));
+	minor3 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor3);
+	minor3 = _mm_shuffle_ps(minor3, minor3, 0x4E);
+
+	tmp1 = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4E), row3);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	row2 = _mm_shuffle_ps(row2, row2, 0x4E);
+	minor0 = _mm_add_ps(_mm_mul_ps(row2, tmp1), minor0);
+	minor2 = _mm_mul_ps(row0, tmp1);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row2, tmp1));
+	minor2 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor2);
+	minor2 = _mm_shuffle_ps(minor2, minor2, 0x4E);
+
+	tmp1 = _mm_mul_ps(row0, row1);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	minor2 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor2);
+	minor3 = _mm_sub_ps(_mm_mul_ps(row2, tmp1), minor3);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor2 = _mm_sub_ps(_mm_mul_ps(row3, tmp1), minor2);
+	minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row2, tmp1));
+
+	tmp1 = _mm_mul_ps(row0, row3);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row2, tmp1));
+	minor2 = _mm_add_ps(_mm_mul_ps(row1, tmp1), minor2);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor1 = _mm_add_ps(_mm_mul_ps(row2, tmp1), minor1);
+	minor2 = _mm_sub_ps(minor2, _mm_mul_ps(row1, tmp1));
+
+	tmp1 = _mm_mul_ps(row0, row2);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	minor1 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor1);
+	minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row1, tmp1));
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row3, tmp1));
+	minor3 = _mm_add_ps(_mm_mul_ps(row1, tmp1), minor3);
+
+	// Determinant, broadcast to every lane
+	det = _mm_mul_ps(row0, minor0);
+	det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4E), det);
+	det = _mm_add_ss(_mm_shuffle_ps(det, det, 0xB1), det);
+	det = _mm_div_ss(_mm_set_ss(1.0f), det);
+	det = _mm_shuffle_ps(det, det, 0x00);
+
+	_mm_storeu_ps(src, _mm_mul_ps(det, minor0));
+	_mm_storeu_ps(src + 4, _mm_mul_ps(det, minor1));
+	_mm_storeu_ps(src + 8, _mm_mul_ps(det, minor2));
+	_mm_storeu_ps(src + 12, _mm_mul_ps(det, minor3));
+#else
+	InvertScalar();
+#endif
+}
+
+void Matrix4::InvertScalar()
 {
 	// Thanks slow math
 	// This is a really janky way to unroll everything...
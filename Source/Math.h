@@ -8,9 +8,58 @@
 
 #pragma once
 #include <cmath>
+#include <cstddef>
 #include <memory.h>
 #include <limits>
 
+// SIMD kernels for the matrix and transform code are picked at compile time.
+// Every x86-64 build has SSE2, AVX2 builds (ENABLE_AVX2 in CMake) also get the
+// 256-bit batch kernels. Other targets, or defining MATH_NO_SIMD, use the
+// scalar code, which the SIMD kernels are checked against by engine-bench.
+#if !defined(MATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MATH_SIMD
+#include <immintrin.h>
+#if defined(__AVX2__)
+#define MATH_SIMD_AVX2
+#endif
+
+namespace MathSIMD
+{
+	// Load/store 3 floats without touching the 4th (it may be past the end)
+	inline __m128 Load3(const float* p)
+	{
+		__m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p)));
+		return _mm_movelh_ps(xy, _mm_load_ss(p + 2));
+	}
+
+	inline void Store3(float* p, __m128 v)
+	{
+		_mm_store_sd(reinterpret_cast<double*>(p), _mm_castps_pd(v));
+		_mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+	}
+
+	// c.x * row0 + c.y * row1 + c.z * row2 + c.w * row3
+	inline __m128 CombineRows(__m128 c, __m128 row0, __m128 row1, __m128 row2, __m128 row3)
+	{
+		__m128 r = _mm_mul_ps(_mm_shuffle_ps(c, c, 0x00), row0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(c, c, 0x55), row1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(c, c, 0xAA), row2));
+		return _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(c, c, 0xFF), row3));
+	}
+
+#ifdef MATH_SIMD_AVX2
+	// Same on two rows at once (one per 128-bit lane)
+	inline __m256 CombineRows(__m256 c, __m256 row0, __m256 row1, __m256 row2, __m256 row3)
+	{
+		__m256 r = _mm256_mul_ps(_mm256_shuffle_ps(c, c, 0x00), row0);
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(c, c, 0x55), row1));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(c, c, 0xAA), row2));
+		return _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(c, c, 0xFF), row3));
+	}
+#endif
+}
+#endif
+
 namespace Math
 {
 	const float Pi = 3.1415926535f;
@@ -237,6 +286,10 @@ public:
 
 	// Transform vector by matrix
 	static Vector2 Transform(const Vector2& vec, const class Matrix3& mat, float w = 1.0f);
+	static Vector2 TransformScalar(const Vector2& vec, const class Matrix3& mat, float w = 1.0f);
+
+	// Transform count vectors by the same matrix (out may be the same array as in)
+	static void TransformBatch(const Vector2* in, Vector2* out, size_t count, const class Matrix3& mat, float w = 1.0f);
 
 	static const Vector2 Zero;
 	static const Vector2 UnitX;
@@ -394,6 +447,10 @@ public:
 	}
 
 	static Vector3 Transform(const Vector3& vec, const class Matrix4& mat, float w = 1.0f);
+	static Vector3 TransformScalar(const Vector3& vec, const class Matrix4& mat, float w = 1.0f);
+
+	// Transform count vectors by the same matrix (out may be the same array as in)
+	static void TransformBatch(const Vector3* in, Vector3* out, size_t count, const class Matrix4& mat, float w = 1.0f);
 	// This will transform the vector and renormalize the w component
 	static Vector3 TransformWithPerspDiv(const Vector3& vec, const class Matrix4& mat, float w = 1.0f);
 
@@ -433,8 +490,14 @@ public:
 		return reinterpret_cast<const float*>(&mat[0][0]);
 	}
 
-	// Matrix multiplication
+	// Matrix multiplication. Stays scalar: with 3-wide rows the SSE version
+	// was slower than what the compiler makes of this.
 	friend Matrix3 operator*(const Matrix3& left, const Matrix3& right)
+	{
+		return MultiplyScalar(left, right);
+	}
+
+	static Matrix3 MultiplyScalar(const Matrix3& left, const Matrix3& right)
 	{
 		Matrix3 retVal;
 		// row 0
@@ -569,6 +632,45 @@ public:
 
 	// Matrix multiplication (a * b)
 	friend Matrix4 operator*(const Matrix4& a, const Matrix4& b)
+	{
+#ifdef MATH_SIMD
+		return MultiplySIMD(a, b);
+#else
+		return MultiplyScalar(a, b);
+#endif
+	}
+
+#ifdef MATH_SIMD
+	// Each row of the result is a combination of the rows of b. AVX2 builds
+	// do two rows at a time. The result is built in a plain array so the
+	// constructor doesn't copy the identity first.
+	static Matrix4 MultiplySIMD(const Matrix4& a, const Matrix4& b)
+	{
+		float temp[4][4];
+#ifdef MATH_SIMD_AVX2
+		const __m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.mat[0]));
+		const __m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.mat[1]));
+		const __m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.mat[2]));
+		const __m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.mat[3]));
+
+		_mm256_storeu_ps(temp[0], MathSIMD::CombineRows(_mm256_loadu_ps(a.mat[0]), row0, row1, row2, row3));
+		_mm256_storeu_ps(temp[2], MathSIMD::CombineRows(_mm256_loadu_ps(a.mat[2]), row0, row1, row2, row3));
+#else
+		const __m128 row0 = _mm_loadu_ps(b.mat[0]);
+		const __m128 row1 = _mm_loadu_ps(b.mat[1]);
+		const __m128 row2 = _mm_loadu_ps(b.mat[2]);
+		const __m128 row3 = _mm_loadu_ps(b.mat[3]);
+
+		_mm_storeu_ps(temp[0], MathSIMD::CombineRows(_mm_loadu_ps(a.mat[0]), row0, row1, row2, row3));
+		_mm_storeu_ps(temp[1], MathSIMD::CombineRows(_mm_loadu_ps(a.mat[1]), row0, row1, row2, row3));
+		_mm_storeu_ps(temp[2], MathSIMD::CombineRows(_mm_loadu_ps(a.mat[2]), row0, row1, row2, row3));
+		_mm_storeu_ps(temp[3], MathSIMD::CombineRows(_mm_loadu_ps(a.mat[3]), row0, row1, row2, row3));
+#endif
+		return Matrix4(temp);
+	}
+#endif
+
+	static Matrix4 MultiplyScalar(const Matrix4& a, const Matrix4& b)
 	{
 		Matrix4 retVal;
 		// row 0
@@ -680,8 +782,9 @@ public:
 		return *this;
 	}
 
-	// Invert the matrix - super slow
+	// Invert the matrix (SSE version of the same cofactor expansion when available)
 	void Invert();
+	void InvertScalar();
 
 	// Get the translation component of the matrix
 	Vector3 GetTranslation() const
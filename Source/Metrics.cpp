@@ -0,0 +1,142 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "Metrics.h"
+#include <SDL.h>
+
+std::atomic<bool> Metrics::sEnabled(false);
+std::atomic<uint64_t> Metrics::sValues[static_cast<int>(Metric::Count)] = {};
+std::ofstream Metrics::sFile;
+bool Metrics::sIsCsv = false;
+
+namespace
+{
+    const char* const METRIC_NAMES[] = {
+        "frame_time_us",
+        "actors_updated",
+        "spatial_inserts",
+        "spatial_reinserts",
+        "broadphase_queries",
+        "broadphase_candidates",
+        "narrowphase_tests",
+        "get_component_calls",
+        "draw_calls",
+        "texture_changes",
+        "textures_resident",
+        "asset_bytes_resident",
+        "sounds_playing",
+        "awake_bodies",
+        "sleeping_bodies",
+        "heap_allocations",
+        "redrawn_pixels",
+        "rollback_ticks",
+        "rollback_time_us"
+    };
+
+    static_assert(sizeof(METRIC_NAMES) / sizeof(METRIC_NAMES[0]) == static_cast<size_t>(Metric::Count),
+                  "Every metric needs a name");
+}
+
+bool Metrics::Open(const std::string& path)
+{
+    Close();
+
+    sFile.open(path, std::ios::out | std::ios::trunc);
+    if (!sFile.is_open()) {
+        SDL_Log("Failed to open metrics file %s", path.c_str());
+        return false;
+    }
+
+    const std::string csvExtension = ".csv";
+    sIsCsv = path.size() >= csvExtension.size() &&
+             path.compare(path.size() - csvExtension.size(), csvExtension.size(), csvExtension) == 0;
+
+    for (auto& value : sValues) {
+        value.store(0, std::memory_order_relaxed);
+    }
+
+    WriteHeader();
+    sEnabled.store(true, std::memory_order_relaxed);
+
+    SDL_Log("Writing per-frame metrics to %s", path.c_str());
+    return true;
+}
+
+void Metrics::Close()
+{
+    sEnabled.store(false, std::memory_order_relaxed);
+
+    if (sFile.is_open()) {
+        sFile.close();
+    }
+}
+
+void Metrics::SetFrameDraws(uint64_t drawCalls, uint64_t textureChanges)
+{
+    Set(Metric::DrawCalls, drawCalls);
+    Set(Metric::TextureChanges, textureChanges);
+}
+
+const char* Metrics::GetName(Metric metric)
+{
+    return METRIC_NAMES[static_cast<int>(metric)];
+}
+
+bool Metrics::IsGauge(Metric metric)
+{
+    switch (metric)
+    {
+        case Metric::FrameTimeUs:
+        case Metric::DrawCalls:
+        case Metric::TextureChanges:
+        case Metric::TexturesResident:
+        case Metric::SoundsPlaying:
+        case Metric::AwakeBodies:
+        case Metric::SleepingBodies:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void Metrics::WriteHeader()
+{
+    if (!sIsCsv) {
+        return;
+    }
+
+    sFile << "frame";
+    for (int i = 0; i < static_cast<int>(Metric::Count); ++i) {
+        sFile << ',' << METRIC_NAMES[i];
+    }
+    sFile << '\n';
+}
+
+void Metrics::EndFrame(uint32_t frame)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+
+    if (sIsCsv) {
+        sFile << frame;
+    } else {
+        sFile << "{\"frame\":" << frame;
+    }
+
+    for (int i = 0; i < static_cast<int>(Metric::Count); ++i)
+    {
+        auto metric = static_cast<Metric>(i);
+        uint64_t value = IsGauge(metric) ? Get(metric)
+                                         : sValues[i].exchange(0, std::memory_order_relaxed);
+
+        if (sIsCsv) {
+            sFile << ',' << value;
+        } else {
+            sFile << ",\"" << METRIC_NAMES[i] << "\":" << value;
+        }
+    }
+
+    sFile << (sIsCsv ? "\n" : "}\n");
+}
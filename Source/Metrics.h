@@ -0,0 +1,87 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Values the engine reports every frame. Counters are summed over the frame
+// and reset when it ends, gauges keep the last value they were set to.
+enum class Metric : uint8_t
+{
+    FrameTimeUs,
+    ActorsUpdated,
+    SpatialInserts,
+    SpatialReinserts,
+    BroadPhaseQueries,
+    BroadPhaseCandidates,
+    NarrowPhaseTests,
+    GetComponentCalls,
+    DrawCalls,
+    TextureChanges,
+    TexturesResident,
+    AssetBytesResident,
+    SoundsPlaying,
+    AwakeBodies,
+    SleepingBodies,
+    HeapAllocations,    // Only counted in tp-final, see HeapMetrics.cpp
+    RedrawnPixels,
+    RollbackTicks,
+    RollbackTimeUs,
+    Count
+};
+
+// Per-frame metrics registry. Nothing is recorded until an output is opened
+// (--metrics <file>), so the counters cost a single branch otherwise. Each
+// frame becomes a row of the file: a CSV table when the path ends in .csv,
+// one JSON object per line otherwise.
+//
+// Counters and gauges are atomic so they can be bumped from the job system
+// workers and the render thread. The rows are written by the thread running
+// the simulation (EndFrame), which with --sim-thread isn't the one drawing.
+class Metrics
+{
+public:
+    static bool Open(const std::string& path);
+    static void Close();
+
+    static bool IsEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+    static void Add(Metric metric, uint64_t amount = 1)
+    {
+        if (IsEnabled()) {
+            sValues[static_cast<int>(metric)].fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+
+    static void Set(Metric metric, uint64_t value)
+    {
+        if (IsEnabled()) {
+            sValues[static_cast<int>(metric)].store(value, std::memory_order_relaxed);
+        }
+    }
+
+    // Draw calls and texture changes of the frame just presented, from the
+    // thread presenting it. Gauges, so with a simulation thread each row has
+    // the last frame drawn by the time its tick ended.
+    static void SetFrameDraws(uint64_t drawCalls, uint64_t textureChanges);
+
+    static uint64_t Get(Metric metric) { return sValues[static_cast<int>(metric)].load(std::memory_order_relaxed); }
+    static const char* GetName(Metric metric);
+    static bool IsGauge(Metric metric);
+
+    // Write the frame's row and reset the counters
+    static void EndFrame(uint32_t frame);
+
+private:
+    static void WriteHeader();
+
+    static std::atomic<bool> sEnabled;
+    static std::atomic<uint64_t> sValues[static_cast<int>(Metric::Count)];
+    static std::ofstream sFile;
+    static bool sIsCsv;
+};
@@ -0,0 +1,609 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "NetSession.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iterator>
+#include <SDL.h>
+#include "CommandLine.h"
+#include "Snapshot.h"
+#include "StringId.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const uint32_t NET_MAGIC = 0x504E5243; // "CRNP"
+    const uint16_t NET_VERSION = 1;
+
+    enum PacketType : uint8_t
+    {
+        PACKET_INPUT,
+        PACKET_QUIT
+    };
+
+    const intptr_t NO_SOCKET = -1;
+    const int MAX_PACKET_SIZE = 1024;
+
+#ifdef _WIN32
+    using NativeSocket = SOCKET;
+#else
+    using NativeSocket = int;
+#endif
+
+    NativeSocket Native(intptr_t socket)
+    {
+        return static_cast<NativeSocket>(socket);
+    }
+
+    void CloseSocket(intptr_t socket)
+    {
+#ifdef _WIN32
+        closesocket(Native(socket));
+#else
+        close(Native(socket));
+#endif
+    }
+}
+
+NetSession::NetSession(const NetplayParams& params)
+    :mParams(params)
+    ,mSocket(NO_SOCKET)
+    ,mPeerAddress{}
+    ,mLocalTicks(0)
+    ,mLocalAcked(0)
+    ,mRemoteTicks(0)
+    ,mRollbackTick(NO_ROLLBACK)
+    ,mHistoryStart(0)
+    ,mLastChecksumTick(UINT32_MAX)
+    ,mNumDesyncs(0)
+    ,mHasPeer(false)
+    ,mPeerLeft(false)
+    ,mLastReceiveTime(0)
+    ,mLossRandom(params.port, params.localPlayer)
+    ,mNumPacketsSent(0)
+    ,mNumPacketsDropped(0)
+{
+    static_assert(INPUT_HISTORY > 2 * MAX_ROLLBACK + MAX_INPUTS_PER_PACKET / 2, "Input history too short");
+}
+
+NetSession::~NetSession()
+{
+    if (mSocket != NO_SOCKET)
+    {
+        CloseSocket(mSocket);
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+}
+
+bool NetSession::Open()
+{
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        SDL_Log("Netplay: failed to initialize Winsock");
+        return false;
+    }
+#endif
+
+    NativeSocket udpSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#ifdef _WIN32
+    if (udpSocket == INVALID_SOCKET) {
+#else
+    if (udpSocket < 0) {
+#endif
+        SDL_Log("Netplay: failed to create a UDP socket");
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+    mSocket = static_cast<intptr_t>(udpSocket);
+
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(mParams.port);
+    if (bind(Native(mSocket), reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) {
+        SDL_Log("Netplay: failed to bind UDP port %d", mParams.port);
+        return false;
+    }
+
+    // Never wait for packets, Poll takes whatever arrived
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(Native(mSocket), FIONBIO, &nonBlocking);
+#else
+    fcntl(Native(mSocket), F_SETFL, fcntl(Native(mSocket), F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(mParams.peerHost.c_str(), nullptr, &hints, &result) != 0 || !result) {
+        SDL_Log("Netplay: failed to resolve %s", mParams.peerHost.c_str());
+        return false;
+    }
+
+    sockaddr_in peer{};
+    std::memcpy(&peer, result->ai_addr, sizeof(peer));
+    peer.sin_port = htons(mParams.peerPort);
+    freeaddrinfo(result);
+
+    static_assert(sizeof(sockaddr_in) == sizeof(mPeerAddress), "Unexpected sockaddr_in size");
+    std::memcpy(mPeerAddress, &peer, sizeof(peer));
+
+    SDL_Log("Netplay: player %d on port %d, peer %s:%d (latency %d ms, loss %d%%)", mParams.localPlayer + 1,
+            mParams.port, mParams.peerHost.c_str(), mParams.peerPort, mParams.latencyMs, mParams.lossPercent);
+    return true;
+}
+
+void NetSession::Poll(uint32_t now)
+{
+    if (mSocket == NO_SOCKET) {
+        return;
+    }
+
+    Receive(now);
+
+    if (mHasPeer && !mPeerLeft && now - mLastReceiveTime > TIMEOUT_MS) {
+        SDL_Log("Netplay: no packets from the peer for %u ms, giving up", TIMEOUT_MS);
+        mPeerLeft = true;
+    }
+
+    // Packets whose simulated latency is over
+    while (!mDelayed.empty() && static_cast<int32_t>(now - mDelayed.front().sendTime) >= 0)
+    {
+        SendNow(mDelayed.front().data);
+        mDelayed.pop_front();
+    }
+
+    WritePacket(mPacket, PACKET_INPUT);
+    Send(mPacket, now);
+}
+
+void NetSession::SendQuit()
+{
+    if (mSocket == NO_SOCKET) {
+        return;
+    }
+
+    WritePacket(mPacket, PACKET_QUIT);
+    for (int i = 0; i < 3; ++i) {
+        SendNow(mPacket);
+    }
+}
+
+void NetSession::SetLocalInput(uint32_t tick, const NetInput& input)
+{
+    if (tick != mLocalTicks) {
+        SDL_Log("Netplay: local input for tick %u out of order", tick);
+        return;
+    }
+
+    mLocalInputs[tick % INPUT_HISTORY] = input;
+    ++mLocalTicks;
+}
+
+NetInput NetSession::Predict() const
+{
+    NetInput prediction;
+    if (mRemoteTicks > 0)
+    {
+        const NetInput& last = mRemoteInputs[(mRemoteTicks - 1) % INPUT_HISTORY].input;
+        prediction.actions = last.actions;
+        prediction.pointerX = last.pointerX;
+        prediction.pointerY = last.pointerY;
+    }
+    return prediction;
+}
+
+NetInput NetSession::GetInput(int player, uint32_t tick)
+{
+    if (player == mParams.localPlayer) {
+        return tick < mLocalTicks ? mLocalInputs[tick % INPUT_HISTORY] : NetInput();
+    }
+
+    RemoteInput& remote = mRemoteInputs[tick % INPUT_HISTORY];
+    if (tick < mRemoteTicks) {
+        return remote.input;
+    }
+
+    remote.tick = tick;
+    remote.isConfirmed = false;
+    remote.wasPredicted = true;
+    remote.prediction = Predict();
+    return remote.prediction;
+}
+
+NetInput NetSession::GetUsedInput(int player, uint32_t tick) const
+{
+    if (player == mParams.localPlayer) {
+        return tick < mLocalTicks ? mLocalInputs[tick % INPUT_HISTORY] : NetInput();
+    }
+
+    const RemoteInput& remote = mRemoteInputs[tick % INPUT_HISTORY];
+    if (tick < mRemoteTicks) {
+        return remote.input;
+    }
+    return remote.tick == tick && remote.wasPredicted ? remote.prediction : Predict();
+}
+
+uint32_t NetSession::TakeRollbackTick()
+{
+    uint32_t tick = mRollbackTick;
+    mRollbackTick = NO_ROLLBACK;
+    return tick;
+}
+
+void NetSession::ResetHistory(uint32_t tick)
+{
+    mHistoryStart = tick;
+    if (mRollbackTick < tick) {
+        mRollbackTick = NO_ROLLBACK;
+    }
+
+    for (auto& state : mStates) {
+        state = SavedState();
+    }
+    for (auto& keyframe : mKeyframes) {
+        keyframe = SavedState();
+    }
+}
+
+void NetSession::SaveState(uint32_t tick, const std::vector<uint8_t>& state)
+{
+    SavedState& saved = mStates[tick % NUM_STATES];
+    saved.tick = tick;
+    saved.checksum = StringId::Hash(reinterpret_cast<const char*>(state.data()), state.size());
+
+    const uint32_t keyframeTick = tick - tick % KEYFRAME_INTERVAL;
+    SavedState& keyframe = mKeyframes[(tick / KEYFRAME_INTERVAL) % NUM_KEYFRAMES];
+    if (tick == keyframeTick)
+    {
+        keyframe.tick = tick;
+        keyframe.data = state;
+        saved.keyframeTick = tick;
+        saved.data.clear();
+    }
+    else if (keyframe.tick == keyframeTick)
+    {
+        // Re-simulating a keyframe tick saves the ticks after it again too,
+        // so the deltas never outlive the keyframe they were made against
+        saved.keyframeTick = keyframeTick;
+        SnapshotDelta::Encode(keyframe.data, state, saved.data);
+    }
+    else
+    {
+        // The history started after the keyframe tick (a new scene)
+        saved.keyframeTick = NO_KEYFRAME;
+        saved.data = state;
+    }
+}
+
+bool NetSession::LoadState(uint32_t tick, std::vector<uint8_t>& state) const
+{
+    const SavedState& saved = mStates[tick % NUM_STATES];
+    if (saved.tick != tick) {
+        return false;
+    }
+
+    if (saved.keyframeTick == NO_KEYFRAME) {
+        state = saved.data;
+        return true;
+    }
+
+    const SavedState& keyframe = mKeyframes[(saved.keyframeTick / KEYFRAME_INTERVAL) % NUM_KEYFRAMES];
+    if (keyframe.tick != saved.keyframeTick) {
+        return false;
+    }
+
+    if (saved.keyframeTick == tick) {
+        state = keyframe.data;
+        return true;
+    }
+    return SnapshotDelta::Decode(keyframe.data, saved.data, state);
+}
+
+bool NetSession::GetSavedStateHash(uint32_t tick, uint64_t& checksum) const
+{
+    const SavedState& saved = mStates[tick % NUM_STATES];
+    if (saved.tick != tick) {
+        return false;
+    }
+
+    checksum = saved.checksum;
+    return true;
+}
+
+size_t NetSession::GetHistoryBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& state : mStates) {
+        bytes += state.data.size();
+    }
+    for (const auto& keyframe : mKeyframes) {
+        bytes += keyframe.data.size();
+    }
+    return bytes;
+}
+
+void NetSession::SetStateChecksum(uint32_t tick, uint64_t checksum)
+{
+    Checksum& entry = mChecksums[tick % INPUT_HISTORY];
+    if (entry.tick != tick) {
+        entry = Checksum();
+        entry.tick = tick;
+    }
+
+    entry.local = checksum;
+    entry.hasLocal = true;
+    mLastChecksumTick = tick;
+    CompareChecksum(entry);
+}
+
+void NetSession::CompareChecksum(Checksum& checksum)
+{
+    if (!checksum.hasLocal || !checksum.hasRemote || checksum.isCompared) {
+        return;
+    }
+
+    checksum.isCompared = true;
+    if (checksum.local != checksum.remote)
+    {
+        ++mNumDesyncs;
+        SDL_Log("Netplay: desync at tick %u (state %016llx here, %016llx on the peer)", checksum.tick,
+                static_cast<unsigned long long>(checksum.local), static_cast<unsigned long long>(checksum.remote));
+    }
+}
+
+void NetSession::Receive(uint32_t now)
+{
+    uint8_t buffer[MAX_PACKET_SIZE];
+    while (true)
+    {
+        sockaddr_in from{};
+        socklen_t fromLength = sizeof(from);
+        int size = static_cast<int>(recvfrom(Native(mSocket), reinterpret_cast<char*>(buffer), sizeof(buffer), 0,
+                                             reinterpret_cast<sockaddr*>(&from), &fromLength));
+        if (size <= 0) {
+            break;
+        }
+
+        // Only the peer takes part in the session
+        const auto* peer = reinterpret_cast<const sockaddr_in*>(mPeerAddress);
+        if (from.sin_port != peer->sin_port || from.sin_addr.s_addr != peer->sin_addr.s_addr) {
+            continue;
+        }
+
+        HandlePacket(buffer, static_cast<size_t>(size), now);
+    }
+}
+
+void NetSession::HandlePacket(const uint8_t* data, size_t size, uint32_t now)
+{
+    SnapshotReader reader(data, size);
+    if (reader.Read<uint32_t>() != NET_MAGIC || reader.Read<uint16_t>() != NET_VERSION) {
+        return;
+    }
+
+    auto type = reader.Read<uint8_t>();
+    auto acked = reader.Read<uint32_t>();
+    auto checksumTick = reader.Read<uint32_t>();
+    auto checksum = reader.Read<uint64_t>();
+    auto firstTick = reader.Read<uint32_t>();
+    auto numInputs = reader.Read<uint8_t>();
+
+    std::vector<NetInput> inputs(numInputs);
+    for (auto& input : inputs) {
+        reader.Read(input);
+    }
+
+    if (reader.IsFailed()) {
+        return;
+    }
+
+    if (!mHasPeer) {
+        SDL_Log("Netplay: connected to player %d", GetRemotePlayer() + 1);
+    }
+    mHasPeer = true;
+    mLastReceiveTime = now;
+
+    if (type == PACKET_QUIT)
+    {
+        if (!mPeerLeft) {
+            SDL_Log("Netplay: player %d left", GetRemotePlayer() + 1);
+        }
+        mPeerLeft = true;
+        return;
+    }
+
+    mLocalAcked = std::max(mLocalAcked, std::min(acked, mLocalTicks));
+
+    if (checksumTick != UINT32_MAX)
+    {
+        Checksum& entry = mChecksums[checksumTick % INPUT_HISTORY];
+        if (entry.tick != checksumTick) {
+            entry = Checksum();
+            entry.tick = checksumTick;
+        }
+        entry.remote = checksum;
+        entry.hasRemote = true;
+        CompareChecksum(entry);
+    }
+
+    // Inputs start at the first one we hadn't acknowledged when it was sent,
+    // take the ones that extend what we have without a gap
+    for (uint32_t i = 0; i < numInputs; ++i)
+    {
+        if (firstTick + i == mRemoteTicks) {
+            ReceiveRemoteInput(firstTick + i, inputs[i]);
+        }
+    }
+}
+
+void NetSession::ReceiveRemoteInput(uint32_t tick, const NetInput& input)
+{
+    RemoteInput& remote = mRemoteInputs[tick % INPUT_HISTORY];
+    if (remote.tick == tick && remote.wasPredicted && remote.prediction != input && tick >= mHistoryStart) {
+        mRollbackTick = std::min(mRollbackTick, tick);
+    }
+
+    remote.tick = tick;
+    remote.input = input;
+    remote.isConfirmed = true;
+    remote.wasPredicted = false;
+    ++mRemoteTicks;
+}
+
+void NetSession::WritePacket(std::vector<uint8_t>& packet, uint8_t type)
+{
+    SnapshotWriter writer(packet);
+    writer.Write(NET_MAGIC);
+    writer.Write(NET_VERSION);
+    writer.Write(type);
+    writer.Write(mRemoteTicks);
+
+    // The latest confirmed checksum, the peer compares it once it has its own
+    if (mLastChecksumTick != UINT32_MAX) {
+        writer.Write(mLastChecksumTick);
+        writer.Write(mChecksums[mLastChecksumTick % INPUT_HISTORY].local);
+    } else {
+        writer.Write(UINT32_MAX);
+        writer.Write<uint64_t>(0);
+    }
+
+    const uint32_t numInputs = type == PACKET_INPUT
+        ? std::min<uint32_t>(mLocalTicks - mLocalAcked, MAX_INPUTS_PER_PACKET) : 0;
+    writer.Write(mLocalAcked);
+    writer.Write(static_cast<uint8_t>(numInputs));
+    for (uint32_t i = 0; i < numInputs; ++i) {
+        writer.Write(mLocalInputs[(mLocalAcked + i) % INPUT_HISTORY]);
+    }
+
+    writer.Finish();
+}
+
+void NetSession::Send(std::vector<uint8_t>& packet, uint32_t now)
+{
+    if (mParams.lossPercent > 0 && mLossRandom.GetFloat() * 100.0f < static_cast<float>(mParams.lossPercent))
+    {
+        ++mNumPacketsDropped;
+        return;
+    }
+
+    if (mParams.latencyMs > 0) {
+        mDelayed.push_back({now + static_cast<uint32_t>(mParams.latencyMs), packet});
+    } else {
+        SendNow(packet);
+    }
+}
+
+void NetSession::SendNow(const std::vector<uint8_t>& packet)
+{
+    sendto(Native(mSocket), reinterpret_cast<const char*>(packet.data()), static_cast<int>(packet.size()), 0,
+           reinterpret_cast<const sockaddr*>(mPeerAddress), sizeof(sockaddr_in));
+    ++mNumPacketsSent;
+}
+
+// Ports are 1 to 65535, casting a bigger number would wrap around
+static bool ParsePort(const char* text, uint16_t& port)
+{
+    int value = 0;
+    if (!CommandLine::ParseInt(text, 1, UINT16_MAX, value)) {
+        return false;
+    }
+
+    port = static_cast<uint16_t>(value);
+    return true;
+}
+
+bool NetSession::ParseOption(int argc, char** argv, int& i, NetplayParams& params, bool& isValid)
+{
+    static const char* const OPTIONS[] = {"--net-player", "--net-port", "--net-peer", "--net-latency",
+                                          "--net-loss", "--net-bot", "--net-ticks"};
+
+    const char* option = argv[i];
+    if (std::none_of(std::begin(OPTIONS), std::end(OPTIONS), [option](const char* name) {
+        return strcmp(option, name) == 0;
+    })) {
+        return false;
+    }
+
+    if (i + 1 >= argc) {
+        SDL_Log("Missing value for %s", option);
+        isValid = false;
+        return true;
+    }
+    const char* value = argv[++i];
+
+    if (strcmp(option, "--net-player") == 0) {
+        int player = 0;
+        if (!CommandLine::ParseInt(value, 1, 2, player)) {
+            SDL_Log("Invalid netplay player %s (expected 1 or 2)", value);
+            isValid = false;
+        } else {
+            params.localPlayer = player - 1;
+        }
+    }
+    else if (strcmp(option, "--net-port") == 0) {
+        if (!ParsePort(value, params.port)) {
+            SDL_Log("Invalid netplay port %s (expected 1 to %d)", value, UINT16_MAX);
+            isValid = false;
+        }
+    }
+    else if (strcmp(option, "--net-peer") == 0) {
+        const char* colon = strrchr(value, ':');
+        if (!colon || colon == value || !ParsePort(colon + 1, params.peerPort)) {
+            SDL_Log("Invalid netplay peer %s (expected host:port, with a port from 1 to %d)", value, UINT16_MAX);
+            isValid = false;
+        } else {
+            params.peerHost.assign(value, colon);
+        }
+    }
+    else if (strcmp(option, "--net-latency") == 0) {
+        if (!CommandLine::ParseInt(value, 0, INT_MAX, params.latencyMs)) {
+            SDL_Log("Invalid netplay latency %s (expected milliseconds, 0 or more)", value);
+            isValid = false;
+        }
+    }
+    else if (strcmp(option, "--net-loss") == 0) {
+        if (!CommandLine::ParseInt(value, 0, 100, params.lossPercent)) {
+            SDL_Log("Invalid netplay loss %s (expected a percentage from 0 to 100)", value);
+            isValid = false;
+        }
+    }
+    else if (strcmp(option, "--net-bot") == 0) {
+        if (!CommandLine::ParseUInt64(value, params.botSeed)) {
+            SDL_Log("Invalid netplay bot seed %s (expected a number)", value);
+            isValid = false;
+        }
+    }
+    else { // --net-ticks
+        uint64_t ticks = 0;
+        if (!CommandLine::ParseUInt64(value, ticks) || ticks > UINT32_MAX) {
+            SDL_Log("Invalid netplay tick count %s (expected 0 to %u)", value, UINT32_MAX);
+            isValid = false;
+        } else {
+            params.maxTicks = static_cast<uint32_t>(ticks);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,246 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "Random.h"
+
+// Options of a netplay session (--net-* on the command line)
+struct NetplayParams
+{
+    // 0 plays the first mouse, 1 the second
+    int localPlayer = 0;
+
+    uint16_t port = 7000;
+    std::string peerHost = "127.0.0.1";
+    uint16_t peerPort = 7001;
+
+    // Simulated network conditions, applied to the packets this side sends
+    int latencyMs = 0;
+    int lossPercent = 0;
+
+    // Scripted input instead of the keyboard (0 = keyboard), for unattended runs
+    uint64_t botSeed = 0;
+
+    // Quit once this many ticks were simulated (0 = play until a window closes)
+    uint32_t maxTicks = 0;
+};
+
+// What a player did during one tick
+struct NetInput
+{
+    static const uint8_t POINTER_MOVED = 1;
+    static const uint8_t CAST_SPELL = 2;
+
+    uint8_t actions = 0;    // Bit per InputAction
+    uint8_t flags = 0;
+    int16_t pointerX = 0;
+    int16_t pointerY = 0;
+
+    // The pointer position only matters when it moved
+    bool operator==(const NetInput& other) const
+    {
+        return actions == other.actions && flags == other.flags &&
+               (!(flags & POINTER_MOVED) || (pointerX == other.pointerX && pointerY == other.pointerY));
+    }
+    bool operator!=(const NetInput& other) const { return !(*this == other); }
+};
+
+// Two-player rollback netplay over UDP. Every tick each side sends its
+// player's input to the other and simulates right away, predicting that the
+// remote player still holds what it held in its last received input. When a
+// remote input arrives that differs from the prediction, the game restores the
+// state saved before that tick (the last one simulated with confirmed inputs
+// only) and simulates forward again within the same frame.
+//
+// Packets carry every local input the peer hasn't acknowledged yet, so a lost
+// packet is covered by the next one, and the checksum of the latest confirmed
+// state, so both sides notice if they ever desync. A side never runs more than
+// MAX_ROLLBACK ticks ahead of the peer's confirmed input, it waits instead.
+//
+// Tick 0 is the first tick of the first level both sides play. Used from the
+// simulation thread only.
+class NetSession
+{
+public:
+    static const int MAX_ROLLBACK = 12;
+
+    // Ticks of inputs and checksums kept (must exceed twice MAX_ROLLBACK)
+    static const int INPUT_HISTORY = 64;
+    static const int MAX_INPUTS_PER_PACKET = 32;
+
+    // Milliseconds without a packet before the peer is given up on
+    static const uint32_t TIMEOUT_MS = 5000;
+
+    static const uint32_t NO_ROLLBACK = UINT32_MAX;
+
+    // The rollback history keeps a full state every KEYFRAME_INTERVAL ticks
+    // and the ones in between as SnapshotDeltas against it
+    static const int KEYFRAME_INTERVAL = 8;
+
+    explicit NetSession(const NetplayParams& params);
+    ~NetSession();
+
+    // Bind the local port and resolve the peer, false on failure
+    bool Open();
+
+    // Receive the peer's packets, then send ours (or queue it, with simulated
+    // latency). Called once per frame with SDL_GetTicks.
+    void Poll(uint32_t now);
+
+    // Tell the peer this side is leaving (sent right away, a few times)
+    void SendQuit();
+
+    int GetLocalPlayer() const { return mParams.localPlayer; }
+    int GetRemotePlayer() const { return 1 - mParams.localPlayer; }
+    const NetplayParams& GetParams() const { return mParams; }
+
+    void SetLocalInput(uint32_t tick, const NetInput& input);
+
+    // Input of a player at a tick: the local one as recorded, the remote one
+    // as received or else predicted (and remembered, to detect rollbacks)
+    NetInput GetInput(int player, uint32_t tick);
+
+    // Same, but a remote input that isn't known yet is the prediction the
+    // tick was last simulated with (the previous tick, to find the edges)
+    NetInput GetUsedInput(int player, uint32_t tick) const;
+
+    // Ticks whose inputs are all known, the states up to it are confirmed
+    uint32_t GetConfirmedTick() const { return mRemoteTicks; }
+
+    // Whether the tick can be simulated without getting more than
+    // MAX_ROLLBACK ticks ahead of the peer
+    bool CanAdvance(uint32_t tick) const { return tick < mRemoteTicks + MAX_ROLLBACK; }
+
+    // First tick that was simulated with a wrong prediction (NO_ROLLBACK if
+    // none since the last call)
+    uint32_t TakeRollbackTick();
+
+    // A new scene starts at the tick: the states of the old one can't be
+    // restored, mispredictions before it are ignored
+    void ResetHistory(uint32_t tick);
+    uint32_t GetHistoryStart() const { return mHistoryStart; }
+
+    // Keep the state saved before simulating the tick, while it can be
+    // rolled back to. Saving a tick again replaces it.
+    void SaveState(uint32_t tick, const std::vector<uint8_t>& state);
+
+    // False if the tick's state isn't kept
+    bool LoadState(uint32_t tick, std::vector<uint8_t>& state) const;
+
+    // Hash of a kept state, to compare with the peer once it's confirmed
+    bool GetSavedStateHash(uint32_t tick, uint64_t& checksum) const;
+
+    // Memory taken by the kept states
+    size_t GetHistoryBytes() const;
+
+    // Checksum of the confirmed state of a tick, compared with the peer's
+    void SetStateChecksum(uint32_t tick, uint64_t checksum);
+
+    bool HasPeer() const { return mHasPeer; }
+    bool HasPeerLeft() const { return mPeerLeft; }
+
+    int GetNumDesyncs() const { return mNumDesyncs; }
+    int GetNumPacketsSent() const { return mNumPacketsSent; }
+    int GetNumPacketsDropped() const { return mNumPacketsDropped; }
+
+    // Reads --net-player N, --net-port N, --net-peer host:port,
+    // --net-latency MS, --net-loss PERCENT, --net-bot SEED and --net-ticks N.
+    // Returns false if argv[i] isn't one of them, otherwise advances i past
+    // its value. A missing, malformed or out of range value (ports are 1 to
+    // 65535) is logged and clears isValid.
+    static bool ParseOption(int argc, char** argv, int& i, NetplayParams& params, bool& isValid);
+
+private:
+    struct RemoteInput
+    {
+        uint32_t tick = UINT32_MAX;
+        NetInput input;
+        bool isConfirmed = false;
+        bool wasPredicted = false;  // Simulated with a prediction before it arrived
+        NetInput prediction;
+    };
+
+    struct Checksum
+    {
+        uint32_t tick = UINT32_MAX;
+        uint64_t local = 0;
+        uint64_t remote = 0;
+        bool hasLocal = false;
+        bool hasRemote = false;
+        bool isCompared = false;
+    };
+
+    struct SavedState
+    {
+        uint32_t tick = UINT32_MAX;
+        uint32_t keyframeTick = UINT32_MAX;  // NO_KEYFRAME when data is a full state
+        uint64_t checksum = 0;
+        std::vector<uint8_t> data;           // Delta against the keyframe, empty for the keyframe itself
+    };
+
+    static const int NUM_STATES = MAX_ROLLBACK + 2;
+    static const int NUM_KEYFRAMES = (NUM_STATES + KEYFRAME_INTERVAL - 1) / KEYFRAME_INTERVAL + 1;
+    static const uint32_t NO_KEYFRAME = UINT32_MAX;
+
+    struct DelayedPacket
+    {
+        uint32_t sendTime;
+        std::vector<uint8_t> data;
+    };
+
+    void Receive(uint32_t now);
+    void HandlePacket(const uint8_t* data, size_t size, uint32_t now);
+    void ReceiveRemoteInput(uint32_t tick, const NetInput& input);
+    void CompareChecksum(Checksum& checksum);
+
+    // The remote player keeps holding what it held in its last known input
+    NetInput Predict() const;
+
+    void WritePacket(std::vector<uint8_t>& packet, uint8_t type);
+    void Send(std::vector<uint8_t>& packet, uint32_t now);
+    void SendNow(const std::vector<uint8_t>& packet);
+
+    NetplayParams mParams;
+
+    // Platform socket handle and the peer's address
+    intptr_t mSocket;
+    uint8_t mPeerAddress[16];
+
+    // Local inputs by tick, the next tick without one and the ticks the peer
+    // has acknowledged (it has all inputs before it)
+    NetInput mLocalInputs[INPUT_HISTORY];
+    uint32_t mLocalTicks;
+    uint32_t mLocalAcked;
+
+    // Remote inputs by tick and the ticks received without a gap
+    RemoteInput mRemoteInputs[INPUT_HISTORY];
+    uint32_t mRemoteTicks;
+
+    uint32_t mRollbackTick;
+    uint32_t mHistoryStart;
+    SavedState mStates[NUM_STATES];
+    SavedState mKeyframes[NUM_KEYFRAMES];  // Full states of the ticks divisible by KEYFRAME_INTERVAL
+
+    Checksum mChecksums[INPUT_HISTORY];
+    uint32_t mLastChecksumTick;
+    int mNumDesyncs;
+
+    bool mHasPeer;
+    bool mPeerLeft;
+    uint32_t mLastReceiveTime;
+
+    // Packets held back to simulate latency, and the stream deciding losses
+    // (not the global generator, which is part of the game state)
+    std::deque<DelayedPacket> mDelayed;
+    RandomStream mLossRandom;
+    int mNumPacketsSent;
+    int mNumPacketsDropped;
+
+    std::vector<uint8_t> mPacket;
+};
@@ -7,6 +7,86 @@
 // ----------------------------------------------------------------
 
 #include "Random.h"
+#include <random>
+
+RandomStream::RandomStream(uint64_t seed, uint64_t stream)
+	:mState(0)
+	,mIncrement(0)
+{
+	Seed(seed, stream);
+}
+
+void RandomStream::Seed(uint64_t seed, uint64_t stream)
+{
+	// Reference PCG32 seeding; the increment must be odd
+	mState = 0;
+	mIncrement = (stream << 1u) | 1u;
+	NextUInt();
+	mState += seed;
+	NextUInt();
+}
+
+RandomStream RandomStream::Fork()
+{
+	uint64_t seed = NextUInt64();
+	uint64_t stream = NextUInt64();
+	return RandomStream(seed, stream);
+}
+
+int RandomStream::GetIntRange(int min, int max)
+{
+	uint32_t range = static_cast<uint32_t>(static_cast<int64_t>(max) - min) + 1u;
+	if (range == 0) {
+		// Full 32-bit range
+		return static_cast<int>(NextUInt());
+	}
+
+	uint64_t m = static_cast<uint64_t>(NextUInt()) * range;
+	uint32_t low = static_cast<uint32_t>(m);
+	if (low < range) {
+		uint32_t threshold = (0u - range) % range;
+		while (low < threshold) {
+			m = static_cast<uint64_t>(NextUInt()) * range;
+			low = static_cast<uint32_t>(m);
+		}
+	}
+
+	return static_cast<int>(static_cast<int64_t>(min) + static_cast<int64_t>(m >> 32));
+}
+
+Vector2 RandomStream::GetVector(const Vector2& min, const Vector2& max)
+{
+	Vector2 r = Vector2(GetFloat(), GetFloat());
+	return min + (max - min) * r;
+}
+
+Vector3 RandomStream::GetVector(const Vector3& min, const Vector3& max)
+{
+	Vector3 r = Vector3(GetFloat(), GetFloat(), GetFloat());
+	return min + (max - min) * r;
+}
+
+void RandomStream::Fill(uint32_t* out, size_t count)
+{
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = NextUInt();
+	}
+}
+
+void RandomStream::FillFloatRange(float* out, size_t count, float min, float max)
+{
+	const float scale = (max - min) * (1.0f / 16777216.0f);
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = min + static_cast<float>(NextUInt() >> 8) * scale;
+	}
+}
+
+void RandomStream::FillIntRange(int* out, size_t count, int min, int max)
+{
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = GetIntRange(min, max);
+	}
+}
 
 void Random::Init()
 {
@@ -16,36 +96,32 @@ void Random::Init()
 
 void Random::Seed(unsigned int seed)
 {
-	sGenerator.seed(seed);
+	sGenerator.Seed(seed);
 }
 
 float Random::GetFloat()
 {
-	return GetFloatRange(0.0f, 1.0f);
+	return sGenerator.GetFloat();
 }
 
 float Random::GetFloatRange(float min, float max)
 {
-	std::uniform_real_distribution<float> dist(min, max);
-	return dist(sGenerator);
+	return sGenerator.GetFloatRange(min, max);
 }
 
 int Random::GetIntRange(int min, int max)
 {
-	std::uniform_int_distribution<int> dist(min, max);
-	return dist(sGenerator);
+	return sGenerator.GetIntRange(min, max);
 }
 
 Vector2 Random::GetVector(const Vector2& min, const Vector2& max)
 {
-	Vector2 r = Vector2(GetFloat(), GetFloat());
-	return min + (max - min) * r;
+	return sGenerator.GetVector(min, max);
 }
 
 Vector3 Random::GetVector(const Vector3& min, const Vector3& max)
 {
-	Vector3 r = Vector3(GetFloat(), GetFloat(), GetFloat());
-	return min + (max - min) * r;
+	return sGenerator.GetVector(min, max);
 }
 
-std::mt19937 Random::sGenerator;
+RandomStream Random::sGenerator;
@@ -7,9 +7,71 @@
 // ----------------------------------------------------------------
 
 #pragma  once
-#include <random>
+#include <cstddef>
+#include <cstdint>
 #include "Math.h"
 
+// PCG32 generator (16 bytes of state). Streams built from the same seed with
+// different stream ids are independent, so each system or worker thread can
+// own one instead of sharing the global generator. Plain data, so it can be
+// copied into snapshots as is.
+class RandomStream
+{
+public:
+	explicit RandomStream(uint64_t seed = 0x853C49E6748FEA9BULL, uint64_t stream = 0);
+
+	void Seed(uint64_t seed, uint64_t stream = 0);
+
+	// New independent stream seeded from this one (advances this stream)
+	RandomStream Fork();
+
+	uint32_t NextUInt()
+	{
+		uint64_t oldState = mState;
+		mState = oldState * MULTIPLIER + mIncrement;
+		uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+		uint32_t rot = static_cast<uint32_t>(oldState >> 59u);
+		return (xorShifted >> rot) | (xorShifted << ((32u - rot) & 31u));
+	}
+
+	uint64_t NextUInt64()
+	{
+		uint64_t high = NextUInt();
+		return (high << 32) | NextUInt();
+	}
+
+	// Float in [0, 1), from the top 24 bits
+	float GetFloat()
+	{
+		return static_cast<float>(NextUInt() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// Float in [min, max)
+	float GetFloatRange(float min, float max)
+	{
+		return min + (max - min) * GetFloat();
+	}
+
+	// Int in [min, max]. Multiply-shift mapping; the retry loop only runs
+	// when the draw lands in the biased low end, which is rare for the
+	// small ranges gameplay uses.
+	int GetIntRange(int min, int max);
+
+	Vector2 GetVector(const Vector2& min, const Vector2& max);
+	Vector3 GetVector(const Vector3& min, const Vector3& max);
+
+	// Bulk fills
+	void Fill(uint32_t* out, size_t count);
+	void FillFloatRange(float* out, size_t count, float min, float max);
+	void FillIntRange(int* out, size_t count, int min, int max);
+
+private:
+	static const uint64_t MULTIPLIER = 6364136223846793005ULL;
+
+	uint64_t mState;
+	uint64_t mIncrement;
+};
+
 class Random
 {
 public:
@@ -21,7 +83,7 @@ public:
 
 	// Get a float between 0.0f and 1.0f
 	static float GetFloat();
-	
+
 	// Get a float from the specified range
 	static float GetFloatRange(float min, float max);
 
@@ -31,6 +93,14 @@ public:
 	// Get a random vector given the min/max bounds
 	static Vector2 GetVector(const Vector2& min, const Vector2& max);
 	static Vector3 GetVector(const Vector3& min, const Vector3& max);
+
+	// Stream for a system or worker thread, forked from the global one so it
+	// is deterministic for a given seed. Main thread only.
+	static RandomStream Fork() { return sGenerator.Fork(); }
+
+	// Generator state, saved and restored with world snapshots
+	static const RandomStream& GetGenerator() { return sGenerator; }
+	static void SetGenerator(const RandomStream& generator) { sGenerator = generator; }
 private:
-	static std::mt19937 sGenerator;
+	static RandomStream sGenerator;
 };
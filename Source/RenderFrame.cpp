@@ -0,0 +1,212 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "RenderFrame.h"
+#include "JobSystem.h"
+
+RenderFrame::RenderFrame()
+    :mBackgroundColor(Vector3::Zero)
+    ,mTick(0)
+{
+}
+
+void RenderFrame::Clear()
+{
+    mCommands.clear();
+    mBackgroundColor = Vector3::Zero;
+    mTick = 0;
+}
+
+void RenderFrame::Copy(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect& dstRect, float angle,
+                       SDL_RendererFlip flip, SDL_Color color)
+{
+    if (!texture) {
+        return;
+    }
+
+    RenderCommand command;
+    command.type = RenderCommand::Type::Copy;
+    command.flip = flip;
+    command.hasSrcRect = srcRect != nullptr;
+    command.color = color;
+    command.texture = texture;
+    command.srcRect = srcRect ? *srcRect : SDL_Rect{0, 0, 0, 0};
+    command.dstRect = dstRect;
+    command.angle = angle;
+    mCommands.push_back(command);
+}
+
+void RenderFrame::FillRect(const SDL_Rect& rect, SDL_Color color)
+{
+    RenderCommand command;
+    command.type = RenderCommand::Type::FillRect;
+    command.flip = SDL_FLIP_NONE;
+    command.hasSrcRect = false;
+    command.color = color;
+    command.texture = nullptr;
+    command.srcRect = {0, 0, 0, 0};
+    command.dstRect = rect;
+    command.angle = 0.0f;
+    mCommands.push_back(command);
+}
+
+void RenderFrame::DrawLine(int x1, int y1, int x2, int y2, SDL_Color color)
+{
+    RenderCommand command;
+    command.type = RenderCommand::Type::Line;
+    command.flip = SDL_FLIP_NONE;
+    command.hasSrcRect = false;
+    command.color = color;
+    command.texture = nullptr;
+    command.srcRect = {0, 0, 0, 0};
+    command.dstRect = {x1, y1, x2, y2};
+    command.angle = 0.0f;
+    mCommands.push_back(command);
+}
+
+void RenderFrame::Execute(SDL_Renderer* renderer, DrawCounts& counts) const
+{
+    // Texture state is only set when it changes. Commands come in the order
+    // they were recorded, which Game::GetDrawablesOnCamera already sorts by
+    // texture inside a draw order, so sprites sharing an atlas page reuse it.
+    const SDL_Texture* lastTexture = nullptr;
+    SDL_Color lastColor = {255, 255, 255, 255};
+
+    const SDL_Texture* lastDrawnTexture = nullptr;
+
+    for (const auto& command : mCommands)
+    {
+        const SDL_Color& color = command.color;
+
+        switch (command.type)
+        {
+            case RenderCommand::Type::Copy:
+                if (command.texture != lastTexture || color.r != lastColor.r || color.g != lastColor.g ||
+                    color.b != lastColor.b || color.a != lastColor.a)
+                {
+                    SDL_SetTextureBlendMode(command.texture, SDL_BLENDMODE_BLEND);
+                    SDL_SetTextureColorMod(command.texture, color.r, color.g, color.b);
+                    SDL_SetTextureAlphaMod(command.texture, color.a);
+                    lastTexture = command.texture;
+                    lastColor = color;
+                }
+
+                counts.drawCalls++;
+                if (command.texture != lastDrawnTexture) {
+                    counts.textureChanges++;
+                    lastDrawnTexture = command.texture;
+                }
+                SDL_RenderCopyEx(renderer, command.texture, command.hasSrcRect ? &command.srcRect : nullptr,
+                                 &command.dstRect, command.angle, nullptr, command.flip);
+                break;
+            case RenderCommand::Type::FillRect:
+                counts.drawCalls++;
+                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+                SDL_RenderFillRect(renderer, &command.dstRect);
+                break;
+            case RenderCommand::Type::Line:
+                counts.drawCalls++;
+                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+                SDL_RenderDrawLine(renderer, command.dstRect.x, command.dstRect.y,
+                                   command.dstRect.w, command.dstRect.h);
+                break;
+        }
+    }
+}
+
+RenderFrameBuffer::RenderFrameBuffer()
+    :mWriteIndex(0)
+    ,mReadIndex(1)
+    ,mShared(2)
+{
+}
+
+void RenderFrameBuffer::Publish()
+{
+    // Hand the frame over and take back the one the reader skipped (or
+    // released, if it already picked up the last one)
+    int shared = mShared.exchange(mWriteIndex | FRESH_BIT, std::memory_order_acq_rel);
+    mWriteIndex = shared & INDEX_MASK;
+}
+
+const RenderFrame* RenderFrameBuffer::AcquireLatest()
+{
+    if ((mShared.load(std::memory_order_acquire) & FRESH_BIT) == 0) {
+        return nullptr;
+    }
+
+    int shared = mShared.exchange(mReadIndex, std::memory_order_acq_rel);
+    mReadIndex = shared & INDEX_MASK;
+    return &mFrames[mReadIndex];
+}
+
+SDL_Renderer* RenderResources::sRenderer = nullptr;
+JobSystem* RenderResources::sJobs = nullptr;
+std::atomic<uint32_t> RenderResources::sTick(0);
+std::mutex RenderResources::sReleasedMutex;
+std::vector<RenderResources::ReleasedTexture> RenderResources::sReleased;
+
+void RenderResources::Init(SDL_Renderer* renderer, JobSystem* jobs)
+{
+    sRenderer = renderer;
+    sJobs = jobs;
+    sTick.store(0, std::memory_order_relaxed);
+}
+
+void RenderResources::Shutdown()
+{
+    std::lock_guard<std::mutex> lock(sReleasedMutex);
+    for (const auto& released : sReleased) {
+        SDL_DestroyTexture(released.texture);
+    }
+    sReleased.clear();
+    sJobs = nullptr;
+}
+
+SDL_Texture* RenderResources::CreateTexture(SDL_Surface* surface)
+{
+    if (!sJobs) {
+        return SDL_CreateTextureFromSurface(sRenderer, surface);
+    }
+
+    // Runs right away when called from the render thread
+    SDL_Texture* texture = nullptr;
+    JobCounter counter;
+    sJobs->RunOnMainThread([&texture, surface]() {
+        texture = SDL_CreateTextureFromSurface(sRenderer, surface);
+    }, &counter);
+    sJobs->Wait(counter);
+    return texture;
+}
+
+void RenderResources::ReleaseTexture(SDL_Texture* texture)
+{
+    if (!texture) {
+        return;
+    }
+
+    if (!sJobs) {
+        SDL_DestroyTexture(texture);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(sReleasedMutex);
+    sReleased.push_back({texture, sTick.load(std::memory_order_relaxed)});
+}
+
+void RenderResources::CollectReleased(uint32_t tick)
+{
+    std::lock_guard<std::mutex> lock(sReleasedMutex);
+
+    auto iter = sReleased.begin();
+    while (iter != sReleased.end())
+    {
+        if (iter->tick <= tick) {
+            SDL_DestroyTexture(iter->texture);
+            iter = sReleased.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
@@ -0,0 +1,141 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <SDL.h>
+#include "Math.h"
+
+// A draw call recorded by the simulation and replayed by the renderer
+struct RenderCommand
+{
+    enum class Type : uint8_t
+    {
+        Copy,
+        FillRect,
+        Line
+    };
+
+    Type type;
+    SDL_RendererFlip flip;
+    bool hasSrcRect;
+    SDL_Color color;        // Color and alpha mod of a copy, draw color otherwise
+    SDL_Texture* texture;
+    SDL_Rect srcRect;
+    SDL_Rect dstRect;       // A line goes from (x, y) to (w, h)
+    float angle;
+};
+
+// Everything drawn in a frame, in draw order. Draw components and UI screens
+// record into it instead of calling SDL, so the frame can be drawn by another
+// thread while the simulation moves on. Textures referenced by a frame must
+// outlive it (see RenderResources::ReleaseTexture).
+class RenderFrame
+{
+public:
+    RenderFrame();
+
+    // Keeps the memory of the commands for the next frame
+    void Clear();
+
+    void Copy(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect& dstRect, float angle = 0.0f,
+              SDL_RendererFlip flip = SDL_FLIP_NONE, SDL_Color color = {255, 255, 255, 255});
+    void FillRect(const SDL_Rect& rect, SDL_Color color);
+    void DrawLine(int x1, int y1, int x2, int y2, SDL_Color color);
+
+    // Draws issued by Execute, summed by the caller over one presented frame
+    struct DrawCounts
+    {
+        uint64_t drawCalls = 0;
+        uint64_t textureChanges = 0;
+    };
+
+    // Draw the commands (the target is cleared by the caller)
+    void Execute(SDL_Renderer* renderer, DrawCounts& counts) const;
+
+    // Color the target is cleared with
+    const Vector3& GetBackgroundColor() const { return mBackgroundColor; }
+    void SetBackgroundColor(const Vector3& color) { mBackgroundColor = color; }
+
+    // Simulation tick the frame was recorded in
+    uint32_t GetTick() const { return mTick; }
+    void SetTick(uint32_t tick) { mTick = tick; }
+
+    size_t GetNumCommands() const { return mCommands.size(); }
+
+private:
+    std::vector<RenderCommand> mCommands;
+    Vector3 mBackgroundColor;
+    uint32_t mTick;
+};
+
+// Triple buffer of frames between the simulation (writer) and the render
+// thread (reader). The writer records into its own frame and publishes it by
+// swapping it with the shared one, the reader picks up the latest published
+// frame the same way, so neither side ever waits for the other. Frames the
+// reader didn't get to in time are simply overwritten.
+class RenderFrameBuffer
+{
+public:
+    RenderFrameBuffer();
+
+    // Writer
+    RenderFrame& GetWriteFrame() { return mFrames[mWriteIndex]; }
+    void Publish();
+
+    // Reader: the frame published since the last call, or null if none was
+    const RenderFrame* AcquireLatest();
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH_BIT = 4;
+
+    RenderFrame mFrames[3];
+    int mWriteIndex;
+    int mReadIndex;
+
+    // Index of the shared frame, plus FRESH_BIT once published and not yet read
+    std::atomic<int> mShared;
+};
+
+// Textures have to be created and destroyed on the render thread. When the
+// simulation runs on its own thread (Init with a job system), creating one
+// from it waits until the render thread has made it, and released textures
+// are kept until the render thread draws a frame recorded after the release,
+// since the frames before may still use them. Otherwise both happen at once.
+class RenderResources
+{
+public:
+    static void Init(SDL_Renderer* renderer, class JobSystem* jobs);
+
+    // Destroy the textures still waiting. Call once the simulation thread is gone.
+    static void Shutdown();
+
+    static SDL_Texture* CreateTexture(SDL_Surface* surface);
+    static void ReleaseTexture(SDL_Texture* texture);
+
+    // Simulation: tick being simulated (tags the textures released during it)
+    static void BeginTick(uint32_t tick) { sTick.store(tick, std::memory_order_relaxed); }
+
+    // Render thread: destroy the textures no frame from tick onwards uses
+    static void CollectReleased(uint32_t tick);
+
+private:
+    struct ReleasedTexture
+    {
+        SDL_Texture* texture;
+        uint32_t tick;
+    };
+
+    static SDL_Renderer* sRenderer;
+    static class JobSystem* sJobs;
+    static std::atomic<uint32_t> sTick;
+
+    static std::mutex sReleasedMutex;
+    static std::vector<ReleasedTexture> sReleased;
+};
@@ -0,0 +1,142 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "SceneArena.h"
+#include <cstdint>
+#include <new>
+
+SceneArena* SceneArena::sCurrent = nullptr;
+
+namespace
+{
+    const size_t ALIGNMENT = alignof(std::max_align_t);
+
+    size_t AlignUp(size_t value)
+    {
+        return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    // Header in front of every object from AllocateObject, padded to the
+    // alignment so the object stays aligned
+    struct ObjectHeader
+    {
+        SceneArena* arena; // Null when the object came from the global heap
+        size_t size;       // Of the whole block, as allocated from the arena
+    };
+
+    const size_t HEADER_SIZE = AlignUp(sizeof(ObjectHeader));
+}
+
+SceneArena::SceneArena(size_t slabSize)
+    : mSlabSize(slabSize)
+    , mCurrentSlab(0)
+    , mOffset(0)
+    , mBytesUsed(0)
+{
+}
+
+SceneArena::~SceneArena()
+{
+    if (sCurrent == this) {
+        sCurrent = nullptr;
+    }
+
+    for (auto& slab : mSlabs) {
+        ::operator delete(slab.memory);
+    }
+    mSlabs.clear();
+}
+
+void* SceneArena::Allocate(size_t size)
+{
+    size = AlignUp(size);
+
+    const size_t sizeClass = size / ALIGNMENT;
+    if (sizeClass < mFreeLists.size() && mFreeLists[sizeClass])
+    {
+        void* ptr = mFreeLists[sizeClass];
+        mFreeLists[sizeClass] = *static_cast<void**>(ptr);
+        return ptr;
+    }
+
+    // Move on to the next slab with room, keeping slabs from earlier scenes
+    while (mCurrentSlab < mSlabs.size() && mOffset + size > mSlabs[mCurrentSlab].size)
+    {
+        mCurrentSlab++;
+        mOffset = 0;
+    }
+
+    if (mCurrentSlab == mSlabs.size())
+    {
+        size_t slabSize = size > mSlabSize ? size : mSlabSize;
+        mSlabs.push_back({static_cast<char*>(::operator new(slabSize)), slabSize});
+        mOffset = 0;
+    }
+
+    void* ptr = mSlabs[mCurrentSlab].memory + mOffset;
+    mOffset += size;
+    mBytesUsed += size;
+    return ptr;
+}
+
+void SceneArena::Free(void* ptr, size_t size)
+{
+    const size_t sizeClass = AlignUp(size) / ALIGNMENT;
+    if (sizeClass >= mFreeLists.size()) {
+        mFreeLists.resize(sizeClass + 1, nullptr);
+    }
+
+    *static_cast<void**>(ptr) = mFreeLists[sizeClass];
+    mFreeLists[sizeClass] = ptr;
+}
+
+void SceneArena::Reset()
+{
+    mFreeLists.clear();
+    mCurrentSlab = 0;
+    mOffset = 0;
+    mBytesUsed = 0;
+}
+
+bool SceneArena::Owns(const void* ptr) const
+{
+    const char* p = static_cast<const char*>(ptr);
+    for (const auto& slab : mSlabs)
+    {
+        if (p >= slab.memory && p < slab.memory + slab.size) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void* SceneArena::AllocateObject(size_t size)
+{
+    ObjectHeader header = {sCurrent, size + HEADER_SIZE};
+    char* block;
+    if (sCurrent) {
+        block = static_cast<char*>(sCurrent->Allocate(header.size));
+    } else {
+        block = static_cast<char*>(::operator new(header.size));
+    }
+
+    *reinterpret_cast<ObjectHeader*>(block) = header;
+    return block + HEADER_SIZE;
+}
+
+void SceneArena::FreeObject(void* ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    char* block = static_cast<char*>(ptr) - HEADER_SIZE;
+    const ObjectHeader header = *reinterpret_cast<const ObjectHeader*>(block);
+    if (header.arena) {
+        header.arena->Free(block, header.size);
+    } else {
+        ::operator delete(block);
+    }
+}
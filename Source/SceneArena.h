@@ -0,0 +1,71 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Bump allocator for objects that live as long as a scene (actors and their
+// components). Allocating is a pointer bump inside a slab. A freed object goes
+// on a free list for its size, so the next object of that size (e.g. the same
+// actor coming back in a snapshot restore) reuses it, and Reset() rewinds
+// every slab at once when the scene is unloaded. Destructors are not the
+// arena's business: objects are still deleted as usual (so they release their
+// SDL resources), only their memory comes from here.
+//
+// Actor and Component route their operator new/delete to the current arena,
+// falling back to the global heap when there is none. Each object is preceded
+// by a small header saying where it came from, so deleting one never has to
+// search the slabs.
+class SceneArena
+{
+public:
+    explicit SceneArena(size_t slabSize = 64 * 1024);
+    ~SceneArena();
+
+    SceneArena(const SceneArena&) = delete;
+    SceneArena& operator=(const SceneArena&) = delete;
+
+    void* Allocate(size_t size);
+    // Give a block back for the next allocation of the same size
+    void Free(void* ptr, size_t size);
+
+    // Make every slab available again. Everything allocated from the arena
+    // must have been destroyed by then.
+    void Reset();
+
+    // Linear in the slabs, for checks and tools, not for the delete path
+    bool Owns(const void* ptr) const;
+
+    size_t GetNumSlabs() const { return mSlabs.size(); }
+    // Bytes taken from the slabs since the last Reset, free blocks included
+    size_t GetBytesUsed() const { return mBytesUsed; }
+
+    static SceneArena* GetCurrent() { return sCurrent; }
+    static void SetCurrent(SceneArena* arena) { sCurrent = arena; }
+
+    // Used by the class-level operator new/delete
+    static void* AllocateObject(size_t size);
+    static void FreeObject(void* ptr);
+
+private:
+    struct Slab
+    {
+        char* memory;
+        size_t size;
+    };
+
+    std::vector<Slab> mSlabs;
+    size_t mSlabSize;
+    size_t mCurrentSlab; // Slab being bumped
+    size_t mOffset;      // First free byte in the current slab
+    size_t mBytesUsed;
+
+    // Heads of the lists of free blocks, by size in alignment units. Each
+    // free block starts with a pointer to the next one.
+    std::vector<void*> mFreeLists;
+
+    static SceneArena* sCurrent;
+};
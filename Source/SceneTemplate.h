@@ -0,0 +1,36 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Math.h"
+#include "StringId.h"
+
+// What a level spawns, built once from its CSV file. Restarting the level
+// instantiates the actors from here instead of reading and parsing the file.
+struct SceneTemplate
+{
+    enum class Archetype
+    {
+        Player,
+        Cheese,
+        Exit,
+        Block,
+        Goomba
+    };
+
+    struct Spawn
+    {
+        Archetype archetype;
+        Vector2 position;
+        StringId texture;   // Blocks only
+    };
+
+    std::vector<Spawn> spawns;
+
+    // Time the first (cold) load took, to compare restarts against
+    float buildTimeMs = 0.0f;
+};
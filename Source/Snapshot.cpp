@@ -0,0 +1,216 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "Snapshot.h"
+
+SnapshotWriter::SnapshotWriter(std::vector<uint8_t>& buffer)
+    :mBuffer(buffer)
+{
+    mBuffer.clear();
+
+    // Offset of the string table, patched by Finish
+    Write<uint32_t>(0);
+}
+
+void SnapshotWriter::WriteString(const std::string& value)
+{
+    auto iter = mStringIndices.find(value);
+    if (iter == mStringIndices.end())
+    {
+        iter = mStringIndices.emplace(value, static_cast<uint16_t>(mStrings.size())).first;
+        mStrings.emplace_back(&iter->first);
+    }
+
+    Write<uint16_t>(iter->second);
+}
+
+void SnapshotWriter::Finish()
+{
+    Patch<uint32_t>(0, static_cast<uint32_t>(mBuffer.size()));
+
+    Write<uint16_t>(static_cast<uint16_t>(mStrings.size()));
+    for (auto string : mStrings)
+    {
+        Write<uint16_t>(static_cast<uint16_t>(string->size()));
+        mBuffer.insert(mBuffer.end(), string->begin(), string->end());
+    }
+}
+
+SnapshotReader::SnapshotReader(const uint8_t* data, size_t size)
+    :mData(data)
+    ,mSize(size)
+    ,mPos(0)
+    ,mFailed(false)
+    ,mStrings(std::make_shared<std::vector<std::string>>())
+{
+    uint32_t tableOffset = Read<uint32_t>();
+    if (mFailed || tableOffset < mPos || tableOffset > size) {
+        mFailed = true;
+        return;
+    }
+
+    // Read the table with a reader over the end of the blob
+    SnapshotReader table(data + tableOffset, size - tableOffset, mStrings);
+    uint16_t count = table.Read<uint16_t>();
+    for (uint16_t i = 0; i < count && !table.IsFailed(); ++i)
+    {
+        uint16_t length = table.Read<uint16_t>();
+        if (table.mPos + length > table.mSize) {
+            table.mFailed = true;
+            break;
+        }
+        mStrings->emplace_back(reinterpret_cast<const char*>(table.mData + table.mPos), length);
+        table.mPos += length;
+    }
+
+    mFailed = table.IsFailed();
+    mSize = tableOffset;
+}
+
+SnapshotReader::SnapshotReader(const uint8_t* data, size_t size, std::shared_ptr<std::vector<std::string>> strings)
+    :mData(data)
+    ,mSize(size)
+    ,mPos(0)
+    ,mFailed(false)
+    ,mStrings(std::move(strings))
+{
+}
+
+const std::string& SnapshotReader::ReadString()
+{
+    static const std::string empty;
+
+    uint16_t index = Read<uint16_t>();
+    if (mFailed || index >= mStrings->size()) {
+        mFailed = true;
+        return empty;
+    }
+
+    return (*mStrings)[index];
+}
+
+SnapshotReader SnapshotReader::Slice(size_t size)
+{
+    if (mPos + size > mSize) {
+        mFailed = true;
+        size = 0;
+    }
+
+    SnapshotReader slice(mData + mPos, size, mStrings);
+    mPos += size;
+    return slice;
+}
+
+namespace
+{
+    void WriteVarint(std::vector<uint8_t>& out, size_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool ReadVarint(const std::vector<uint8_t>& in, size_t& pos, size_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (pos >= in.size()) {
+                return false;
+            }
+
+            uint8_t byte = in[pos++];
+            value |= static_cast<size_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint8_t BaseByte(const std::vector<uint8_t>& base, size_t i)
+    {
+        return i < base.size() ? base[i] : 0;
+    }
+}
+
+// Layout: snapshot size, then pairs of (zero run, literal count, literals)
+void SnapshotDelta::Encode(const std::vector<uint8_t>& base, const std::vector<uint8_t>& snapshot,
+                           std::vector<uint8_t>& delta)
+{
+    delta.clear();
+    WriteVarint(delta, snapshot.size());
+
+    const size_t size = snapshot.size();
+    size_t i = 0;
+    while (i < size)
+    {
+        size_t zeros = i;
+        while (zeros < size && snapshot[zeros] == BaseByte(base, zeros)) {
+            ++zeros;
+        }
+
+        // A short run of zeros between changes is cheaper kept as literals
+        size_t literals = zeros;
+        while (literals < size)
+        {
+            if (snapshot[literals] != BaseByte(base, literals)) {
+                ++literals;
+                continue;
+            }
+
+            size_t run = literals;
+            while (run < size && run - literals < 4 && snapshot[run] == BaseByte(base, run)) {
+                ++run;
+            }
+            if (run - literals < 4 && run < size) {
+                literals = run;
+            } else {
+                break;
+            }
+        }
+
+        WriteVarint(delta, zeros - i);
+        WriteVarint(delta, literals - zeros);
+        for (size_t j = zeros; j < literals; ++j) {
+            delta.push_back(snapshot[j] ^ BaseByte(base, j));
+        }
+
+        i = literals;
+    }
+}
+
+bool SnapshotDelta::Decode(const std::vector<uint8_t>& base, const std::vector<uint8_t>& delta,
+                           std::vector<uint8_t>& snapshot)
+{
+    size_t pos = 0;
+    size_t size = 0;
+    if (!ReadVarint(delta, pos, size)) {
+        return false;
+    }
+
+    snapshot.resize(size);
+
+    size_t i = 0;
+    while (i < size)
+    {
+        size_t zeros = 0;
+        size_t literals = 0;
+        if (!ReadVarint(delta, pos, zeros) || !ReadVarint(delta, pos, literals) ||
+            zeros + literals > size - i || literals > delta.size() - pos) {
+            return false;
+        }
+
+        for (size_t j = 0; j < zeros; ++j, ++i) {
+            snapshot[i] = BaseByte(base, i);
+        }
+        for (size_t j = 0; j < literals; ++j, ++i) {
+            snapshot[i] = delta[pos++] ^ BaseByte(base, i);
+        }
+    }
+
+    return pos == delta.size();
+}
@@ -0,0 +1,112 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Binary blob of the world state written by Game::SaveSnapshot. Values are
+// stored as raw bytes in the host byte order, so snapshots are only meant to
+// be read back by the same build (retry, rewind, rollback), not saved to disk.
+//
+// Strings go into a table at the end of the blob and are written as indices,
+// so the sprite path of every block doesn't get repeated.
+class SnapshotWriter
+{
+public:
+    explicit SnapshotWriter(std::vector<uint8_t>& buffer);
+
+    template <typename T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written");
+        size_t offset = mBuffer.size();
+        mBuffer.resize(offset + sizeof(T));
+        std::memcpy(mBuffer.data() + offset, &value, sizeof(T));
+    }
+
+    void WriteString(const std::string& value);
+
+    // Overwrite a value written earlier (e.g. a size only known afterwards)
+    template <typename T>
+    void Patch(size_t offset, const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written");
+        std::memcpy(mBuffer.data() + offset, &value, sizeof(T));
+    }
+
+    size_t GetSize() const { return mBuffer.size(); }
+
+    // Append the string table. Nothing may be written afterwards.
+    void Finish();
+
+private:
+    std::vector<uint8_t>& mBuffer;
+    std::vector<const std::string*> mStrings;
+    std::unordered_map<std::string, uint16_t> mStringIndices;
+};
+
+// Reads what a SnapshotWriter wrote. Reading past the end (or a bad string
+// index) doesn't crash: it returns zeros and marks the reader as failed.
+class SnapshotReader
+{
+public:
+    SnapshotReader(const uint8_t* data, size_t size);
+
+    template <typename T>
+    T Read()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read");
+        T value{};
+        if (mPos + sizeof(T) > mSize) {
+            mFailed = true;
+            mPos = mSize;
+            return value;
+        }
+        std::memcpy(&value, mData + mPos, sizeof(T));
+        mPos += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    void Read(T& value) { value = Read<T>(); }
+
+    const std::string& ReadString();
+
+    // Reader over the next size bytes, sharing this reader's string table
+    SnapshotReader Slice(size_t size);
+
+    bool IsFailed() const { return mFailed; }
+    bool IsAtEnd() const { return mPos == mSize; }
+
+private:
+    SnapshotReader(const uint8_t* data, size_t size, std::shared_ptr<std::vector<std::string>> strings);
+
+    const uint8_t* mData;
+    size_t mSize;
+    size_t mPos;
+    bool mFailed;
+    std::shared_ptr<std::vector<std::string>> mStrings;
+};
+
+// Delta encoding of a snapshot against a previous one: the bytes are XORed
+// with the base and the runs of zeros (everything that didn't change) are
+// run-length encoded. Snapshots of consecutive ticks differ in a few
+// positions and timers, so their deltas are a small fraction of the size.
+class SnapshotDelta
+{
+public:
+    static void Encode(const std::vector<uint8_t>& base, const std::vector<uint8_t>& snapshot,
+                       std::vector<uint8_t>& delta);
+
+    // Returns false if the delta is corrupt
+    static bool Decode(const std::vector<uint8_t>& base, const std::vector<uint8_t>& delta,
+                       std::vector<uint8_t>& snapshot);
+};
@@ -7,7 +7,7 @@
 #include <algorithm>
 
 SpatialHashing::SpatialHashing(int cellSize, int width, int height)
-    : mCellSize(cellSize), mWidth(width), mHeight(height)
+    : BroadPhase(cellSize, width, height)
 {
     int cols = (width + cellSize - 1) / cellSize;
     int rows = (height + cellSize - 1) / cellSize;
@@ -110,23 +110,6 @@ std::vector<Actor*> SpatialHashing::Query(const Vector2& position, const int ran
     return results;
 }
 
-std::vector<AABBColliderComponent *> SpatialHashing::QueryColliders(const Vector2& position, const int range) const
-{
-    std::vector<AABBColliderComponent*> results;
-
-    std::vector<Actor*> actors = Query(position, range);
-    for (Actor* actor : actors)
-    {
-        auto collider = actor->GetComponent<AABBColliderComponent>();
-        if (collider)
-        {
-            results.push_back(collider);
-        }
-    }
-
-    return results;
-}
-
 std::vector<Actor*> SpatialHashing::QueryOnCamera(const Vector2& cameraPosition,
                                                                   const float screenWidth,
                                                                   const float screenHeight,
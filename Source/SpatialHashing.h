@@ -7,30 +7,25 @@
 #include <vector>
 #include <unordered_map>
 #include "Math.h"
+#include "BroadPhase.h"
 #include "Actors/Actor.h"
 
-class SpatialHashing
+class SpatialHashing : public BroadPhase
 {
 public:
     SpatialHashing(int cellSize, int width, int height);
-    ~SpatialHashing();
+    ~SpatialHashing() override;
 
-    void Insert(Actor *actor);
-    void Remove(Actor *actor);
-    void Reinsert(Actor *actor);
+    void Insert(Actor *actor) override;
+    void Remove(Actor *actor) override;
+    void Reinsert(Actor *actor) override;
 
-    std::vector<AABBColliderComponent *> QueryColliders(const Vector2& position, const int range = 1) const;
-
-    std::vector<Actor*> Query(const Vector2& position, const int range = 1) const;
+    std::vector<Actor*> Query(const Vector2& position, const int range = 1) const override;
     std::vector<Actor*> QueryOnCamera(const Vector2& cameraPosition,
                                                       const float screenWidth,
                                                       const float screenHeight,
-                                                      const float extraRadius = 0.0f) const;
+                                                      const float extraRadius = 0.0f) const override;
 private:
-    int mCellSize;
-    int mWidth;
-    int mHeight;
-
     std::vector<std::vector<std::vector<Actor*> >> mGrid; // 2D grid of colliders
     std::unordered_map<Actor*, Vector2> mPositions; // Maps collider to its position
     std::unordered_map<Actor*, std::pair<int, int>> mCellIndices; // Maps collider to its grid cell indices
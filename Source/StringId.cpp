@@ -0,0 +1,47 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "StringId.h"
+#include <mutex>
+#include <unordered_map>
+#include <SDL.h>
+
+namespace
+{
+    // Strings are never removed, so references to them stay valid
+    std::mutex& GetTableMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::unordered_map<uint64_t, std::string>& GetTable()
+    {
+        static std::unordered_map<uint64_t, std::string> table;
+        return table;
+    }
+}
+
+StringId::StringId(const std::string& str)
+    :mHash(Hash(str.data(), str.size()))
+{
+    if (mHash == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(GetTableMutex());
+    auto result = GetTable().emplace(mHash, str);
+    if (!result.second && result.first->second != str) {
+        SDL_Log("String id collision between \"%s\" and \"%s\"", result.first->second.c_str(), str.c_str());
+    }
+}
+
+const std::string& StringId::GetString() const
+{
+    static const std::string empty;
+
+    std::lock_guard<std::mutex> lock(GetTableMutex());
+    auto iter = GetTable().find(mHash);
+    return iter != GetTable().end() ? iter->second : empty;
+}
@@ -0,0 +1,68 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// A string reduced to its 64-bit FNV-1a hash, so it can key maps and be
+// compared without touching the characters. "run"_id is hashed at compile
+// time. Ids made from a runtime string also intern it, so GetString can map
+// them back (asset paths need it to load the file); ids made only from
+// literals have no string unless the same text was interned somewhere else.
+class StringId
+{
+public:
+    constexpr StringId() : mHash(0) {}
+    constexpr explicit StringId(uint64_t hash) : mHash(hash) {}
+
+    // Hashes and interns the string (takes a lock, not meant for hot paths)
+    explicit StringId(const std::string& str);
+    explicit StringId(const char* str) : StringId(std::string(str)) {}
+
+    // FNV-1a, except that the empty string hashes to 0 (the empty id)
+    static constexpr uint64_t Hash(const char* str, size_t length)
+    {
+        if (length == 0) {
+            return 0;
+        }
+
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<uint8_t>(str[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    constexpr uint64_t GetHash() const { return mHash; }
+    constexpr bool IsEmpty() const { return mHash == 0; }
+
+    // The interned string, empty if it was never interned
+    const std::string& GetString() const;
+
+    constexpr bool operator==(const StringId& other) const { return mHash == other.mHash; }
+    constexpr bool operator!=(const StringId& other) const { return mHash != other.mHash; }
+    constexpr bool operator<(const StringId& other) const { return mHash < other.mHash; }
+
+private:
+    uint64_t mHash;
+};
+
+constexpr StringId operator""_id(const char* str, size_t length)
+{
+    return StringId(StringId::Hash(str, length));
+}
+
+namespace std
+{
+    template<>
+    struct hash<StringId>
+    {
+        size_t operator()(const StringId& id) const { return static_cast<size_t>(id.GetHash()); }
+    };
+}
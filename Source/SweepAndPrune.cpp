@@ -0,0 +1,151 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+SweepAndPrune::SweepAndPrune(int cellSize, int width, int height)
+    : BroadPhase(cellSize, width, height)
+{
+}
+
+SweepAndPrune::~SweepAndPrune()
+{
+    // Delete all actors (each one removes itself from the array)
+    while (!mEntries.empty())
+    {
+        delete mEntries.back().actor;
+    }
+
+    mKeys.clear();
+}
+
+void SweepAndPrune::Insert(Actor *actor)
+{
+    if (!IsInBounds(actor->GetPosition()))
+    {
+        return; // Out of bounds, do not insert
+    }
+
+    Vector2 position = GetIndexPosition(actor->GetPosition());
+
+    auto iter = std::upper_bound(mEntries.begin(), mEntries.end(), position.x,
+                                 [](float x, const Entry& entry) { return x < entry.x; });
+
+    mEntries.insert(iter, {position.x, position.y, actor});
+    mKeys[actor] = position.x;
+}
+
+void SweepAndPrune::Remove(Actor *actor)
+{
+    int index = Find(actor);
+    if (index >= 0)
+    {
+        mEntries.erase(mEntries.begin() + index);
+        mKeys.erase(actor);
+    }
+}
+
+void SweepAndPrune::Reinsert(Actor *actor)
+{
+    int index = Find(actor);
+    if (index < 0)
+    {
+        Insert(actor);
+        return;
+    }
+
+    if (!IsInBounds(actor->GetPosition()))
+    {
+        Remove(actor);
+        return;
+    }
+
+    Vector2 position = GetIndexPosition(actor->GetPosition());
+
+    mEntries[index].x = position.x;
+    mEntries[index].y = position.y;
+    mKeys[actor] = position.x;
+
+    // Shift the entry to its sorted place. Actors usually move a few pixels,
+    // but freshly spawned ones jump from the origin to their spawn point.
+    auto entry = mEntries.begin() + index;
+    if (index > 0 && mEntries[index - 1].x > position.x)
+    {
+        auto target = std::upper_bound(mEntries.begin(), entry, position.x,
+                                       [](float x, const Entry& e) { return x < e.x; });
+        std::rotate(target, entry, entry + 1);
+    }
+    else if (index + 1 < static_cast<int>(mEntries.size()) && mEntries[index + 1].x < position.x)
+    {
+        auto target = std::lower_bound(entry + 1, mEntries.end(), position.x,
+                                       [](const Entry& e, float x) { return e.x < x; });
+        std::rotate(entry, entry + 1, target);
+    }
+}
+
+int SweepAndPrune::Find(Actor* actor) const
+{
+    auto key = mKeys.find(actor);
+    if (key == mKeys.end())
+    {
+        return -1;
+    }
+
+    auto iter = std::lower_bound(mEntries.begin(), mEntries.end(), key->second,
+                                 [](const Entry& entry, float x) { return entry.x < x; });
+
+    // Several actors can share the same x
+    for (; iter != mEntries.end() && iter->x == key->second; ++iter)
+    {
+        if (iter->actor == actor)
+        {
+            return static_cast<int>(iter - mEntries.begin());
+        }
+    }
+
+    return -1;
+}
+
+void SweepAndPrune::QueryBounds(const Vector2& min, const Vector2& max, std::vector<Actor*>& results) const
+{
+    auto iter = std::lower_bound(mEntries.begin(), mEntries.end(), min.x,
+                                 [](const Entry& entry, float x) { return entry.x < x; });
+
+    for (; iter != mEntries.end() && iter->x < max.x; ++iter)
+    {
+        if (iter->y >= min.y && iter->y < max.y)
+        {
+            results.push_back(iter->actor);
+        }
+    }
+}
+
+std::vector<Actor*> SweepAndPrune::Query(const Vector2& position, const int range) const
+{
+    std::vector<Actor*> results;
+
+    Vector2 min, max;
+    if (!GetQueryBounds(position, range, min, max))
+    {
+        return results; // Out of bounds
+    }
+
+    QueryBounds(min, max, results);
+    return results;
+}
+
+std::vector<Actor*> SweepAndPrune::QueryOnCamera(const Vector2& cameraPosition,
+                                                 const float screenWidth,
+                                                 const float screenHeight,
+                                                 const float extraRadius) const
+{
+    std::vector<Actor*> results;
+
+    Vector2 min, max;
+    GetCameraBounds(cameraPosition, screenWidth, screenHeight, extraRadius, min, max);
+
+    QueryBounds(min, max, results);
+    return results;
+}
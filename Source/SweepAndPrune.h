@@ -0,0 +1,49 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include "Math.h"
+#include "BroadPhase.h"
+#include "Actors/Actor.h"
+
+// Sort-and-sweep on the x axis. Actors are kept in a single array sorted by
+// x, so a query is a binary search plus a scan over the queried columns. Our
+// levels are long and flat, which keeps those scans short. Moving an actor
+// only shifts it past its neighbours (an insertion sort step), which is
+// cheap since actors move a few pixels per frame.
+class SweepAndPrune : public BroadPhase
+{
+public:
+    SweepAndPrune(int cellSize, int width, int height);
+    ~SweepAndPrune() override;
+
+    void Insert(Actor *actor) override;
+    void Remove(Actor *actor) override;
+    void Reinsert(Actor *actor) override;
+
+    std::vector<Actor*> Query(const Vector2& position, const int range = 1) const override;
+    std::vector<Actor*> QueryOnCamera(const Vector2& cameraPosition,
+                                      const float screenWidth,
+                                      const float screenHeight,
+                                      const float extraRadius = 0.0f) const override;
+
+private:
+    struct Entry
+    {
+        float x;
+        float y;
+        Actor* actor;
+    };
+
+    // Index of the actor's entry, or -1 if it isn't in the array
+    int Find(Actor* actor) const;
+
+    void QueryBounds(const Vector2& min, const Vector2& max, std::vector<Actor*>& results) const;
+
+    std::vector<Entry> mEntries; // Sorted by x
+    std::unordered_map<Actor*, float> mKeys; // Maps actor to the x it is sorted by
+};
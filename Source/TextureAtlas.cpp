@@ -0,0 +1,203 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#include "TextureAtlas.h"
+#include "Json.h"
+#include "JobSystem.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+TextureAtlas::TextureAtlas()
+    :mResidentBytes(0)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    Unload();
+}
+
+bool TextureAtlas::Load(SDL_Renderer* renderer, const std::string& indexPath, JobSystem* jobs)
+{
+    Unload();
+
+    std::ifstream indexFile(indexPath);
+    if (!indexFile.is_open()) {
+        SDL_Log("No sprite atlas found at %s, using loose sprites", indexPath.c_str());
+        return false;
+    }
+
+    nlohmann::json index = nlohmann::json::parse(indexFile, nullptr, false);
+    if (index.is_discarded()) {
+        SDL_Log("Failed to parse sprite atlas index %s", indexPath.c_str());
+        return false;
+    }
+
+    // Pages live next to the index file
+    std::string directory = indexPath.substr(0, indexPath.find_last_of('/') + 1);
+
+    std::vector<std::string> pagePaths;
+    for (const auto& page : index["pages"]) {
+        pagePaths.emplace_back(directory + page.get<std::string>());
+    }
+
+    // Decoding the PNGs is the slow part and doesn't touch the renderer
+    std::vector<SDL_Surface*> surfaces(pagePaths.size(), nullptr);
+    auto decode = [&pagePaths, &surfaces](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            surfaces[i] = IMG_Load(pagePaths[i].c_str());
+        }
+    };
+
+    if (jobs) {
+        jobs->ParallelFor(static_cast<int>(pagePaths.size()), 1, decode);
+    } else {
+        decode(0, static_cast<int>(pagePaths.size()));
+    }
+
+    // Every surface has to be freed, even after a failure
+    bool failed = false;
+    for (size_t i = 0; i < surfaces.size(); ++i)
+    {
+        if (!surfaces[i]) {
+            SDL_Log("Failed to load atlas page %s: %s", pagePaths[i].c_str(), IMG_GetError());
+            failed = true;
+            continue;
+        }
+
+        if (!failed)
+        {
+            SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surfaces[i]);
+            if (texture) {
+                SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+                mPages.emplace_back(texture);
+                mResidentBytes += static_cast<size_t>(surfaces[i]->w) * surfaces[i]->h * 4;
+            } else {
+                SDL_Log("Failed to create atlas texture: %s", SDL_GetError());
+                failed = true;
+            }
+        }
+
+        SDL_FreeSurface(surfaces[i]);
+    }
+
+    if (failed) {
+        Unload();
+        return false;
+    }
+
+    auto toRegion = [this](const nlohmann::json& entry) {
+        const auto& rect = entry["rect"];
+        return AtlasRegion{mPages[entry["page"].get<int>()],
+                           {rect["x"].get<int>(), rect["y"].get<int>(), rect["w"].get<int>(), rect["h"].get<int>()}};
+    };
+
+    if (index.contains("sprites")) {
+        for (const auto& sprite : index["sprites"].items()) {
+            mSprites.emplace(sprite.key(), toRegion(sprite.value()));
+        }
+    }
+
+    if (index.contains("sheets")) {
+        for (const auto& sheet : index["sheets"].items()) {
+            std::vector<AtlasRegion> frames;
+            for (const auto& frame : sheet.value()["frames"]) {
+                frames.emplace_back(toRegion(frame));
+            }
+            mSheets.emplace(sheet.key(), std::move(frames));
+        }
+    }
+
+    SDL_Log("Loaded sprite atlas with %d page(s), %d sprites and %d sheets",
+            static_cast<int>(mPages.size()), static_cast<int>(mSprites.size()), static_cast<int>(mSheets.size()));
+
+    return true;
+}
+
+void TextureAtlas::Unload()
+{
+    for (auto page : mPages) {
+        SDL_DestroyTexture(page);
+    }
+    mPages.clear();
+    mResidentBytes = 0;
+    mSprites.clear();
+    mSheets.clear();
+
+    std::lock_guard<std::mutex> lock(mSpritesByIdMutex);
+    mSpritesById.clear();
+}
+
+bool TextureAtlas::FindSprite(const std::string& path, AtlasRegion& region) const
+{
+    if (mSprites.empty()) {
+        return false;
+    }
+
+    auto iter = mSprites.find(MakeKey(path));
+    if (iter == mSprites.end()) {
+        return false;
+    }
+
+    region = iter->second;
+    return true;
+}
+
+bool TextureAtlas::FindSprite(StringId path, AtlasRegion& region) const
+{
+    if (mSprites.empty() || path.IsEmpty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mSpritesByIdMutex);
+    auto iter = mSpritesById.find(path);
+    if (iter == mSpritesById.end())
+    {
+        auto sprite = mSprites.find(MakeKey(path.GetString()));
+        iter = mSpritesById.emplace(path, sprite != mSprites.end() ? &sprite->second : nullptr).first;
+    }
+
+    if (!iter->second) {
+        return false;
+    }
+
+    region = *iter->second;
+    return true;
+}
+
+const std::vector<AtlasRegion>* TextureAtlas::FindSheet(const std::string& path) const
+{
+    if (mSheets.empty()) {
+        return nullptr;
+    }
+
+    auto iter = mSheets.find(MakeKey(path));
+    return iter != mSheets.end() ? &iter->second : nullptr;
+}
+
+bool TextureAtlas::Contains(const std::string& path) const
+{
+    if (mPages.empty()) {
+        return false;
+    }
+
+    std::string key = MakeKey(path);
+    return mSprites.find(key) != mSprites.end() || mSheets.find(key) != mSheets.end();
+}
+
+std::string TextureAtlas::MakeKey(const std::string& path)
+{
+    const std::string spritesDir = "Sprites/";
+
+    std::string key = path;
+    size_t pos = key.find(spritesDir);
+    if (pos != std::string::npos) {
+        key = key.substr(pos + spritesDir.size());
+    }
+
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
+    return key;
+}
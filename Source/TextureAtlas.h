@@ -0,0 +1,68 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SDL.h>
+#include "StringId.h"
+
+// A region of an atlas page
+struct AtlasRegion
+{
+    SDL_Texture* texture;
+    SDL_Rect rect;
+};
+
+// Sprite atlases generated offline by the atlas-packer tool. Sprite paths are
+// resolved to a page texture and a sub-rect, so sprites sharing a page can be
+// drawn without switching textures.
+class TextureAtlas
+{
+public:
+    TextureAtlas();
+    ~TextureAtlas();
+
+    // Load the pages listed in the index file. Returns false (and leaves the
+    // atlas empty) if the index is missing, so callers fall back to loose files.
+    // Pages are decoded on the job system workers when one is given, the
+    // textures are still created on the calling (main) thread.
+    bool Load(SDL_Renderer* renderer, const std::string& indexPath, class JobSystem* jobs = nullptr);
+    void Unload();
+
+    bool IsLoaded() const { return !mPages.empty(); }
+    size_t GetNumPages() const { return mPages.size(); }
+
+    // Memory taken by the pages (4 bytes per texel)
+    size_t GetResidentBytes() const { return mResidentBytes; }
+
+    // Look up a whole sprite (e.g. "../Assets/Sprites/Blocks/BlockC.png")
+    bool FindSprite(const std::string& path, AtlasRegion& region) const;
+    // Same by id. The first lookup of an id goes through its interned string,
+    // the result is remembered so later ones are a single hash lookup.
+    bool FindSprite(StringId path, AtlasRegion& region) const;
+
+    // Look up the frames of a sprite sheet packed frame by frame
+    const std::vector<AtlasRegion>* FindSheet(const std::string& path) const;
+
+    // Whether a sprite or sheet is packed, so its loose file is never loaded
+    bool Contains(const std::string& path) const;
+
+private:
+    // Convert a game path into the key used in the index (relative to the
+    // sprites dir and lowercase)
+    static std::string MakeKey(const std::string& path);
+
+    std::vector<SDL_Texture*> mPages;
+    size_t mResidentBytes;
+    std::unordered_map<std::string, AtlasRegion> mSprites;
+    std::unordered_map<std::string, std::vector<AtlasRegion>> mSheets;
+
+    // Sprites already looked up by id (null when the id isn't packed)
+    mutable std::unordered_map<StringId, const AtlasRegion*> mSpritesById;
+    mutable std::mutex mSpritesByIdMutex;
+};
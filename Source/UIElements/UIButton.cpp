@@ -3,6 +3,7 @@
 //
 
 #include "UIButton.h"
+#include "../RenderFrame.h"
 
 UIButton::UIButton(const std::string& text, class UIFont* font, std::function<void()> onClick,
                     const Vector2& pos, const Vector2& size, const Vector3& color,
@@ -22,7 +23,7 @@ UIButton::~UIButton()
 }
 
 
-void UIButton::Draw(SDL_Renderer *renderer, const Vector2 &screenPos)
+void UIButton::Draw(RenderFrame& frame, const Vector2 &screenPos)
 {
     SDL_Rect titleQuad = {static_cast<int>(screenPos.x + mPosition.x),
                           static_cast<int>(screenPos.y + mPosition.y),
@@ -32,12 +33,22 @@ void UIButton::Draw(SDL_Renderer *renderer, const Vector2 &screenPos)
     // Draw filled rect as button background
     if (mHighlighted)
     {
-        SDL_SetRenderDrawColor(renderer, 200, 100, 0, 255);
-        SDL_RenderFillRect(renderer, &titleQuad);
+        frame.FillRect(titleQuad, {200, 100, 0, 255});
     }
 
     // Draw text from the center of the button
-    mText.Draw(renderer, screenPos + mPosition + mSize * 0.5f - mText.GetSize() * 0.5f);
+    mText.Draw(frame, screenPos + mPosition + mSize * 0.5f - mText.GetSize() * 0.5f);
+}
+
+SDL_Rect UIButton::GetScreenRect(const Vector2 &screenPos) const
+{
+    // The text is centered on the button and may stick out of it
+    SDL_Rect buttonRect = UIElement::GetScreenRect(screenPos);
+    SDL_Rect textRect = mText.GetScreenRect(screenPos + mPosition + mSize * 0.5f - mText.GetSize() * 0.5f);
+
+    SDL_Rect rect;
+    SDL_UnionRect(&buttonRect, &textRect, &rect);
+    return rect;
 }
 
 void UIButton::OnClick()
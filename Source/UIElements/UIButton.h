@@ -25,9 +25,10 @@ public:
 
     // Set the name of the button
     void SetText(const std::string& text);
-    void Draw(SDL_Renderer* renderer, const Vector2 &screenPos) override;
+    void Draw(class RenderFrame& frame, const Vector2 &screenPos) override;
+    SDL_Rect GetScreenRect(const Vector2 &screenPos) const override;
 
-    void SetHighlighted(bool sel) { mHighlighted = sel; }
+    void SetHighlighted(bool sel) { mHighlighted = sel; MarkDirty(); }
     bool GetHighlighted() const { return mHighlighted; }
 
     // Returns true if the point is within the button's bounds
@@ -3,11 +3,34 @@
 //
 
 #include "UIElement.h"
+#include "../DirtyRegions.h"
 
 UIElement::UIElement(const Vector2 &pos, const Vector2 &size, const Vector3 &color)
         :mPosition(pos)
         ,mSize(size)
         ,mColor(color)
+        ,mIsDirty(true)
+        ,mLastScreenRect({0, 0, 0, 0})
 {
 
+}
+
+SDL_Rect UIElement::GetScreenRect(const Vector2 &screenPos) const
+{
+    return {static_cast<int>(screenPos.x + mPosition.x),
+            static_cast<int>(screenPos.y + mPosition.y),
+            static_cast<int>(mSize.x),
+            static_cast<int>(mSize.y)};
+}
+
+void UIElement::AddDirtyRects(const Vector2 &screenPos, DirtyRegions& regions)
+{
+    SDL_Rect rect = GetScreenRect(screenPos);
+    if (mIsDirty || !SDL_RectEquals(&rect, &mLastScreenRect))
+    {
+        regions.Add(mLastScreenRect);
+        regions.Add(rect);
+        mLastScreenRect = rect;
+        mIsDirty = false;
+    }
 }
\ No newline at end of file
@@ -19,12 +19,25 @@ public:
     void SetSize(const Vector2 &size) { mSize = size; }
 
     const Vector3& GetColor() const { return mColor; }
-    void SetColor(const Vector3 &color) { mColor = color; }
+    void SetColor(const Vector3 &color) { mColor = color; MarkDirty(); }
 
-    virtual void Draw(SDL_Renderer* renderer, const Vector2 &screenPos) {};
+    // Record the draw calls into the frame
+    virtual void Draw(class RenderFrame& frame, const Vector2 &screenPos) {};
+
+    // Screen area the element draws to
+    virtual SDL_Rect GetScreenRect(const Vector2 &screenPos) const;
+
+    // For the dirty-rectangle renderer: add the old and new areas of the
+    // element if it changed or moved since the last call
+    void AddDirtyRects(const Vector2 &screenPos, class DirtyRegions& regions);
 
 protected:
+    void MarkDirty() { mIsDirty = true; }
+
     Vector2 mPosition;
     Vector2 mSize;
     Vector3 mColor;
+
+    bool mIsDirty;
+    SDL_Rect mLastScreenRect;
 };
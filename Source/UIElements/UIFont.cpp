@@ -1,6 +1,7 @@
 #include "UIFont.h"
 #include <vector>
 #include <SDL_image.h>
+#include "../RenderFrame.h"
 
 UIFont::UIFont(SDL_Renderer* renderer)
     :mRenderer(renderer)
@@ -74,7 +75,7 @@ SDL_Texture* UIFont::RenderText(const std::string& text, const Vector3& color /*
 		}
 
         // Create texture from surface
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(mRenderer, surf);
+        SDL_Texture* texture = RenderResources::CreateTexture(surf);
         SDL_FreeSurface(surf);
         if (!texture)
         {
@@ -3,36 +3,15 @@
 //
 
 #include "UIImage.h"
+#include "../RenderFrame.h"
 
-UIImage::UIImage(const std::string &imagePath, const Vector2 &pos, const Vector2 &size, const Vector3 &color)
+UIImage::UIImage(SDL_Texture* texture, const Vector2 &pos, const Vector2 &size, const Vector3 &color)
     : UIElement(pos, size, color),
-    mTexture(nullptr)
+    mTexture(texture)
 {
-    // Load the image texture
-    SDL_Surface* surface = IMG_Load(imagePath.c_str());
-    if (surface == nullptr) {
-        SDL_Log("Failed to load image %s: %s", imagePath.c_str(), IMG_GetError());
-        return;
-    }
-
-    // Create texture from surface
-    mTexture = SDL_CreateTextureFromSurface(SDL_GetRenderer(SDL_GetWindowFromID(1)), surface);
-    if (mTexture == nullptr) {
-        SDL_Log("Failed to create texture from surface: %s", SDL_GetError());
-    }
-
-    SDL_FreeSurface(surface); // Free the surface after creating the texture
-}
-
-UIImage::~UIImage()
-{
-    if (mTexture) {
-        SDL_DestroyTexture(mTexture);
-        mTexture = nullptr;
-    }
 }
 
-void UIImage::Draw(SDL_Renderer* renderer, const Vector2 &screenPos)
+void UIImage::Draw(RenderFrame& frame, const Vector2 &screenPos)
 {
     if (mTexture == nullptr) {
         return;
@@ -43,5 +22,5 @@ void UIImage::Draw(SDL_Renderer* renderer, const Vector2 &screenPos)
                           static_cast<int>(mSize.x),
                           static_cast<int>(mSize.y)};
 
-    SDL_RenderCopy(renderer, mTexture, nullptr, &destRect);
+    frame.Copy(mTexture, nullptr, destRect);
 }
\ No newline at end of file
@@ -4,19 +4,17 @@
 
 #pragma once
 
-#include <string>
-#include <SDL_image.h>
+#include <SDL.h>
 #include "UIElement.h"
 
 class UIImage :  public UIElement
 {
 public:
-    UIImage(const std::string &imagePath, const Vector2 &pos = Vector2::Zero,
+    // The texture belongs to the game's asset manager
+    UIImage(SDL_Texture* texture, const Vector2 &pos = Vector2::Zero,
             const Vector2 &size = Vector2(100.f, 100.f), const Vector3 &color = Color::White);
 
-    ~UIImage();
-
-    void Draw(SDL_Renderer* renderer, const Vector2 &screenPos) override;
+    void Draw(class RenderFrame& frame, const Vector2 &screenPos) override;
 
 private:
     SDL_Texture* mTexture; // Texture for the image
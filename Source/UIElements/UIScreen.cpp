@@ -9,6 +9,7 @@
 #include "UIScreen.h"
 #include "../Game.h"
 #include "UIFont.h"
+#include "../DirtyRegions.h"
 
 UIScreen::UIScreen(Game* game, const std::string& fontName)
 	:mGame(game)
@@ -47,22 +48,37 @@ void UIScreen::Update(float deltaTime)
 	
 }
 
-void UIScreen::Draw(SDL_Renderer *renderer)
+void UIScreen::Draw(RenderFrame& frame)
 {
     for (auto t : mTexts) {
-        t->Draw(renderer, mPos);
+        t->Draw(frame, mPos);
     }
 
     for (auto img : mImages) {
-        img->Draw(renderer, mPos);
+        img->Draw(frame, mPos);
     }
 
     for (auto b : mButtons) {
-        b->Draw(renderer, mPos);
+        b->Draw(frame, mPos);
     }
 
 }
 
+void UIScreen::AddDirtyRects(DirtyRegions& regions)
+{
+    for (auto t : mTexts) {
+        t->AddDirtyRects(mPos, regions);
+    }
+
+    for (auto img : mImages) {
+        img->AddDirtyRects(mPos, regions);
+    }
+
+    for (auto b : mButtons) {
+        b->AddDirtyRects(mPos, regions);
+    }
+}
+
 void UIScreen::ProcessInput(const uint8_t* keys)
 {
 
@@ -132,7 +148,7 @@ UIButton* UIScreen::AddButton(const std::string& name, const Vector2 &pos, const
 
 UIImage* UIScreen::AddImage(const std::string &imagePath, const Vector2 &pos, const Vector2 &dims, const Vector3 &color)
 {
-    auto img = new UIImage(imagePath, pos, dims, color);
+    auto img = new UIImage(mGame->GetTexture(imagePath), pos, dims, color);
     mImages.emplace_back(img);
     return img;
 }
\ No newline at end of file
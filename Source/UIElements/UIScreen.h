@@ -33,7 +33,10 @@ public:
 
 	// UIScreen subclasses can override these
 	virtual void Update(float deltaTime);
-	virtual void Draw(class SDL_Renderer *renderer);
+	virtual void Draw(class RenderFrame& frame);
+
+	// Areas of the elements that changed since the last call
+	void AddDirtyRects(class DirtyRegions& regions);
 	virtual void ProcessInput(const uint8_t* keys);
 	virtual void HandleKeyPress(int key);
 
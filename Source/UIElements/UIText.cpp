@@ -4,6 +4,7 @@
 
 #include "UIText.h"
 #include "UIFont.h"
+#include "../RenderFrame.h"
 
 UIText::UIText(const std::string &text, class UIFont* font, int pointSize, const unsigned wrapLength,
                const Vector2 &pos, const Vector2 &size, const Vector3 &color)
@@ -18,28 +19,32 @@ UIText::UIText(const std::string &text, class UIFont* font, int pointSize, const
 
 UIText::~UIText()
 {
-
+    // Text textures aren't cached, each scene would leak its own otherwise
+    RenderResources::ReleaseTexture(mTextTexture);
+    mTextTexture = nullptr;
 }
 
 void UIText::SetText(const std::string &text)
 {
-    // Clear out previous title texture if it exists
+    // Clear out previous title texture if it exists (frames still being
+    // drawn may use it)
     if (mTextTexture)
     {
-        SDL_DestroyTexture(mTextTexture);
+        RenderResources::ReleaseTexture(mTextTexture);
         mTextTexture = nullptr;
     }
 
     // Create texture for title
     mTextTexture = mFont->RenderText(text, mColor, mPointSize, mWrapLength);
+    MarkDirty();
 }
 
-void UIText::Draw(SDL_Renderer *renderer, const Vector2 &screenPos)
+void UIText::Draw(RenderFrame& frame, const Vector2 &screenPos)
 {
     SDL_Rect titleQuad = {static_cast<int>(screenPos.x + mPosition.x),
                           static_cast<int>(screenPos.y + mPosition.y),
                           static_cast<int>(mSize.x),
                           static_cast<int>(mSize.y)};
 
-    SDL_RenderCopyEx(renderer, mTextTexture, nullptr, &titleQuad, .0f, nullptr, SDL_FLIP_NONE);
+    frame.Copy(mTextTexture, nullptr, titleQuad);
 }
\ No newline at end of file
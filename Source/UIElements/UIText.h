@@ -17,7 +17,7 @@ public:
     ~UIText();
 
     void SetText(const std::string& name);
-    void Draw(SDL_Renderer* renderer, const Vector2 &screenPos) override;
+    void Draw(class RenderFrame& frame, const Vector2 &screenPos) override;
 
 protected:
     std::string mText;
@@ -0,0 +1,222 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+// Unit tests of the job system: ParallelFor coverage, counters and
+// dependencies, work stealing under uneven load and main-thread jobs, with
+// workers and inline (no workers). Returns non-zero if a check fails (run
+// by ctest).
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include "../Source/JobSystem.h"
+
+static int sFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            sFailures++; \
+        } \
+    } while (0)
+
+// Every index is visited exactly once, in chunks no bigger than the grain
+// (one chunk for the whole range without workers)
+static void TestParallelFor(int numWorkers)
+{
+    JobSystem jobs(numWorkers);
+
+    const int counts[] = {0, 1, 7, 64, 1000, 4097};
+    const int grains[] = {1, 16, 1024};
+    for (int count : counts)
+    {
+        for (int grain : grains)
+        {
+            std::vector<std::atomic<int>> visits(count);
+            for (auto& visit : visits) {
+                visit = 0;
+            }
+            std::atomic<int> numChunks(0);
+            std::atomic<bool> isChunkTooBig(false);
+
+            const int maxChunk = numWorkers > 0 ? grain : count;
+            jobs.ParallelFor(count, grain, [&](int begin, int end) {
+                numChunks++;
+                if (end - begin > maxChunk || end <= begin) {
+                    isChunkTooBig = true;
+                }
+                for (int i = begin; i < end; ++i) {
+                    visits[i]++;
+                }
+            });
+
+            int numWrong = 0;
+            for (auto& visit : visits) {
+                numWrong += visit != 1;
+            }
+            CHECK(numWrong == 0);
+            CHECK(!isChunkTooBig);
+            CHECK(numChunks == (numWorkers > 0 ? (count + grain - 1) / grain : count > 0));
+        }
+    }
+}
+
+// Wait returns once every job counted ran, and a dependent job only starts
+// after the counter it depends on reached zero
+static void TestCountersAndDependencies(int numWorkers)
+{
+    JobSystem jobs(numWorkers);
+
+    JobCounter first;
+    std::atomic<int> numFirstDone(0);
+    for (int i = 0; i < 32; ++i)
+    {
+        jobs.Run([&numFirstDone]() {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            numFirstDone++;
+        }, &first);
+    }
+
+    JobCounter second;
+    std::atomic<int> numSeenBefore(-1);
+    jobs.Run([&]() { numSeenBefore = numFirstDone.load(); }, &second, &first);
+
+    // A chain: each step depends on the previous one
+    JobCounter steps[4];
+    std::vector<int> order;
+    std::mutex orderMutex;
+    for (int i = 0; i < 4; ++i)
+    {
+        jobs.Run([&, i]() {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(i);
+        }, &steps[i], i > 0 ? &steps[i - 1] : nullptr);
+    }
+
+    jobs.Wait(second);
+    CHECK(first.IsDone());
+    CHECK(numFirstDone == 32);
+    CHECK(numSeenBefore == 32);
+
+    jobs.Wait(steps[3]);
+    CHECK((order == std::vector<int>{0, 1, 2, 3}));
+
+    // Waiting on a counter nothing was scheduled on returns right away
+    JobCounter empty;
+    jobs.Wait(empty);
+    CHECK(empty.GetValue() == 0);
+}
+
+// One job fans out into many uneven jobs on its worker's own deque: the idle
+// workers have to steal them, and stealing must not lose or repeat any
+static void TestWorkStealing()
+{
+    const int numWorkers = 4;
+    JobSystem jobs(numWorkers);
+
+    const int numJobs = 64;
+    std::atomic<int> runs[numJobs];
+    for (auto& run : runs) {
+        run = 0;
+    }
+    std::mutex threadsMutex;
+    std::set<std::thread::id> threads;
+
+    JobCounter spawner;
+    JobCounter children;
+    jobs.Run([&]() {
+        for (int i = 0; i < numJobs; ++i)
+        {
+            jobs.Run([&, i]() {
+                // Every eighth job is much longer than the rest
+                std::this_thread::sleep_for(std::chrono::microseconds(i % 8 == 0 ? 5000 : 500));
+                runs[i]++;
+                std::lock_guard<std::mutex> lock(threadsMutex);
+                threads.insert(std::this_thread::get_id());
+            }, &children);
+        }
+    }, &spawner);
+
+    jobs.Wait(spawner);
+    jobs.Wait(children);
+
+    int numWrong = 0;
+    for (auto& run : runs) {
+        numWrong += run != 1;
+    }
+    CHECK(numWrong == 0);
+    CHECK(threads.size() > 1);
+}
+
+// Jobs queued for the main thread only run there: when it pumps them or
+// while it waits, never on a worker
+static void TestMainThreadJobs(int numWorkers)
+{
+    JobSystem jobs(numWorkers);
+    CHECK(jobs.IsMainThread());
+
+    const std::thread::id mainThread = std::this_thread::get_id();
+    std::atomic<int> numOnMain(0);
+    std::atomic<int> numElsewhere(0);
+    auto record = [&]() {
+        if (std::this_thread::get_id() == mainThread) {
+            numOnMain++;
+        } else {
+            numElsewhere++;
+        }
+    };
+
+    // Queued from the main thread, run right away
+    jobs.RunOnMainThread(record);
+    CHECK(numOnMain == 1);
+
+    // Queued from a worker, held until the main thread pumps them
+    int expected = 1;
+    if (numWorkers > 0)
+    {
+        JobCounter queued;
+        jobs.Run([&]() { jobs.RunOnMainThread(record); }, &queued);
+        while (!queued.IsDone()) {
+            std::this_thread::yield();
+        }
+        CHECK(numOnMain == 1);
+        jobs.PumpMainThreadJobs();
+        CHECK(numOnMain == 2);
+        expected = 2;
+    }
+
+    // Queued from jobs, run while the main thread waits for them
+    JobCounter counter;
+    for (int i = 0; i < 8; ++i) {
+        jobs.Run([&]() { jobs.RunOnMainThread(record, &counter); }, &counter);
+    }
+    jobs.Wait(counter);
+
+    CHECK(numOnMain == expected + 8);
+    CHECK(numElsewhere == 0);
+}
+
+int main()
+{
+    for (int numWorkers : {0, 1, 4})
+    {
+        TestParallelFor(numWorkers);
+        TestCountersAndDependencies(numWorkers);
+        TestMainThreadJobs(numWorkers);
+    }
+    TestWorkStealing();
+
+    if (sFailures > 0) {
+        std::printf("%d check(s) failed\n", sFailures);
+        return 1;
+    }
+
+    std::printf("JobSystem: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,147 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+// Round trips of SnapshotDelta: encoding a snapshot against a base and
+// decoding it back must give the snapshot again, whatever their sizes.
+// Returns non-zero if a check fails (run by ctest).
+//
+
+#include <cstdio>
+#include <vector>
+#include "../Source/Random.h"
+#include "../Source/Snapshot.h"
+
+static int sFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            sFailures++; \
+        } \
+    } while (0)
+
+static std::vector<uint8_t> RandomBytes(RandomStream& random, size_t size)
+{
+    std::vector<uint8_t> bytes(size);
+    for (auto& byte : bytes) {
+        byte = static_cast<uint8_t>(random.NextUInt());
+    }
+    return bytes;
+}
+
+// Encodes against the base, decodes and compares. Returns the delta size.
+static size_t RoundTrip(const std::vector<uint8_t>& base, const std::vector<uint8_t>& snapshot)
+{
+    std::vector<uint8_t> delta;
+    SnapshotDelta::Encode(base, snapshot, delta);
+
+    // Decoding into a buffer that holds something else must not matter
+    std::vector<uint8_t> decoded(7, 0xAB);
+    CHECK(SnapshotDelta::Decode(base, delta, decoded));
+    CHECK(decoded == snapshot);
+    return delta.size();
+}
+
+static void TestIdenticalBase()
+{
+    RandomStream random(1);
+    std::vector<uint8_t> snapshot = RandomBytes(random, 16 * 1024);
+
+    // Nothing changed: only the size and a single run of zeros
+    CHECK(RoundTrip(snapshot, snapshot) <= 8);
+}
+
+static void TestFewChanges()
+{
+    RandomStream random(2);
+    std::vector<uint8_t> base = RandomBytes(random, 16 * 1024);
+    std::vector<uint8_t> snapshot = base;
+    for (int i = 0; i < 20; ++i) {
+        snapshot[random.GetIntRange(0, static_cast<int>(snapshot.size()) - 1)] ^= 0x5A;
+    }
+
+    CHECK(RoundTrip(base, snapshot) < snapshot.size() / 20);
+}
+
+static void TestSizeChanges()
+{
+    RandomStream random(3);
+    std::vector<uint8_t> base = RandomBytes(random, 4096);
+
+    // Grown: the bytes past the base are encoded against zeros
+    std::vector<uint8_t> grown = base;
+    std::vector<uint8_t> tail = RandomBytes(random, 1000);
+    grown.insert(grown.end(), tail.begin(), tail.end());
+    RoundTrip(base, grown);
+
+    // Shrunk, and a base shorter or longer than anything
+    std::vector<uint8_t> shrunk(base.begin(), base.begin() + 1234);
+    RoundTrip(base, shrunk);
+    RoundTrip(std::vector<uint8_t>(), base);
+    RoundTrip(base, std::vector<uint8_t>());
+    RoundTrip(std::vector<uint8_t>(), std::vector<uint8_t>());
+}
+
+static void TestRandomEdits()
+{
+    RandomStream random(4);
+    for (int run = 0; run < 200; ++run)
+    {
+        std::vector<uint8_t> base = RandomBytes(random, random.GetIntRange(0, 600));
+        std::vector<uint8_t> snapshot = base;
+        snapshot.resize(random.GetIntRange(0, 600), 0);
+
+        // Runs of changes and of unchanged bytes of every length
+        const int numEdits = random.GetIntRange(0, 12);
+        for (int i = 0; i < numEdits && !snapshot.empty(); ++i)
+        {
+            const int start = random.GetIntRange(0, static_cast<int>(snapshot.size()) - 1);
+            const int length = random.GetIntRange(1, 9);
+            for (int j = start; j < start + length && j < static_cast<int>(snapshot.size()); ++j) {
+                snapshot[j] = static_cast<uint8_t>(random.NextUInt());
+            }
+        }
+
+        RoundTrip(base, snapshot);
+    }
+}
+
+static void TestCorruptDelta()
+{
+    RandomStream random(5);
+    std::vector<uint8_t> base = RandomBytes(random, 512);
+    std::vector<uint8_t> snapshot = base;
+    snapshot[100] ^= 1;
+    snapshot[300] ^= 1;
+
+    std::vector<uint8_t> delta;
+    SnapshotDelta::Encode(base, snapshot, delta);
+
+    std::vector<uint8_t> decoded;
+    std::vector<uint8_t> truncated(delta.begin(), delta.end() - 1);
+    CHECK(!SnapshotDelta::Decode(base, truncated, decoded));
+
+    std::vector<uint8_t> extended = delta;
+    extended.push_back(0);
+    CHECK(!SnapshotDelta::Decode(base, extended, decoded));
+
+    CHECK(!SnapshotDelta::Decode(base, std::vector<uint8_t>(), decoded));
+}
+
+int main()
+{
+    TestIdenticalBase();
+    TestFewChanges();
+    TestSizeChanges();
+    TestRandomEdits();
+    TestCorruptDelta();
+
+    if (sFailures > 0) {
+        std::printf("%d check(s) failed\n", sFailures);
+        return 1;
+    }
+
+    std::printf("SnapshotDelta: all checks passed\n");
+    return 0;
+}
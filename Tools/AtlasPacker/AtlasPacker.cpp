@@ -0,0 +1,277 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+// Offline texture atlas packer. Packs every PNG under a sprites directory
+// into one or a few atlas pages and writes a JSON index that the game uses
+// to resolve sprite paths to (atlas page, sub-rect) at load time.
+//
+// Usage:
+//   atlas-packer <sprites-dir> <output-dir> [--page-size N] [--padding N]
+//                [--include <subdir or file>]... [--sheet <dir>/<data.json>]...
+//
+// When --include is given, only PNGs under the listed paths are packed
+// (backgrounds and menu art are better left as standalone textures).
+//
+// PNGs in the directory of a --sheet data file are treated as sprite sheets:
+// only the frames listed in the data file are packed, and the index stores
+// them in the same order so frame indices used by the animations still work.
+//
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "../../Source/Json.h"
+
+namespace fs = std::filesystem;
+
+struct PackItem
+{
+    std::string key;        // Path relative to the sprites dir, lowercase
+    SDL_Surface* surface;   // Source image (shared by all frames of a sheet)
+    SDL_Rect src;           // Region of the source image to pack
+    int frameIndex;         // -1 for whole sprites, frame number for sheets
+    int page = -1;
+    SDL_Rect dst = {0, 0, 0, 0};
+};
+
+static std::string NormalizeKey(const fs::path& path)
+{
+    std::string key = path.generic_string();
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
+    return key;
+}
+
+static std::vector<SDL_Rect> ReadSheetFrames(const fs::path& dataPath)
+{
+    std::vector<SDL_Rect> frames;
+
+    std::ifstream file(dataPath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open sheet data " << dataPath << std::endl;
+        return frames;
+    }
+
+    nlohmann::json data = nlohmann::json::parse(file);
+    for (const auto& frame : data["frames"]) {
+        frames.push_back({frame["frame"]["x"].get<int>(), frame["frame"]["y"].get<int>(),
+                          frame["frame"]["w"].get<int>(), frame["frame"]["h"].get<int>()});
+    }
+
+    return frames;
+}
+
+// Shelf packing: items sorted by height are placed left to right on shelves,
+// opening a new shelf (or a new page) when the current one is full.
+static int PackShelves(std::vector<PackItem*>& items, int pageSize, int padding)
+{
+    std::sort(items.begin(), items.end(), [](const PackItem* a, const PackItem* b) {
+        if (a->src.h != b->src.h) return a->src.h > b->src.h;
+        return a->key < b->key;
+    });
+
+    int page = 0;
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+
+    for (auto item : items)
+    {
+        int w = item->src.w + padding;
+        int h = item->src.h + padding;
+
+        if (w > pageSize || h > pageSize) {
+            std::cerr << "Sprite " << item->key << " does not fit in a " << pageSize << " page" << std::endl;
+            return -1;
+        }
+
+        if (shelfX + w > pageSize) {
+            shelfX = 0;
+            shelfY += shelfHeight;
+            shelfHeight = 0;
+        }
+
+        if (shelfY + h > pageSize) {
+            page++;
+            shelfX = 0;
+            shelfY = 0;
+            shelfHeight = 0;
+        }
+
+        item->page = page;
+        item->dst = {shelfX, shelfY, item->src.w, item->src.h};
+
+        shelfX += w;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+
+    return page + 1;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        std::cerr << "Usage: atlas-packer <sprites-dir> <output-dir> [--page-size N] [--padding N]"
+                     " [--include <path>]... [--sheet <dir>/<data.json>]..." << std::endl;
+        return 1;
+    }
+
+    const fs::path spritesDir = argv[1];
+    const fs::path outputDir = argv[2];
+    int pageSize = 2048;
+    int padding = 2;
+    std::map<std::string, fs::path> sheetData; // Sheet directory -> frame data file
+    std::vector<std::string> includes;
+
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--page-size" && i + 1 < argc) {
+            pageSize = std::stoi(argv[++i]);
+        } else if (arg == "--padding" && i + 1 < argc) {
+            padding = std::stoi(argv[++i]);
+        } else if (arg == "--include" && i + 1 < argc) {
+            includes.push_back(NormalizeKey(fs::path(argv[++i])));
+        } else if (arg == "--sheet" && i + 1 < argc) {
+            fs::path data = spritesDir / argv[++i];
+            sheetData[NormalizeKey(fs::relative(data.parent_path(), spritesDir))] = data;
+        } else {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (IMG_Init(IMG_INIT_PNG) == 0) {
+        std::cerr << "Unable to initialize SDL_image: " << IMG_GetError() << std::endl;
+        return 1;
+    }
+
+    // Collect every PNG (sorted so the output is deterministic)
+    std::vector<fs::path> pngs;
+    for (const auto& entry : fs::recursive_directory_iterator(spritesDir))
+    {
+        if (!entry.is_regular_file() || NormalizeKey(entry.path().extension()) != ".png") {
+            continue;
+        }
+
+        const std::string key = NormalizeKey(fs::relative(entry.path(), spritesDir));
+        bool included = includes.empty() || std::any_of(includes.begin(), includes.end(), [&key](const std::string& prefix) {
+            return key.compare(0, prefix.size(), prefix) == 0;
+        });
+
+        if (included) {
+            pngs.push_back(entry.path());
+        }
+    }
+    std::sort(pngs.begin(), pngs.end());
+
+    std::vector<SDL_Surface*> surfaces;
+    std::vector<PackItem> items;
+    std::map<std::string, std::vector<SDL_Rect>> sheetFrames;
+
+    for (const auto& png : pngs)
+    {
+        SDL_Surface* surface = IMG_Load(png.string().c_str());
+        if (!surface) {
+            std::cerr << "Failed to load " << png << ": " << IMG_GetError() << std::endl;
+            continue;
+        }
+        surfaces.push_back(surface);
+
+        const std::string key = NormalizeKey(fs::relative(png, spritesDir));
+        const std::string dirKey = NormalizeKey(fs::relative(png.parent_path(), spritesDir));
+
+        auto sheet = sheetData.find(dirKey);
+        if (sheet != sheetData.end())
+        {
+            auto& frames = sheetFrames[sheet->second.string()];
+            if (frames.empty()) {
+                frames = ReadSheetFrames(sheet->second);
+            }
+
+            for (int f = 0; f < static_cast<int>(frames.size()); ++f) {
+                items.push_back({key, surface, frames[f], f});
+            }
+        }
+        else
+        {
+            items.push_back({key, surface, {0, 0, surface->w, surface->h}, -1});
+        }
+    }
+
+    std::vector<PackItem*> order;
+    for (auto& item : items) {
+        order.push_back(&item);
+    }
+
+    int numPages = PackShelves(order, pageSize, padding);
+    if (numPages < 0) {
+        return 1;
+    }
+
+    fs::create_directories(outputDir);
+
+    nlohmann::json index;
+    index["pageSize"] = pageSize;
+
+    for (int page = 0; page < numPages; ++page)
+    {
+        // Trim the page height to what was actually used
+        int usedHeight = 0;
+        for (const auto& item : items) {
+            if (item.page == page) {
+                usedHeight = std::max(usedHeight, item.dst.y + item.dst.h);
+            }
+        }
+
+        SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, pageSize, usedHeight, 32, SDL_PIXELFORMAT_RGBA32);
+        for (auto& item : items) {
+            if (item.page == page) {
+                SDL_SetSurfaceBlendMode(item.surface, SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(item.surface, &item.src, atlas, &item.dst);
+            }
+        }
+
+        std::string pageName = "sprites" + std::to_string(page) + ".png";
+        if (IMG_SavePNG(atlas, (outputDir / pageName).string().c_str()) != 0) {
+            std::cerr << "Failed to save " << pageName << ": " << IMG_GetError() << std::endl;
+            return 1;
+        }
+        SDL_FreeSurface(atlas);
+
+        index["pages"].push_back(pageName);
+    }
+
+    // Whole sprites map to a single rect, sheets to their list of frames
+    for (const auto& item : items)
+    {
+        nlohmann::json rect = {{"x", item.dst.x}, {"y", item.dst.y}, {"w", item.dst.w}, {"h", item.dst.h}};
+
+        if (item.frameIndex < 0) {
+            index["sprites"][item.key] = {{"page", item.page}, {"rect", rect}};
+        } else {
+            auto& frames = index["sheets"][item.key]["frames"];
+            while (frames.size() <= static_cast<size_t>(item.frameIndex)) {
+                frames.push_back(nullptr);
+            }
+            frames[item.frameIndex] = {{"page", item.page}, {"rect", rect}};
+        }
+    }
+
+    std::ofstream out(outputDir / "sprites.json");
+    out << index.dump(2);
+
+    for (auto surface : surfaces) {
+        SDL_FreeSurface(surface);
+    }
+    IMG_Quit();
+
+    std::cout << "Packed " << items.size() << " sprites into " << numPages << " atlas page(s)" << std::endl;
+    return 0;
+}
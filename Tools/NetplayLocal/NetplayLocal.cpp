@@ -0,0 +1,84 @@
+//
+// Created by gfjallais on 19/10/2026.
+//
+// Starts two game processes playing each other over UDP on 127.0.0.1, one
+// per mouse, to try rollback netplay on a single machine. Latency and loss
+// are simulated by each process on the packets it sends.
+//
+// Usage:
+//   netplay-local [--game ./tp-final] [--port N] [--latency MS] [--loss PERCENT]
+//                 [--bots SEED] [--ticks N]
+//
+// --bots drives both mice with scripted input and --ticks quits after that
+// many ticks, for unattended runs. Each process logs a summary of its
+// rollbacks, re-simulated ticks and desyncs when it quits. Run it from the
+// game's directory, the assets are found relative to it.
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "../../Source/CommandLine.h"
+
+int main(int argc, char** argv)
+{
+    std::string game = "./tp-final";
+    int port = 7000;
+    std::string shared;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << argv[i] << std::endl;
+            return 1;
+        }
+
+        if (strcmp(argv[i], "--game") == 0) {
+            game = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0) {
+            // Player 2 listens on the next port, so both have to fit in 16 bits
+            if (!CommandLine::ParseInt(argv[++i], 1, 65534, port)) {
+                std::cerr << "Invalid port " << argv[i] << " (expected 1 to 65534)" << std::endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--latency") == 0) {
+            shared += std::string(" --net-latency ") + argv[++i];
+        } else if (strcmp(argv[i], "--loss") == 0) {
+            shared += std::string(" --net-loss ") + argv[++i];
+        } else if (strcmp(argv[i], "--bots") == 0) {
+            // Each side derives its own stream from the seed and its player
+            shared += std::string(" --net-bot ") + argv[++i];
+        } else if (strcmp(argv[i], "--ticks") == 0) {
+            shared += std::string(" --net-ticks ") + argv[++i];
+        } else {
+            std::cerr << "Unknown argument " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::string commands[2];
+    for (int player = 0; player < 2; ++player)
+    {
+        commands[player] = "\"" + game + "\" --net-player " + std::to_string(player + 1) +
+                           " --net-port " + std::to_string(port + player) +
+                           " --net-peer 127.0.0.1:" + std::to_string(port + 1 - player) + shared;
+        std::cout << commands[player] << std::endl;
+    }
+
+    int results[2] = {0, 0};
+    std::thread players[2];
+    for (int player = 0; player < 2; ++player)
+    {
+        players[player] = std::thread([&commands, &results, player]() {
+            results[player] = std::system(commands[player].c_str());
+        });
+    }
+    for (auto& player : players) {
+        player.join();
+    }
+
+    std::cout << "Player 1 exited with " << results[0] << ", player 2 with " << results[1] << std::endl;
+    return results[0] != 0 || results[1] != 0;
+}